@@ -1,4 +1,6 @@
 #include <ftp_library/FTPClient.h>
+#include <ftp_library/FTPEventLoop.h>
+#include <ftp_library/FTPAsyncClient.h>
 
 #include <FL/Fl.H>
 #include <FL/Fl_Window.H>
@@ -8,7 +10,8 @@
 #include <FL/Fl_Text_Buffer.H>
 #include <FL/Enumerations.H>
 
-ftp_library::FTPClient FtpClient;
+ftp_library::FTPEventLoop EventLoop;
+ftp_library::FTPAsyncClient FtpClient(EventLoop);
 bool Connected = false;
 std::string RemoteDir = "/";
 
@@ -47,6 +50,45 @@ void Log(const std::string &Msg)
     OutputDisplay->show_insert_position();
 }
 
+/**
+ * Runs a function on the UI thread; the FTP callbacks fire on the event loop thread.
+ *
+ * @param Fn The function to run.
+ */
+void RunOnUiThread(std::function<void()> Fn)
+{
+    Fl::awake([](void *Data)
+              {
+                  std::unique_ptr<std::function<void()>> Task(static_cast<std::function<void()> *>(Data));
+                  (*Task)(); },
+              new std::function<void()>(std::move(Fn)));
+}
+
+/**
+ * Logs the outcome of an FTP operation from any thread.
+ *
+ * @param Error The failure, or null on success.
+ * @param Success The message to log on success.
+ * @param Failure The prefix to log on failure.
+ */
+void LogResult(std::exception_ptr Error, const std::string &Success, const std::string &Failure)
+{
+    std::string Msg = Success;
+    if (Error)
+    {
+        try
+        {
+            std::rethrow_exception(Error);
+        }
+        catch (const std::exception &E)
+        {
+            Msg = Failure + E.what();
+        }
+    }
+    RunOnUiThread([Msg]()
+                  { Log(Msg); });
+}
+
 /**
  * Attempts to connect to the FTP server using the host input.
  *
@@ -56,16 +98,14 @@ void Log(const std::string &Msg)
 void ConnectCallback(Fl_Widget *, void *)
 {
     std::string Host = HostInput->value();
-    try
-    {
-        FtpClient.Connect(Host, 21);
-        Connected = true;
-        Log("Connected to " + Host);
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("Connection failed: ") + E.what());
-    }
+    FtpClient.Connect(Host, 21, [Host](std::exception_ptr Error)
+                      {
+                          if (!Error)
+                          {
+                              RunOnUiThread([]()
+                                            { Connected = true; });
+                          }
+                          LogResult(Error, "Connected to " + Host, "Connection failed: "); });
 }
 
 /**
@@ -83,15 +123,8 @@ void AuthenticateCallback(Fl_Widget *, void *)
     }
     std::string User = UserInput->value();
     std::string Pass = PassInput->value();
-    try
-    {
-        FtpClient.Authenticate(User, Pass);
-        Log("Authenticated as " + User);
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("Authentication failed: ") + E.what());
-    }
+    FtpClient.Authenticate(User, Pass, [User](std::exception_ptr Error)
+                           { LogResult(Error, "Authenticated as " + User, "Authentication failed: "); });
 }
 
 /**
@@ -107,19 +140,14 @@ void ListCallback(Fl_Widget *, void *)
         Log("Not connected.");
         return;
     }
-    try
-    {
-        std::vector<std::string> Files = FtpClient.ListDirectory(RemoteDir);
-        Log("Directory listing:");
-        for (const auto &File : Files)
-        {
-            Log("  " + File);
-        }
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("List failed: ") + E.what());
-    }
+    FtpClient.ListDirectory(RemoteDir, [](std::exception_ptr Error, std::vector<std::string> Files)
+                            {
+                                std::string Listing = "Directory listing:";
+                                for (const auto &File : Files)
+                                {
+                                    Listing += "\n  " + File;
+                                }
+                                LogResult(Error, Listing, "List failed: "); });
 }
 
 /**
@@ -142,15 +170,14 @@ void DownloadCallback(Fl_Widget *, void *)
         size_t Pos = RemoteFile.find_last_of('/');
         LocalFile = RemoteFile.substr(Pos + 1);
     }
-    try
-    {
-        FtpClient.DownloadFile(RemoteFile, LocalFile);
-        Log("Downloaded " + RemoteFile + " to " + LocalFile);
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("Download failed: ") + E.what());
-    }
+    Log("Downloading " + RemoteFile + "...");
+    FtpClient.DownloadFile(RemoteFile, LocalFile,
+                           [RemoteFile, LocalFile](std::exception_ptr Error, ftp_library::TransferStats Stats)
+                           {
+                               LogResult(Error, "Downloaded " + RemoteFile + " to " + LocalFile + " (" +
+                                                    ftp_library::FTPTransfer::FormatRate(Stats.BytesPerSecond()) + ")",
+                                         "Download failed: ");
+                           });
 }
 
 /**
@@ -168,15 +195,14 @@ void UploadCallback(Fl_Widget *, void *)
     }
     std::string LocalFile = LocalFileInput->value();
     std::string RemoteFile = RemoteFileInput->value();
-    try
-    {
-        FtpClient.UploadFile(LocalFile, RemoteFile);
-        Log("Uploaded " + LocalFile + " to " + RemoteFile);
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("Upload failed: ") + E.what());
-    }
+    Log("Uploading " + LocalFile + "...");
+    FtpClient.UploadFile(LocalFile, RemoteFile,
+                         [RemoteFile, LocalFile](std::exception_ptr Error, ftp_library::TransferStats Stats)
+                         {
+                             LogResult(Error, "Uploaded " + LocalFile + " to " + RemoteFile + " (" +
+                                                  ftp_library::FTPTransfer::FormatRate(Stats.BytesPerSecond()) + ")",
+                                       "Upload failed: ");
+                         });
 }
 
 /**
@@ -209,16 +235,9 @@ void DisconnectCallback(Fl_Widget *, void *)
         Log("Not connected.");
         return;
     }
-    try
-    {
-        FtpClient.Disconnect();
-        Connected = false;
-        Log("Disconnected.");
-    }
-    catch (const std::exception &E)
-    {
-        Log(std::string("Disconnect failed: ") + E.what());
-    }
+    Connected = false;
+    FtpClient.Disconnect([](std::exception_ptr Error)
+                         { LogResult(Error, "Disconnected.", "Disconnect failed: "); });
 }
 
 /**
@@ -271,5 +290,26 @@ int main(int argc, char **argv)
     Window->resizable(*OutputDisplay);
     Window->end();
     Window->show(argc, argv);
-    return Fl::run();
+
+    //* Revisited directories show instantly; stale ones are refreshed in the background
+    FtpClient.SetListingCache(std::make_shared<ftp_library::FTPListingCache>(),
+                              [](const std::string &Dir, std::vector<std::string> Files)
+                              {
+                                  std::string Listing = "Directory listing of " + Dir + " changed:";
+                                  for (const auto &File : Files)
+                                  {
+                                      Listing += "\n  " + File;
+                                  }
+                                  RunOnUiThread([Listing]()
+                                                { Log(Listing); });
+                              });
+
+    //* Network I/O runs on its own thread so transfers never block the UI
+    Fl::lock();
+    std::thread NetworkThread([]()
+                              { EventLoop.Run(); });
+    int Result = Fl::run();
+    EventLoop.Stop();
+    NetworkThread.join();
+    return Result;
 }
\ No newline at end of file
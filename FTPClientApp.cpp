@@ -4,13 +4,18 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:52:51 
+ * Last Modified: Sat October 17th 2026 23:11:01 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
  */
 
 #include <ftp_library/FTPClient.h>
+#include <cstdlib>
+
+//! Names the file that keeps listings between runs, so browsing a slow server starts warm
+//! Unset by default: the cache records server paths and is not written unless asked for.
+static const char *const kListingCacheVariable = "FTPCLIENT_LISTING_CACHE";
 
 //! Check if the client is connected to the server
 //! @param connected True if connected, false otherwise
@@ -54,6 +59,14 @@ int main()
     try
     {
         ftp_library::FTPClient ftpClient;
+        auto listingCache = std::make_shared<ftp_library::FTPListingCache>();
+        const char *cacheSetting = std::getenv(kListingCacheVariable);
+        std::string listingCacheFile = cacheSetting ? cacheSetting : "";
+        if (!listingCacheFile.empty())
+        {
+            listingCache->Load(listingCacheFile);
+        }
+        ftpClient.SetListingCache(listingCache);
         std::string host;
         uint16_t port = 21;
         std::string username, password;
@@ -161,6 +174,10 @@ int main()
             case 8:
                 //* Quit
                 std::cout << "Exiting FTP client.\n";
+                if (!listingCacheFile.empty())
+                {
+                    listingCache->Save(listingCacheFile);
+                }
                 return 0;
 
             default:
@@ -0,0 +1,523 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\bench\FTPBench.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\bench
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:14:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/Framework.h>
+#include "FTPBenchServer.h"
+
+using namespace ftp_library;
+
+//
+// Allocation counting: every operator new on the calling thread is tallied, so
+// the loopback server threads do not show up in the client's figures.
+//
+static thread_local uint64_t t_allocations = 0;
+static thread_local uint64_t t_allocatedBytes = 0;
+
+void *operator new(std::size_t size)
+{
+    ++t_allocations;
+    t_allocatedBytes += size;
+    if (void *memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+//* Out of line so GCC does not pair the inlined free() with operator new (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+//! Command line settings
+struct BenchOptions
+{
+    uint64_t fileSize = 64ull * 1024 * 1024; //* Size of the synthetic download/upload file
+    double latencyMs = 0.0;                  //* Simulated control round trip in milliseconds
+    uint64_t bandwidth = 0;                  //* Data connection cap in bytes/s, 0 for none
+    size_t iterations = 5;                   //* Repetitions of every transfer benchmark
+    size_t commandSamples = 200;             //* Repetitions of every single-command benchmark
+    size_t listingEntries = 10000;           //* Entries in the served directory listing
+    int compressionLevel = 0;                //* MODE Z level for the client, 0 for stream mode
+    bool pipeline = false;                   //* Send transfer commands right behind EPSV
+    bool active = false;                     //* Active mode (PORT) data connections instead of passive
+    std::string filter;                      //* Only run benchmarks whose name contains this
+    std::string tracePath;                   //* Chrome trace output, empty for no tracing
+    bool json = false;                       //* Print JSON lines instead of a table
+};
+
+//! Measurements of one benchmark
+struct BenchResult
+{
+    std::string name;                //* Benchmark name
+    std::vector<double> seconds;     //* Duration of every iteration
+    std::vector<double> firstByte;   //* Time to first byte of every iteration, if reported
+    uint64_t bytesPerOp = 0;         //* Payload bytes moved per iteration
+    uint64_t allocations = 0;        //* Allocations over all iterations
+    uint64_t allocatedBytes = 0;     //* Bytes allocated over all iterations
+};
+
+//! Parse a size with an optional K, M or G suffix (powers of 1024)
+//@ param text The size text
+//@ return The size in bytes
+static uint64_t ParseSize(const std::string &text)
+{
+    char *end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    switch (std::toupper(static_cast<unsigned char>(*end)))
+    {
+    case 'K':
+        value *= 1024;
+        break;
+    case 'M':
+        value *= 1024.0 * 1024;
+        break;
+    case 'G':
+        value *= 1024.0 * 1024 * 1024;
+        break;
+    }
+    return static_cast<uint64_t>(value);
+}
+
+//! Print the command line help
+static void PrintUsage()
+{
+    std::cout << "Usage: ftpclient_bench [options]\n"
+                 "  --size <bytes>        Transfer file size, K/M/G suffixes allowed (default 64M)\n"
+                 "  --latency <ms>        Round trip added to every control command (default 0)\n"
+                 "  --bandwidth <bytes/s> Data connection cap, K/M/G suffixes allowed (default unlimited)\n"
+                 "  --iterations <n>      Repetitions of each transfer benchmark (default 5)\n"
+                 "  --commands <n>        Repetitions of each command benchmark (default 200)\n"
+                 "  --entries <n>         Entries in the served directory listing (default 10000)\n"
+                 "  --compress <level>    Use MODE Z at this zlib level (1-9) for data connections\n"
+                 "  --pipeline            Send each transfer command right behind EPSV\n"
+                 "  --active              Use active mode (PORT) data connections from a listener pool\n"
+                 "  --filter <text>       Only run benchmarks whose name contains text\n"
+                 "  --trace <path>        Record spans and write a Chrome trace JSON file\n"
+                 "  --json                Print one JSON object per benchmark\n";
+}
+
+//! Parse the command line
+//@ param argc Argument count
+//@ param argv Arguments
+//@ param options Receives the settings
+//@ return False if the program should exit
+static bool ParseOptions(int argc, char **argv, BenchOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--json")
+        {
+            options.json = true;
+        }
+        else if (argument == "--size" && hasValue)
+        {
+            options.fileSize = ParseSize(argv[++i]);
+        }
+        else if (argument == "--latency" && hasValue)
+        {
+            options.latencyMs = std::strtod(argv[++i], nullptr);
+        }
+        else if (argument == "--bandwidth" && hasValue)
+        {
+            options.bandwidth = ParseSize(argv[++i]);
+        }
+        else if (argument == "--iterations" && hasValue)
+        {
+            options.iterations = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--commands" && hasValue)
+        {
+            options.commandSamples = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--entries" && hasValue)
+        {
+            options.listingEntries = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (argument == "--pipeline")
+        {
+            options.pipeline = true;
+        }
+        else if (argument == "--active")
+        {
+            options.active = true;
+        }
+        else if (argument == "--compress" && hasValue)
+        {
+            options.compressionLevel = std::atoi(argv[++i]);
+        }
+        else if (argument == "--filter" && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else if (argument == "--trace" && hasValue)
+        {
+            options.tracePath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Get a percentile of a sample set
+//@ param samples The samples
+//@ param fraction The percentile as a fraction (0.5 for the median)
+//@ return The sample at that rank, or 0 for an empty set
+static double Percentile(std::vector<double> samples, double fraction)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[std::min(rank, samples.size() - 1)];
+}
+
+//! Run one benchmark body repeatedly, timing and counting allocations
+//@ param name The benchmark name
+//@ param iterations The number of runs
+//@ param bytesPerOp Payload bytes per run, for throughput
+//@ param body The measured operation
+//@ return The measurements
+static BenchResult Measure(const std::string &name, size_t iterations, uint64_t bytesPerOp,
+                           const std::function<void()> &body)
+{
+    BenchResult result;
+    result.name = name;
+    result.bytesPerOp = bytesPerOp;
+    result.seconds.reserve(iterations);
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        uint64_t allocations = t_allocations;
+        uint64_t allocatedBytes = t_allocatedBytes;
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.allocations += t_allocations - allocations;
+        result.allocatedBytes += t_allocatedBytes - allocatedBytes;
+        result.seconds.push_back(seconds);
+    }
+    return result;
+}
+
+//! Check that a downloaded file has the expected size and content
+//@ param path The local file
+//@ param size The expected size
+//@ return True if it matches the server's pattern
+static bool VerifyDownload(const std::string &path, uint64_t size)
+{
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) != size || error)
+    {
+        return false;
+    }
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+    std::vector<char> buffer(256 * 1024);
+    uint64_t offset = 0;
+    bool ok = true;
+    size_t count;
+    while (ok && (count = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+    {
+        for (size_t i = 0; i < count; ++i, ++offset)
+        {
+            if (static_cast<unsigned char>(buffer[i]) != FTPBenchServer::PatternByte(offset))
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+//! Write a local file with the server's content pattern
+//@ param path The local file
+//@ param size The file size
+static void WritePatternFile(const std::string &path, uint64_t size)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        throw FTPException("Failed to open local file for writing: " + path, -1);
+    }
+    std::vector<char> buffer(256 * 1024);
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        buffer[i] = static_cast<char>(FTPBenchServer::PatternByte(i));
+    }
+    for (uint64_t written = 0; written < size;)
+    {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - written));
+        fwrite(buffer.data(), 1, chunk, file);
+        written += chunk;
+    }
+    fclose(file);
+}
+
+//! Print one result as a table row
+//@ param result The measurements
+static void PrintRow(const BenchResult &result)
+{
+    size_t runs = result.seconds.size();
+    double median = Percentile(result.seconds, 0.5);
+    char throughput[32] = "-";
+    if (result.bytesPerOp > 0 && median > 0.0)
+    {
+        std::snprintf(throughput, sizeof(throughput), "%.1f MB/s", result.bytesPerOp / median / 1e6);
+    }
+    char firstByte[32] = "-";
+    if (!result.firstByte.empty())
+    {
+        std::snprintf(firstByte, sizeof(firstByte), "%.3f", Percentile(result.firstByte, 0.5) * 1e3);
+    }
+    std::printf("%-16s %6zu %11.3f %11.3f %11.3f %10s %14s %12.1f %14.0f\n", result.name.c_str(), runs,
+                median * 1e3, Percentile(result.seconds, 0.99) * 1e3,
+                *std::max_element(result.seconds.begin(), result.seconds.end()) * 1e3, firstByte, throughput,
+                static_cast<double>(result.allocations) / runs, static_cast<double>(result.allocatedBytes) / runs);
+}
+
+//! Print one result as a JSON object on one line
+//@ param result The measurements
+static void PrintJson(const BenchResult &result)
+{
+    size_t runs = result.seconds.size();
+    double median = Percentile(result.seconds, 0.5);
+    std::printf("{\"name\":\"%s\",\"iterations\":%zu,\"p50_ms\":%.6f,\"p99_ms\":%.6f,\"max_ms\":%.6f,"
+                "\"first_byte_p50_ms\":%.6f,\"bytes_per_op\":%llu,\"bytes_per_second\":%.0f,"
+                "\"allocations_per_op\":%.2f,\"allocated_bytes_per_op\":%.0f}\n",
+                result.name.c_str(), runs, median * 1e3, Percentile(result.seconds, 0.99) * 1e3,
+                *std::max_element(result.seconds.begin(), result.seconds.end()) * 1e3,
+                Percentile(result.firstByte, 0.5) * 1e3, static_cast<unsigned long long>(result.bytesPerOp),
+                median > 0.0 ? result.bytesPerOp / median : 0.0, static_cast<double>(result.allocations) / runs,
+                static_cast<double>(result.allocatedBytes) / runs);
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        return 2;
+    }
+
+    FTPBenchServerOptions serverOptions;
+    serverOptions.replyLatency = std::chrono::microseconds(static_cast<int64_t>(options.latencyMs * 1000));
+    serverOptions.bandwidth = options.bandwidth;
+    serverOptions.listingEntries = options.listingEntries;
+
+    FTPBenchServer server(serverOptions);
+    server.AddFile("bench.bin", options.fileSize);
+
+    std::filesystem::path workDir = std::filesystem::temp_directory_path() / "ftpclient_bench";
+    std::filesystem::create_directories(workDir);
+    std::string downloadPath = (workDir / "bench.bin").string();
+    std::string uploadPath = (workDir / "upload.bin").string();
+
+    std::vector<BenchResult> results;
+    bool ok = true;
+    try
+    {
+        server.Start();
+        WritePatternFile(uploadPath, options.fileSize);
+
+        //* Time to first byte comes from the client's own metrics
+        double lastFirstByte = -1.0;
+        auto sink = std::make_shared<FTPCallbackMetricsSink>([&lastFirstByte](const OperationMetrics &metrics)
+                                                             { lastFirstByte = metrics.firstByteSeconds; });
+
+        std::shared_ptr<FTPTracer> tracer;
+        if (!options.tracePath.empty())
+        {
+            tracer = std::make_shared<FTPTracer>();
+        }
+
+        FTPClient client;
+        client.SetVerbose(false);
+        client.SetMetricsSink(sink);
+        client.SetTracer(tracer);
+        client.SetCompressionLevel(options.compressionLevel);
+        client.SetTransferPipelining(options.pipeline);
+        client.SetActiveMode(options.active ? std::make_shared<FTPListenerPool>() : nullptr);
+        auto selected = [&options](const std::string &name)
+        {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        };
+        auto collectFirstByte = [&lastFirstByte](std::vector<double> &samples)
+        {
+            if (lastFirstByte >= 0.0)
+            {
+                samples.push_back(lastFirstByte);
+            }
+        };
+
+        if (selected("connect"))
+        {
+            std::vector<double> firstByte;
+            results.push_back(Measure("connect", options.iterations, 0, [&]
+                                      {
+                                          FTPClient session;
+                                          session.SetVerbose(false);
+                                          session.SetMetricsSink(sink);
+                                          session.SetTracer(tracer);
+                                          session.Connect("127.0.0.1", server.Port());
+                                          collectFirstByte(firstByte);
+                                          session.Authenticate("bench", "bench");
+                                          session.Disconnect(); }));
+            results.back().firstByte = std::move(firstByte);
+        }
+
+        client.Connect("127.0.0.1", server.Port());
+        client.Authenticate("bench", "bench");
+
+        if (selected("cmd.noop"))
+        {
+            results.push_back(Measure("cmd.noop", options.commandSamples, 0, [&]
+                                      { client.Noop(); }));
+        }
+        if (selected("cmd.size"))
+        {
+            results.push_back(Measure("cmd.size", options.commandSamples, 0, [&]
+                                      { client.GetFileSize("bench.bin"); }));
+        }
+        if (selected("cmd.mdtm"))
+        {
+            results.push_back(Measure("cmd.mdtm", options.commandSamples, 0, [&]
+                                      { client.GetModificationTime("bench.bin"); }));
+        }
+
+        if (selected("list"))
+        {
+            std::vector<double> firstByte;
+            uint64_t listingBytes = 0;
+            results.push_back(Measure("list", options.iterations, 0, [&]
+                                      {
+                                          listingBytes = 0;
+                                          for (const auto &line : client.ListDirectory("/"))
+                                          {
+                                              listingBytes += line.size() + 1;
+                                          }
+                                          collectFirstByte(firstByte); }));
+            results.back().bytesPerOp = listingBytes;
+            results.back().firstByte = std::move(firstByte);
+        }
+        if (selected("list.mlsd"))
+        {
+            std::vector<double> firstByte;
+            size_t entries = 0;
+            results.push_back(Measure("list.mlsd", options.iterations, 0, [&]
+                                      {
+                                          FTPListingParser parser(FTPListingParser::Format::MLSD);
+                                          client.ListDirectory("/", parser);
+                                          entries = parser.Entries().size();
+                                          collectFirstByte(firstByte); }));
+            results.back().firstByte = std::move(firstByte);
+            if (entries != options.listingEntries + 1)
+            {
+                std::cerr << "list.mlsd: expected " << options.listingEntries + 1 << " entries, got " << entries
+                          << std::endl;
+                ok = false;
+            }
+        }
+
+        if (selected("download"))
+        {
+            std::vector<double> firstByte;
+            results.push_back(Measure("download", options.iterations, options.fileSize, [&]
+                                      {
+                                          client.DownloadFile("bench.bin", downloadPath);
+                                          collectFirstByte(firstByte); }));
+            results.back().firstByte = std::move(firstByte);
+            if (!VerifyDownload(downloadPath, options.fileSize))
+            {
+                std::cerr << "download: local file does not match the served content" << std::endl;
+                ok = false;
+            }
+        }
+        if (selected("upload"))
+        {
+            std::vector<double> firstByte;
+            results.push_back(Measure("upload", options.iterations, options.fileSize, [&]
+                                      {
+                                          client.UploadFile(uploadPath, "upload.bin");
+                                          collectFirstByte(firstByte); }));
+            results.back().firstByte = std::move(firstByte);
+            if (client.GetFileSize("upload.bin") != options.fileSize)
+            {
+                std::cerr << "upload: server received a different size" << std::endl;
+                ok = false;
+            }
+        }
+
+        client.Disconnect();
+        if (tracer)
+        {
+            tracer->WriteChromeTrace(options.tracePath);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        ok = false;
+    }
+    server.Stop();
+
+    std::error_code error;
+    std::filesystem::remove_all(workDir, error);
+
+    if (options.json)
+    {
+        for (const auto &result : results)
+        {
+            PrintJson(result);
+        }
+    }
+    else
+    {
+        std::printf("file size %llu bytes, latency %.3f ms, bandwidth %s, listing %zu entries, MODE %s%s\n\n",
+                    static_cast<unsigned long long>(options.fileSize), options.latencyMs,
+                    options.bandwidth ? (std::to_string(options.bandwidth) + " B/s").c_str() : "unlimited",
+                    options.listingEntries,
+                    options.compressionLevel > 0 ? ("Z level " + std::to_string(options.compressionLevel)).c_str()
+                                                 : "S",
+                    options.active ? ", active" : options.pipeline ? ", pipelined" : "");
+        std::printf("%-16s %6s %11s %11s %11s %10s %14s %12s %14s\n", "benchmark", "runs", "p50 ms", "p99 ms",
+                    "max ms", "ttfb ms", "throughput", "allocs/op", "alloc B/op");
+        for (const auto &result : results)
+        {
+            PrintRow(result);
+        }
+    }
+    return ok ? 0 : 1;
+}
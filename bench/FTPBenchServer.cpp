@@ -0,0 +1,735 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\bench\FTPBenchServer.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\bench
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:52:06 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include "FTPBenchServer.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <netinet/tcp.h>
+#endif
+
+namespace ftp_library
+{
+
+    //! Length of the repeating file content buffer (a multiple of the 2048 byte pattern period)
+    static constexpr size_t kPatternSize = 256 * 1024;
+
+    //! Flags for send(): avoid SIGPIPE when the client drops a connection
+#if defined(MSG_NOSIGNAL)
+    static constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    static constexpr int kSendFlags = 0;
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+    static constexpr int kShutdownBoth = SD_BOTH;
+#else
+    static constexpr int kShutdownBoth = SHUT_RDWR;
+#endif
+
+    //! Send a whole buffer
+    //@ param socket The connected socket
+    //@ param data The bytes to send
+    //@ param size The number of bytes
+    //@ return False if the peer went away
+    static bool SendAll(int socket, const char *data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t sent = send(socket, data, static_cast<int>(size), kSendFlags);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    //! Open a listening TCP socket on 127.0.0.1
+    //@ param port The port to bind, 0 for any free port; receives the bound port
+    //@ return The listening socket, or -1 on failure
+    static int ListenLoopback(uint16_t &port)
+    {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0)
+        {
+            return -1;
+        }
+
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+            listen(listener, 64) < 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+        {
+            closesocket(listener);
+            return -1;
+        }
+        port = ntohs(address.sin_port);
+        return listener;
+    }
+
+    //! Constructor
+    //@ param options The latency, bandwidth and listing settings
+    FTPBenchServer::FTPBenchServer(FTPBenchServerOptions options)
+        : m_options(options), m_pattern(kPatternSize)
+    {
+        for (size_t i = 0; i < m_pattern.size(); ++i)
+        {
+            m_pattern[i] = static_cast<char>(PatternByte(i));
+        }
+    }
+
+    //! Destructor
+    FTPBenchServer::~FTPBenchServer()
+    {
+        Stop();
+    }
+
+    //! Serve a synthetic file
+    //@ param name The file name
+    //@ param size The file size in bytes
+    void FTPBenchServer::AddFile(const std::string &name, uint64_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        m_files[name] = size;
+    }
+
+    //! Start listening and accepting sessions
+    void FTPBenchServer::Start()
+    {
+        if (m_running)
+        {
+            return;
+        }
+
+#if defined(_WIN32) || defined(_WIN64)
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+        m_port = m_options.port;
+        m_listener = ListenLoopback(m_port);
+        if (m_listener < 0)
+        {
+            throw FTPException("Failed to open benchmark server on port " + std::to_string(m_options.port));
+        }
+
+        m_running = true;
+        m_acceptThread = std::thread(&FTPBenchServer::AcceptLoop, this);
+    }
+
+    //! Stop accepting, close every session and join the threads
+    void FTPBenchServer::Stop()
+    {
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+
+        //* Wake the blocking accept() with a throwaway connection
+        int wake = socket(AF_INET, SOCK_STREAM, 0);
+        if (wake >= 0)
+        {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(m_port);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            ::connect(wake, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            closesocket(wake);
+        }
+        m_acceptThread.join();
+        closesocket(m_listener);
+        m_listener = -1;
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_sessionsMutex);
+            for (int control : m_sessionSockets)
+            {
+                shutdown(control, kShutdownBoth);
+            }
+            threads.swap(m_sessionThreads);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+#if defined(_WIN32) || defined(_WIN64)
+        WSACleanup();
+#endif
+    }
+
+    //! Accept control connections until stopped
+    void FTPBenchServer::AcceptLoop()
+    {
+        while (true)
+        {
+            int control = accept(m_listener, nullptr, nullptr);
+            if (!m_running)
+            {
+                if (control >= 0)
+                {
+                    closesocket(control);
+                }
+                return;
+            }
+            if (control < 0)
+            {
+                continue;
+            }
+
+            //* Back-to-back replies (150 then 226) must not wait for delayed ACKs
+            int noDelay = 1;
+            setsockopt(control, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&noDelay), sizeof(noDelay));
+
+            std::lock_guard<std::mutex> lock(m_sessionsMutex);
+            m_sessionSockets.push_back(control);
+            m_sessionThreads.emplace_back(&FTPBenchServer::RunSession, this, control);
+        }
+    }
+
+    //! Serve one control connection
+    //@ param control The accepted control socket
+    void FTPBenchServer::RunSession(int control)
+    {
+        Session session;
+        session.control = control;
+        session.received = std::chrono::steady_clock::now();
+        Reply(session, "220 ftp-client-cpp benchmark server ready");
+
+        std::string line;
+        while (ReadLine(session, line))
+        {
+            ++m_commands;
+            size_t space = line.find(' ');
+            std::string verb = line.substr(0, space);
+            std::transform(verb.begin(), verb.end(), verb.begin(), [](unsigned char c)
+                           { return static_cast<char>(std::toupper(c)); });
+            std::string argument = space == std::string::npos ? "" : line.substr(space + 1);
+            std::string name = argument.substr(argument.find_last_of('/') + 1);
+
+            if (verb == "USER")
+            {
+                Reply(session, "331 Password required");
+            }
+            else if (verb == "PASS")
+            {
+                Reply(session, "230 Logged in");
+            }
+            else if (verb == "SYST")
+            {
+                Reply(session, "215 UNIX Type: L8");
+            }
+            else if (verb == "FEAT")
+            {
+                Reply(session, std::string("211-Features:\r\n EPSV\r\n MDTM\r\n MLSD\r\n") +
+                                   (FTPDeflater::Available() ? " MODE Z\r\n" : "") + " REST STREAM\r\n SIZE\r\n211 End");
+            }
+            else if (verb == "MODE")
+            {
+                std::string mode = FTPUtilities::ToLowerCase(argument);
+                if (mode == "s" || (mode == "z" && FTPDeflater::Available()))
+                {
+                    session.modeZ = mode == "z";
+                    Reply(session, "200 Mode set");
+                }
+                else
+                {
+                    Reply(session, "504 Mode not supported");
+                }
+            }
+            else if (verb == "OPTS" && FTPUtilities::StartsWith(FTPUtilities::ToLowerCase(argument), "mode z level "))
+            {
+                session.level = std::clamp(std::atoi(argument.c_str() + 13), 1, 9);
+                Reply(session, "200 Level set");
+            }
+            else if (verb == "TYPE" || verb == "NOOP" || verb == "OPTS")
+            {
+                Reply(session, "200 OK");
+            }
+            else if (verb == "PWD")
+            {
+                Reply(session, "257 \"/\" is the current directory");
+            }
+            else if (verb == "CWD" || verb == "DELE")
+            {
+                Reply(session, "250 OK");
+            }
+            else if (verb == "MKD")
+            {
+                Reply(session, "257 \"" + argument + "\" created");
+            }
+            else if (verb == "PASV" || verb == "EPSV")
+            {
+                uint16_t port = 0;
+                bool limited = m_options.passiveLimit > 0 && session.passiveCount >= m_options.passiveLimit;
+                ++session.passiveCount;
+                if (limited || !OpenPassive(session, port))
+                {
+                    Reply(session, "425 Cannot open data connection");
+                }
+                else if (verb == "EPSV")
+                {
+                    Reply(session, "229 Entering Extended Passive Mode (|||" + std::to_string(port) + "|)");
+                }
+                else
+                {
+                    Reply(session, "227 Entering Passive Mode (127,0,0,1," + std::to_string(port >> 8) + "," +
+                                       std::to_string(port & 0xFF) + ")");
+                }
+            }
+            else if (verb == "PORT" || verb == "EPRT")
+            {
+                Reply(session, SetActive(session, verb, argument) ? "200 " + verb + " command successful"
+                                                                  : "501 Syntax error in " + verb);
+            }
+            else if (verb == "REST" && !m_options.restSupported)
+            {
+                Reply(session, "502 Command not implemented");
+            }
+            else if (verb == "REST")
+            {
+                session.restOffset = std::strtoull(argument.c_str(), nullptr, 10);
+                Reply(session, "350 Restarting at " + std::to_string(session.restOffset));
+            }
+            else if (verb == "SIZE" || verb == "MDTM" || verb == "RETR")
+            {
+                std::optional<uint64_t> size;
+                {
+                    std::lock_guard<std::mutex> lock(m_filesMutex);
+                    auto it = m_files.find(name);
+                    if (it != m_files.end())
+                    {
+                        size = it->second;
+                    }
+                }
+                if (!size)
+                {
+                    session.restOffset = 0;
+                    Reply(session, "550 " + argument + ": No such file");
+                }
+                else if (verb == "SIZE")
+                {
+                    Reply(session, "213 " + std::to_string(*size));
+                }
+                else if (verb == "MDTM")
+                {
+                    Reply(session, "213 20260101000000");
+                }
+                else
+                {
+                    int data = AcceptData(session);
+                    if (data < 0)
+                    {
+                        Reply(session, "425 Use PASV or PORT first");
+                        continue;
+                    }
+                    Reply(session, std::to_string(m_options.transferMark) +
+                                       " Opening BINARY mode data connection for " + name);
+                    SendFile(session, data, *size);
+                    closesocket(data);
+                    Reply(session, "226 Transfer complete");
+                }
+            }
+            else if (verb == "STOR" || verb == "APPE")
+            {
+                int data = AcceptData(session);
+                if (data < 0)
+                {
+                    Reply(session, "425 Use PASV or PORT first");
+                    continue;
+                }
+                Reply(session, std::to_string(m_options.transferMark) + " Ok to send data");
+                uint64_t received = ReceiveFile(session, data);
+                closesocket(data);
+                {
+                    std::lock_guard<std::mutex> lock(m_filesMutex);
+                    uint64_t &size = m_files[name];
+                    size = verb == "APPE" ? size + received : received;
+                }
+                Reply(session, "226 Transfer complete");
+            }
+            else if (verb == "LIST" || verb == "NLST" || verb == "MLSD")
+            {
+                int data = AcceptData(session);
+                if (data < 0)
+                {
+                    Reply(session, "425 Use PASV or PORT first");
+                    continue;
+                }
+                Reply(session, std::to_string(m_options.transferMark) + " Here comes the directory listing");
+                SendListing(session, data, BuildListing(verb == "MLSD", verb == "NLST"));
+                closesocket(data);
+                Reply(session, "226 Directory send OK");
+            }
+            else if (verb == "QUIT")
+            {
+                Reply(session, "221 Goodbye");
+                break;
+            }
+            else
+            {
+                Reply(session, "502 Command not implemented");
+            }
+        }
+
+        if (session.passive >= 0)
+        {
+            closesocket(session.passive);
+        }
+
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+        m_sessionSockets.erase(std::remove(m_sessionSockets.begin(), m_sessionSockets.end(), control),
+                               m_sessionSockets.end());
+        closesocket(control);
+    }
+
+    //! Read one CRLF-terminated command
+    //@ param session The session
+    //@ param line Receives the command without the line ending
+    //@ return False when the connection closed
+    bool FTPBenchServer::ReadLine(Session &session, std::string &line)
+    {
+        char buffer[4096];
+        size_t end;
+        while ((end = session.pending.find('\n')) == std::string::npos)
+        {
+            ssize_t received = recv(session.control, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                return false;
+            }
+            session.pending.append(buffer, static_cast<size_t>(received));
+            session.received = std::chrono::steady_clock::now();
+        }
+
+        line.assign(session.pending, 0, end);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        session.pending.erase(0, end + 1);
+        return true;
+    }
+
+    //! Send a control reply once the configured latency has passed since the command arrived
+    //! Timing from the arrival models a round trip: commands sent back-to-back are
+    //! delayed once, not once each, and a final reply after a transfer is not delayed again.
+    //@ param session The session
+    //@ param reply The reply without the final line ending
+    void FTPBenchServer::Reply(Session &session, const std::string &reply)
+    {
+        if (m_options.replyLatency.count() > 0)
+        {
+            std::this_thread::sleep_until(session.received + m_options.replyLatency);
+        }
+        std::string line = reply + "\r\n";
+        SendAll(session.control, line.data(), line.size());
+    }
+
+    //! Open the listening data socket for PASV/EPSV
+    //@ param session The session
+    //@ param port Receives the data port
+    //@ return False if no socket could be opened
+    bool FTPBenchServer::OpenPassive(Session &session, uint16_t &port)
+    {
+        if (session.passive >= 0)
+        {
+            closesocket(session.passive);
+        }
+        port = 0;
+        session.activeLength = 0;
+        session.passive = ListenLoopback(port);
+        return session.passive >= 0;
+    }
+
+    //! Take the client's data address from PORT (h1,h2,h3,h4,p1,p2) or EPRT (|family|address|port|)
+    //@ param session The session
+    //@ param verb PORT or EPRT
+    //@ param argument The command argument
+    //@ return False if the argument cannot be parsed
+    bool FTPBenchServer::SetActive(Session &session, const std::string &verb, const std::string &argument)
+    {
+        std::string host;
+        unsigned port = 0;
+        if (verb == "PORT")
+        {
+            unsigned h[4], p[2];
+            if (std::sscanf(argument.c_str(), "%u,%u,%u,%u,%u,%u", &h[0], &h[1], &h[2], &h[3], &p[0], &p[1]) != 6)
+            {
+                return false;
+            }
+            host = std::to_string(h[0]) + "." + std::to_string(h[1]) + "." + std::to_string(h[2]) + "." +
+                   std::to_string(h[3]);
+            port = p[0] * 256 + p[1];
+        }
+        else
+        {
+            //* The first character is the delimiter: |2|::1|5000|
+            std::vector<std::string> fields;
+            size_t start = 1;
+            for (size_t end; argument.size() > 1 && (end = argument.find(argument[0], start)) != std::string::npos;)
+            {
+                fields.push_back(argument.substr(start, end - start));
+                start = end + 1;
+            }
+            if (fields.size() != 3)
+            {
+                return false;
+            }
+            host = fields[1];
+            port = static_cast<unsigned>(std::strtoul(fields[2].c_str(), nullptr, 10));
+        }
+
+        try
+        {
+            ResolvedAddress address = FTPResolver::SystemLookup(host, static_cast<uint16_t>(port)).front();
+            session.active = address.address;
+            session.activeLength = address.length;
+        }
+        catch (const FTPException &)
+        {
+            return false;
+        }
+        if (session.passive >= 0)
+        {
+            closesocket(session.passive);
+            session.passive = -1;
+        }
+        return true;
+    }
+
+    //! Open the data connection announced by the last PASV/EPSV or PORT/EPRT
+    //@ param session The session
+    //@ return The data socket, or -1 if none was announced
+    int FTPBenchServer::AcceptData(Session &session)
+    {
+        if (session.activeLength > 0)
+        {
+            int data = static_cast<int>(socket(session.active.ss_family, SOCK_STREAM, IPPROTO_TCP));
+            if (data >= 0 && connect(data, reinterpret_cast<sockaddr *>(&session.active), session.activeLength) < 0)
+            {
+                closesocket(data);
+                data = -1;
+            }
+            session.activeLength = 0;
+            return data;
+        }
+        if (session.passive < 0)
+        {
+            return -1;
+        }
+        int data = accept(session.passive, nullptr, nullptr);
+        closesocket(session.passive);
+        session.passive = -1;
+        return data;
+    }
+
+    //! Send a synthetic file from the REST offset
+    //@ param session The session
+    //@ param data The data socket
+    //@ param size The file size
+    void FTPBenchServer::SendFile(Session &session, int data, uint64_t size)
+    {
+        uint64_t offset = std::min(session.restOffset, size);
+        session.restOffset = 0;
+
+        //* Keep pacing smooth: about 100 sends per second at the bandwidth cap
+        size_t chunkLimit = kPatternSize;
+        if (m_options.bandwidth > 0)
+        {
+            chunkLimit = static_cast<size_t>(std::clamp<uint64_t>(m_options.bandwidth / 100, 1024, kPatternSize));
+        }
+
+        std::unique_ptr<FTPDeflater> deflater;
+        if (session.modeZ)
+        {
+            deflater = std::make_unique<FTPDeflater>(session.level);
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t sent = 0;
+        while (offset < size)
+        {
+            size_t position = static_cast<size_t>(offset % kPatternSize);
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>({size - offset, kPatternSize - position, chunkLimit}));
+            if (!SendPaced(data, m_pattern.data() + position, chunk, start, sent, deflater.get()))
+            {
+                return;
+            }
+            offset += chunk;
+        }
+        if (deflater)
+        {
+            SendPaced(data, nullptr, 0, start, sent, deflater.get());
+        }
+    }
+
+    //! Send a directory listing
+    //@ param session The session
+    //@ param data The data socket
+    //@ param listing The listing text
+    void FTPBenchServer::SendListing(Session &session, int data, const std::string &listing)
+    {
+        std::unique_ptr<FTPDeflater> deflater;
+        if (session.modeZ)
+        {
+            deflater = std::make_unique<FTPDeflater>(session.level);
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t sent = 0;
+        for (size_t offset = 0; offset < listing.size(); offset += kPatternSize)
+        {
+            size_t chunk = std::min(kPatternSize, listing.size() - offset);
+            if (!SendPaced(data, listing.data() + offset, chunk, start, sent, deflater.get()))
+            {
+                return;
+            }
+        }
+        if (deflater)
+        {
+            SendPaced(data, nullptr, 0, start, sent, deflater.get());
+        }
+    }
+
+    //! Send bytes (compressed in MODE Z) and pace them by what crosses the wire
+    //@ param data The data socket
+    //@ param bytes The bytes to send, or nullptr with size 0 to end a MODE Z stream
+    //@ param size The number of bytes
+    //@ param start When the data transfer began
+    //@ param sent Bytes sent on the wire so far, updated
+    //@ param deflater The MODE Z compressor, or nullptr in stream mode
+    //@ return False if the client went away
+    bool FTPBenchServer::SendPaced(int data, const char *bytes, size_t size, std::chrono::steady_clock::time_point start,
+                                   uint64_t &sent, FTPDeflater *deflater) const
+    {
+        bool ok = true;
+        const FTPDeflater::Output send = [&](const char *chunk, size_t length)
+        {
+            if (ok && SendAll(data, chunk, length))
+            {
+                sent += length;
+                Pace(start, sent);
+            }
+            else
+            {
+                ok = false;
+            }
+        };
+        if (!deflater)
+        {
+            send(bytes, size);
+        }
+        else if (bytes)
+        {
+            deflater->Write(bytes, size, send);
+        }
+        else
+        {
+            deflater->Finish(send);
+        }
+        return ok;
+    }
+
+    //! Receive and discard an upload
+    //@ param session The session
+    //@ param data The data socket
+    //@ return The number of file bytes received (after inflating in MODE Z)
+    uint64_t FTPBenchServer::ReceiveFile(Session &session, int data)
+    {
+        std::vector<char> buffer(kPatternSize);
+        std::unique_ptr<FTPInflater> inflater;
+        if (session.modeZ)
+        {
+            inflater = std::make_unique<FTPInflater>();
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t wire = 0;
+        uint64_t received = 0;
+        ssize_t count;
+        while ((count = recv(data, buffer.data(), static_cast<int>(buffer.size()), 0)) > 0)
+        {
+            wire += static_cast<uint64_t>(count);
+            if (inflater)
+            {
+                inflater->Write(buffer.data(), static_cast<size_t>(count), [&received](const char *, size_t size)
+                                { received += size; });
+            }
+            else
+            {
+                received += static_cast<uint64_t>(count);
+            }
+            Pace(start, wire);
+        }
+        return received;
+    }
+
+    //! Generate the directory listing served for every directory
+    //@ param machineListing True for MLSD facts, false for LIST lines
+    //@ param namesOnly True for NLST
+    //@ return The listing with CRLF line endings
+    std::string FTPBenchServer::BuildListing(bool machineListing, bool namesOnly)
+    {
+        std::vector<std::pair<std::string, uint64_t>> entries;
+        {
+            std::lock_guard<std::mutex> lock(m_filesMutex);
+            entries.assign(m_files.begin(), m_files.end());
+        }
+        std::sort(entries.begin(), entries.end());
+        for (size_t i = 0; i < m_options.listingEntries; ++i)
+        {
+            entries.emplace_back("entry_" + std::to_string(i) + ".dat", (i * 7919) % 1000000);
+        }
+
+        std::string listing;
+        listing.reserve(entries.size() * 72);
+        for (const auto &[name, size] : entries)
+        {
+            if (namesOnly)
+            {
+                listing += name;
+            }
+            else if (machineListing)
+            {
+                listing += "type=file;size=" + std::to_string(size) + ";modify=20260101000000;perm=r; " + name;
+            }
+            else
+            {
+                char sizeField[24];
+                std::snprintf(sizeField, sizeof(sizeField), "%12llu", static_cast<unsigned long long>(size));
+                listing += std::string("-rw-r--r--    1 ftp      ftp      ") + sizeField + " Jan 01 00:00 " + name;
+            }
+            listing += "\r\n";
+        }
+        return listing;
+    }
+
+    //! Sleep until the bytes moved so far fit the bandwidth cap
+    //@ param start When the data transfer began
+    //@ param bytes Bytes moved since start
+    void FTPBenchServer::Pace(std::chrono::steady_clock::time_point start, uint64_t bytes) const
+    {
+        if (m_options.bandwidth == 0)
+        {
+            return;
+        }
+        auto due = start + std::chrono::microseconds(bytes * 1000000 / m_options.bandwidth);
+        std::this_thread::sleep_until(due);
+    }
+
+}
@@ -0,0 +1,129 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\bench\FTPBenchServer.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\bench
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:52:06 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPBENCHSERVER_H
+#define FTPBENCHSERVER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Settings for the loopback benchmark server
+    struct FTPBenchServerOptions
+    {
+        uint16_t port = 0;                          //* Control port, 0 picks a free one
+        std::chrono::microseconds replyLatency{0};  //* Delay from a command's arrival to its replies (simulated RTT)
+        uint64_t bandwidth = 0;                     //* Cap per data connection in bytes/s, 0 for none
+        size_t listingEntries = 1000;               //* Synthetic entries in every directory listing
+        size_t passiveLimit = 0;                    //* PASV/EPSV answered per session before 425, 0 for no limit
+        bool restSupported = true;                  //* False answers REST with 502
+        int transferMark = 150;                     //* Preliminary reply of transfer commands, 125 or 150
+    };
+
+    //! Minimal in-process FTP server on 127.0.0.1 for offline benchmarks
+    //! Serves synthetic files of configured sizes with a deterministic byte
+    //! pattern, discards uploads (remembering their size for SIZE) and answers
+    //! every directory with the same generated listing. Supports the passive
+    //! mode command set the client uses, plus MODE Z when built with zlib;
+    //! each session runs on its own thread.
+    class FTPBenchServer
+    {
+    public:
+        //! Constructor
+        //! @param options The latency, bandwidth and listing settings
+        explicit FTPBenchServer(FTPBenchServerOptions options = {});
+        ~FTPBenchServer();
+
+        //! Prevent copy construction and assignment
+        FTPBenchServer(const FTPBenchServer &) = delete;
+        FTPBenchServer &operator=(const FTPBenchServer &) = delete;
+
+        //! Serve a synthetic file
+        //! @param name The file name (without directory)
+        //! @param size The file size in bytes
+        void AddFile(const std::string &name, uint64_t size);
+
+        //! Start listening and accepting sessions
+        //! Throws FTPException if the listening socket cannot be opened
+        void Start();
+
+        //! Stop accepting, close every session and join the threads
+        void Stop();
+
+        //! Get the control port (valid after Start)
+        uint16_t Port() const
+        {
+            return m_port;
+        }
+
+        //! Get the number of control commands received so far
+        uint64_t CommandCount() const
+        {
+            return m_commands.load();
+        }
+
+        //! Get the byte at a file offset of every synthetic file
+        //! @param offset The offset
+        //! @return The expected byte
+        static unsigned char PatternByte(uint64_t offset)
+        {
+            return static_cast<unsigned char>((offset * 131) >> 3);
+        }
+
+    private:
+        struct Session
+        {
+            int control = -1;                //* Control connection
+            int passive = -1;                //* Listening data socket after PASV/EPSV
+            size_t passiveCount = 0;         //* PASV/EPSV commands received so far
+            sockaddr_storage active{};       //* Client data address after PORT/EPRT
+            socklen_t activeLength = 0;      //* Valid bytes of active, 0 if none
+            uint64_t restOffset = 0;         //* Offset from the last REST
+            bool modeZ = false;              //* Data connections carry deflate streams
+            int level = 6;                   //* Compression level from OPTS MODE Z LEVEL
+            std::string pending;             //* Received but unprocessed control bytes
+            std::chrono::steady_clock::time_point received; //* When the command being answered arrived
+        };
+
+        void AcceptLoop();
+        void RunSession(int control);
+        bool ReadLine(Session &session, std::string &line);
+        void Reply(Session &session, const std::string &reply);
+        bool OpenPassive(Session &session, uint16_t &port);
+        bool SetActive(Session &session, const std::string &verb, const std::string &argument);
+        int AcceptData(Session &session);
+        void SendFile(Session &session, int data, uint64_t size);
+        void SendListing(Session &session, int data, const std::string &listing);
+        bool SendPaced(int data, const char *bytes, size_t size, std::chrono::steady_clock::time_point start,
+                       uint64_t &sent, FTPDeflater *deflater) const;
+        uint64_t ReceiveFile(Session &session, int data);
+        std::string BuildListing(bool machineListing, bool namesOnly);
+        void Pace(std::chrono::steady_clock::time_point start, uint64_t bytes) const;
+
+        FTPBenchServerOptions m_options;                    //* Server settings
+        std::unordered_map<std::string, uint64_t> m_files;  //* File sizes by name
+        std::mutex m_filesMutex;                            //* Guards m_files
+        std::vector<char> m_pattern;                        //* One period of the file content
+        int m_listener = -1;                                //* Control listening socket
+        uint16_t m_port = 0;                                //* Bound control port
+        std::atomic<bool> m_running{false};                 //* Accepting sessions
+        std::atomic<uint64_t> m_commands{0};                //* Commands received
+        std::thread m_acceptThread;                         //* Runs AcceptLoop
+        std::vector<std::thread> m_sessionThreads;          //* One per session
+        std::vector<int> m_sessionSockets;                  //* Open control sockets, closed by Stop
+        std::mutex m_sessionsMutex;                         //* Guards the session vectors
+    };
+
+}
+
+#endif
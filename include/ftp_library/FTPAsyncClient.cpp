@@ -0,0 +1,1019 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPAsyncClient.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:45:15 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPAsyncClient.h>
+
+namespace ftp_library
+{
+
+    //! Flags for send(): a peer reset must not raise SIGPIPE on the event loop thread
+#if defined(MSG_NOSIGNAL)
+    static constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    static constexpr int kSendFlags = 0;
+#endif
+
+    //! Keep sends on a socket from raising SIGPIPE where send() has no MSG_NOSIGNAL (BSD, macOS)
+    //@ param fd The socket
+    static void SuppressSigPipe(int fd)
+    {
+#if defined(SO_NOSIGPIPE)
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+        (void)fd;
+#endif
+    }
+
+    //! State shared by the callbacks of one LIST/RETR/STOR operation
+    struct FTPAsyncClient::DataTransfer
+    {
+        enum Kind
+        {
+            List,
+            Download,
+            Upload
+        };
+
+        Kind kind;                                          //* What the data connection carries
+        uint64_t operation = 0;                             //* Owning operation
+        int socket = -1;                                    //* Data socket
+        FILE *file = nullptr;                               //* Local file for downloads and uploads
+        std::string listing;                                //* Received listing bytes
+        std::vector<char> buffer;                           //* Staging buffer
+        size_t bufferOffset = 0;                            //* Upload: next byte to send
+        size_t bufferLength = 0;                            //* Upload: bytes staged
+        bool dataDone = false;                              //* Data connection finished
+        bool controlDone = false;                           //* Final reply received
+        TransferStats stats;                                //* Transfer statistics
+        std::chrono::steady_clock::time_point start;        //* When the data connection opened
+        std::function<void(std::exception_ptr, DataTransfer &)> complete; //* Reports the result to the caller
+    };
+
+    //! Route from lookup threads back to the loop, cut when the client is destroyed
+    struct FTPAsyncClient::LookupHandoff
+    {
+        std::mutex mutex;            //* Held while posting, so the client cannot go away mid-post
+        FTPEventLoop *loop;          //* The client's loop, nullptr once the client is destroyed
+    };
+
+    //! Throw unless the reply carries one of the expected codes
+    //@ param reply The server reply
+    //@ param codes The accepted reply codes
+    static void Expect(const std::string &reply, std::initializer_list<int> codes)
+    {
+        auto [code, message] = FTPResponseParser::ParseResponse(reply);
+        if (std::find(codes.begin(), codes.end(), code) == codes.end())
+        {
+            throw FTPException("Unexpected response code: " + std::to_string(code) + " - " + message);
+        }
+    }
+
+    //! Split raw listing bytes into non-empty lines without line terminators
+    //@ param listing The bytes received on the data connection
+    //@ return The listing lines
+    static std::vector<std::string> SplitListing(const std::string &listing)
+    {
+        std::vector<std::string> entries;
+        for (auto &line : FTPUtilities::SplitString(listing, '\n'))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (!line.empty())
+            {
+                entries.push_back(std::move(line));
+            }
+        }
+        return entries;
+    }
+
+    //! Wrap a promise in a completion callback
+    template <typename T, typename... Args>
+    static std::function<void(std::exception_ptr, Args...)> Fulfil(std::shared_ptr<std::promise<T>> promise)
+    {
+        return [promise](std::exception_ptr error, Args... value)
+        {
+            if (error)
+            {
+                promise->set_exception(error);
+            }
+            else if constexpr (std::is_void_v<T>)
+            {
+                promise->set_value();
+            }
+            else
+            {
+                promise->set_value(std::move(value)...);
+            }
+        };
+    }
+
+    //! Constructor
+    //@ param loop The event loop that drives this client
+    FTPAsyncClient::FTPAsyncClient(FTPEventLoop &loop)
+        : m_loop(loop), m_socket(-1), m_connected(false), m_connecting(false),
+          m_reader(std::make_unique<FTPReplyReader>()), m_busy(false), m_nextOperation(1),
+          m_alive(std::make_shared<bool>(true)), m_port(0), m_resolver(FTPResolver::Shared()),
+          m_handoff(std::make_shared<LookupHandoff>()), m_addressIndex(0)
+    {
+        m_handoff->loop = &m_loop;
+    }
+
+    //! Destructor; closes the sockets without invoking pending callbacks
+    FTPAsyncClient::~FTPAsyncClient()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_handoff->mutex);
+            m_handoff->loop = nullptr;
+        }
+        *m_alive = false;
+        for (auto &operation : m_operations)
+        {
+            if (operation.cleanup)
+            {
+                operation.cleanup();
+            }
+        }
+        CloseControl();
+    }
+
+    //! Connect to an FTP server
+    //@ param host The hostname or IP address of the server
+    //@ param port The port number to connect to
+    //@ param done Called when the greeting has been received
+    void FTPAsyncClient::Connect(const std::string &host, uint16_t port, DoneCallback done)
+    {
+        std::string server = FTPUtilities::Trim(host);
+        Enqueue([this, server, port, done](uint64_t id)
+                {
+                    CloseControl();
+                    m_server = server + ":" + std::to_string(port);
+                    m_host = server;
+                    m_port = port;
+
+                    std::shared_future<FTPResolver::Addresses> lookup;
+                    if (m_resolver)
+                    {
+                        lookup = m_resolver->ResolveAsync(server, port);
+                        if (lookup.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                        {
+                            ConnectResolved(id, lookup.get(), done); //* Cached, nothing to wait for
+                            return;
+                        }
+                    }
+
+                    //* getaddrinfo blocks, so the lookup is waited for off the loop and the connect continues on it
+                    std::weak_ptr<bool> alive = m_alive;
+                    std::shared_ptr<LookupHandoff> handoff = m_handoff;
+                    std::thread([this, alive, handoff, lookup, server, port, id, done]()
+                                {
+                                    FTPResolver::Addresses addresses;
+                                    std::exception_ptr error;
+                                    try
+                                    {
+                                        addresses = lookup.valid() ? lookup.get()
+                                                                   : FTPResolver::SystemLookup(server, port);
+                                    }
+                                    catch (...)
+                                    {
+                                        error = std::current_exception();
+                                    }
+
+                                    std::lock_guard<std::mutex> lock(handoff->mutex);
+                                    if (!handoff->loop)
+                                    {
+                                        return;
+                                    }
+                                    handoff->loop->Post([this, alive, addresses, error, id, done]()
+                                                        {
+                                                            if (alive.expired() || m_operations.empty() ||
+                                                                m_operations.front().id != id)
+                                                            {
+                                                                return;
+                                                            }
+                                                            try
+                                                            {
+                                                                if (error)
+                                                                {
+                                                                    std::rethrow_exception(error);
+                                                                }
+                                                                ConnectResolved(id, addresses, done);
+                                                            }
+                                                            catch (...)
+                                                            {
+                                                                Fail(id, std::current_exception());
+                                                            } });
+                                })
+                        .detach();
+                },
+                done);
+    }
+
+    //! Start connecting to a resolved server and wait for its greeting
+    //@ param id The Connect operation
+    //@ param addresses The server's addresses
+    //@ param done Called when the greeting has been received
+    void FTPAsyncClient::ConnectResolved(uint64_t id, const std::vector<ResolvedAddress> &addresses, DoneCallback done)
+    {
+        m_addresses = FTPResolver::Interleave(addresses);
+        m_addressIndex = 0;
+        if (!ConnectNextAddress())
+        {
+            if (m_resolver)
+            {
+                m_resolver->Invalidate(m_host, m_port);
+            }
+            throw FTPException("Failed to connect to the server.");
+        }
+
+        //* The greeting arrives unprompted, from whichever address accepts the connection
+        m_pendingReplies.push_back({id, [this, id, done](const std::string &reply)
+                                    {
+                                        Expect(reply, {220});
+                                        m_connected = true;
+                                        Notify([done]()
+                                               { done(nullptr); });
+                                        Succeed(id);
+                                        return true;
+                                    }});
+    }
+
+    //! Start a non-blocking connect to the next address that can be tried
+    //@ return False if no address is left
+    bool FTPAsyncClient::ConnectNextAddress()
+    {
+        if (m_socket >= 0)
+        {
+            m_loop.Unwatch(m_socket);
+            closesocket(m_socket);
+            m_socket = -1;
+        }
+        for (; m_addressIndex < m_addresses.size(); ++m_addressIndex)
+        {
+            const ResolvedAddress &address = m_addresses[m_addressIndex];
+            int fd = static_cast<int>(socket(address.Family(), SOCK_STREAM, IPPROTO_TCP));
+            if (fd < 0)
+            {
+                continue;
+            }
+            FTPEventLoop::SetNonBlocking(fd);
+            SuppressSigPipe(fd);
+            if (::connect(fd, reinterpret_cast<const sockaddr *>(&address.address), address.length) < 0 &&
+                !FTPEventLoop::WouldBlock())
+            {
+                closesocket(fd);
+                continue;
+            }
+
+            m_socket = fd;
+            m_connecting = true;
+            m_reader->Reset();
+            m_loop.Watch(m_socket, FTPEventLoop::kRead | FTPEventLoop::kWrite,
+                         [this](uint32_t events)
+                         { OnControlEvent(events); });
+            return true;
+        }
+        return false;
+    }
+
+    //! Authenticate with username and password
+    //@ param username The username to authenticate with
+    //@ param password The password to authenticate with
+    //@ param done Called when the login completes
+    void FTPAsyncClient::Authenticate(const std::string &username, const std::string &password, DoneCallback done)
+    {
+        std::string user = FTPUtilities::Trim(username);
+        std::string pass = FTPUtilities::Trim(password);
+        Enqueue([this, user, pass, done](uint64_t id)
+                {
+                    SendCommand(id, "USER " + user, [this, id, pass, done](const std::string &reply)
+                                {
+                                    if (FTPResponseParser::IsExpectedCode(reply, 230))
+                                    {
+                                        Notify([done]()
+                                               { done(nullptr); });
+                                        Succeed(id);
+                                        return true;
+                                    }
+                                    Expect(reply, {331});
+                                    SendCommand(id, "PASS " + pass, [this, id, done](const std::string &passReply)
+                                                {
+                                                    Expect(passReply, {230});
+                                                    Notify([done]()
+                                                           { done(nullptr); });
+                                                    Succeed(id);
+                                                    return true;
+                                                });
+                                    return true;
+                                });
+                },
+                done);
+    }
+
+    //! List a remote directory
+    //@ param remoteDir The directory to list
+    //@ param done Called with the listing lines
+    void FTPAsyncClient::ListDirectory(const std::string &remoteDir, ListCallback done)
+    {
+        std::string directory = FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir);
+        auto transfer = std::make_shared<DataTransfer>();
+        transfer->kind = DataTransfer::List;
+        transfer->complete = [done](std::exception_ptr error, DataTransfer &result)
+        { done(error, error ? std::vector<std::string>() : SplitListing(result.listing)); };
+
+        Enqueue([this, transfer, directory, done](uint64_t id)
+                {
+                    transfer->operation = id;
+                    if (m_listingCache)
+                    {
+                        //* Looked up when the operation starts so earlier uploads have invalidated it
+                        auto cache = m_listingCache;
+                        std::string server = m_server;
+                        std::vector<std::string> cached;
+                        FTPListingCache::State state = cache->Lookup(server, directory, cached);
+                        if (state == FTPListingCache::State::Fresh)
+                        {
+                            Notify([done, cached]() mutable
+                                   { done(nullptr, std::move(cached)); });
+                            Succeed(id);
+                            return;
+                        }
+
+                        if (state == FTPListingCache::State::Stale)
+                        {
+                            Notify([done, cached]()
+                                   { done(nullptr, cached); });
+                            if (!cache->BeginRefresh(server, directory))
+                            {
+                                Succeed(id); //* Another client is already revalidating it
+                                return;
+                            }
+                            transfer->complete = [cache, server, directory, cached, refreshed = m_listingRefreshed](
+                                                     std::exception_ptr error, DataTransfer &result)
+                            {
+                                if (error)
+                                {
+                                    cache->CancelRefresh(server, directory);
+                                    return;
+                                }
+                                std::vector<std::string> entries = SplitListing(result.listing);
+                                cache->Store(server, directory, entries);
+                                if (refreshed && entries != cached)
+                                {
+                                    refreshed(directory, std::move(entries));
+                                }
+                            };
+                        }
+                        else
+                        {
+                            transfer->complete = [cache, server, directory, done](std::exception_ptr error,
+                                                                                   DataTransfer &result)
+                            {
+                                std::vector<std::string> entries;
+                                if (!error)
+                                {
+                                    entries = SplitListing(result.listing);
+                                    cache->Store(server, directory, entries);
+                                }
+                                done(error, std::move(entries));
+                            };
+                        }
+                    }
+                    StartTransfer(transfer, "LIST " + directory);
+                },
+                [transfer](std::exception_ptr error)
+                { transfer->complete(error, *transfer); },
+                [this, transfer]()
+                { CloseData(*transfer); });
+    }
+
+    //! Download a file from the server
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The path to save the file locally
+    //@ param done Called with the transfer statistics
+    void FTPAsyncClient::DownloadFile(const std::string &remoteFilePath, const std::string &localFilePath,
+                                      TransferCallback done)
+    {
+        std::string remote = FTPUtilities::Trim(remoteFilePath);
+        std::string fileName = remote.substr(remote.find_last_of("/\\") + 1);
+        std::string local = localFilePath.empty() ? "./" + fileName : localFilePath;
+        if (!FTPUtilities::EndsWith(local, fileName))
+        {
+            local += "/" + fileName;
+        }
+
+        auto transfer = std::make_shared<DataTransfer>();
+        transfer->kind = DataTransfer::Download;
+        transfer->complete = [done](std::exception_ptr error, DataTransfer &result)
+        { done(error, result.stats); };
+
+        Enqueue([this, transfer, remote, local](uint64_t id)
+                {
+                    transfer->operation = id;
+                    transfer->file = fopen(local.c_str(), "wb");
+                    if (!transfer->file)
+                    {
+                        throw FTPException("Failed to open local file for writing: " + local);
+                    }
+                    StartTransfer(transfer, "RETR " + remote);
+                },
+                [transfer](std::exception_ptr error)
+                { transfer->complete(error, *transfer); },
+                [this, transfer]()
+                { CloseData(*transfer); });
+    }
+
+    //! Upload a file to the server
+    //@ param localFilePath The path to the file to upload
+    //@ param remoteFilePath The path to save the file on the server
+    //@ param done Called with the transfer statistics
+    void FTPAsyncClient::UploadFile(const std::string &localFilePath, const std::string &remoteFilePath,
+                                    TransferCallback done)
+    {
+        std::string remote = FTPUtilities::Trim(remoteFilePath);
+        std::string local = localFilePath;
+
+        auto transfer = std::make_shared<DataTransfer>();
+        transfer->kind = DataTransfer::Upload;
+        transfer->complete = [done](std::exception_ptr error, DataTransfer &result)
+        { done(error, result.stats); };
+
+        Enqueue([this, transfer, remote, local](uint64_t id)
+                {
+                    transfer->operation = id;
+                    transfer->file = fopen(local.c_str(), "rb");
+                    if (!transfer->file)
+                    {
+                        throw FTPException("Failed to open local file for reading: " + local);
+                    }
+                    if (m_listingCache)
+                    {
+                        //* The directory changes whether or not the upload completes
+                        auto report = std::move(transfer->complete);
+                        transfer->complete = [cache = m_listingCache, server = m_server, remote, report](
+                                                 std::exception_ptr error, DataTransfer &result)
+                        {
+                            cache->InvalidateParent(server, remote);
+                            report(error, result);
+                        };
+                    }
+                    StartTransfer(transfer, "STOR " + remote);
+                },
+                [transfer](std::exception_ptr error)
+                { transfer->complete(error, *transfer); },
+                [this, transfer]()
+                { CloseData(*transfer); });
+    }
+
+    //! Send QUIT and close the control connection
+    //@ param done Called once the connection is closed
+    void FTPAsyncClient::Disconnect(DoneCallback done)
+    {
+        Enqueue([this, done](uint64_t id)
+                {
+                    if (!m_connected)
+                    {
+                        CloseControl();
+                        Notify([done]()
+                               { done(nullptr); });
+                        Succeed(id);
+                        return;
+                    }
+                    SendCommand(id, "QUIT", [this, id, done](const std::string &)
+                                {
+                                    CloseControl();
+                                    Notify([done]()
+                                           { done(nullptr); });
+                                    Succeed(id);
+                                    return true;
+                                });
+                },
+                done);
+    }
+
+    //! Future-returning variants
+    std::future<void> FTPAsyncClient::Connect(const std::string &host, uint16_t port)
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        Connect(host, port, Fulfil<void>(promise));
+        return promise->get_future();
+    }
+
+    std::future<void> FTPAsyncClient::Authenticate(const std::string &username, const std::string &password)
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        Authenticate(username, password, Fulfil<void>(promise));
+        return promise->get_future();
+    }
+
+    std::future<std::vector<std::string>> FTPAsyncClient::ListDirectory(const std::string &remoteDir)
+    {
+        auto promise = std::make_shared<std::promise<std::vector<std::string>>>();
+        ListDirectory(remoteDir, Fulfil<std::vector<std::string>, std::vector<std::string>>(promise));
+        return promise->get_future();
+    }
+
+    std::future<TransferStats> FTPAsyncClient::DownloadFile(const std::string &remoteFilePath,
+                                                            const std::string &localFilePath)
+    {
+        auto promise = std::make_shared<std::promise<TransferStats>>();
+        DownloadFile(remoteFilePath, localFilePath, Fulfil<TransferStats, TransferStats>(promise));
+        return promise->get_future();
+    }
+
+    std::future<TransferStats> FTPAsyncClient::UploadFile(const std::string &localFilePath,
+                                                          const std::string &remoteFilePath)
+    {
+        auto promise = std::make_shared<std::promise<TransferStats>>();
+        UploadFile(localFilePath, remoteFilePath, Fulfil<TransferStats, TransferStats>(promise));
+        return promise->get_future();
+    }
+
+    std::future<void> FTPAsyncClient::Disconnect()
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        Disconnect(Fulfil<void>(promise));
+        return promise->get_future();
+    }
+
+    //! Queue an operation; it starts once every earlier operation has finished
+    //@ param start Issues the first command of the operation
+    //@ param fail Reports a failure to the caller
+    //@ param cleanup Releases the operation's resources when it fails
+    void FTPAsyncClient::Enqueue(std::function<void(uint64_t id)> start, std::function<void(std::exception_ptr)> fail,
+                                 std::function<void()> cleanup)
+    {
+        //* Hop onto the loop thread so the public API is safe to call from anywhere
+        std::weak_ptr<bool> alive = m_alive;
+        m_loop.Post([this, alive, start, fail, cleanup]()
+                    {
+                        if (alive.expired())
+                        {
+                            return;
+                        }
+                        uint64_t id = m_nextOperation++;
+                        m_operations.push_back({id, [start, id]()
+                                                { start(id); },
+                                                fail, cleanup});
+                        if (!m_busy)
+                        {
+                            StartNext();
+                        }
+                    });
+    }
+
+    //! Start the next queued operation
+    void FTPAsyncClient::StartNext()
+    {
+        while (!m_operations.empty())
+        {
+            m_busy = true;
+            Operation &operation = m_operations.front();
+            try
+            {
+                operation.start();
+                return;
+            }
+            catch (...)
+            {
+                Operation failed = std::move(operation);
+                m_operations.pop_front();
+                if (failed.cleanup)
+                {
+                    failed.cleanup();
+                }
+                Notify([fail = std::move(failed.fail), error = std::current_exception()]()
+                       { fail(error); });
+            }
+        }
+        m_busy = false;
+    }
+
+    //! Finish an operation successfully
+    //@ param id The operation that finished
+    void FTPAsyncClient::Succeed(uint64_t id)
+    {
+        if (m_operations.empty() || m_operations.front().id != id)
+        {
+            return;
+        }
+        m_operations.pop_front();
+        StartNext();
+    }
+
+    //! Finish an operation with an error
+    //@ param id The operation that failed
+    //@ param error The failure
+    void FTPAsyncClient::Fail(uint64_t id, std::exception_ptr error)
+    {
+        if (m_operations.empty() || m_operations.front().id != id)
+        {
+            return;
+        }
+        Operation failed = std::move(m_operations.front());
+        m_operations.pop_front();
+        if (failed.cleanup)
+        {
+            failed.cleanup();
+        }
+        Notify([fail = std::move(failed.fail), error]()
+               { fail(error); });
+        StartNext();
+    }
+
+    //! Tear down the control connection and fail every pending operation
+    //@ param error The failure to report
+    void FTPAsyncClient::FailConnection(std::exception_ptr error)
+    {
+        CloseControl();
+        std::deque<Operation> operations;
+        operations.swap(m_operations);
+        m_busy = false;
+        for (auto &operation : operations)
+        {
+            if (operation.cleanup)
+            {
+                operation.cleanup();
+            }
+            Notify([fail = std::move(operation.fail), error]()
+                   { fail(error); });
+        }
+    }
+
+    //! Run a user callback from a fresh loop task
+    //! Callbacks never run inside the client's own frames, so they may
+    //! freely destroy the client or issue further operations.
+    //@ param callback The callback to run
+    void FTPAsyncClient::Notify(std::function<void()> callback)
+    {
+        m_loop.Post(std::move(callback));
+    }
+
+    //! Queue a command and the handler for its reply
+    //@ param id The operation that issues the command
+    //@ param command The command to send (without CRLF)
+    //@ param handler The reply handler
+    void FTPAsyncClient::SendCommand(uint64_t id, const std::string &command, ReplyHandler handler)
+    {
+        if (m_socket < 0)
+        {
+            throw FTPException("Not connected to a server.");
+        }
+        m_outbox += FTPUtilities::Trim(command);
+        m_outbox += "\r\n";
+        m_pendingReplies.push_back({id, std::move(handler)});
+        UpdateInterest();
+    }
+
+    //! Handle readiness on the control socket
+    //@ param events The ready flags
+    void FTPAsyncClient::OnControlEvent(uint32_t events)
+    {
+        if (m_connecting)
+        {
+            if (!(events & (FTPEventLoop::kWrite | FTPEventLoop::kError)))
+            {
+                return;
+            }
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(m_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &length);
+            if (error != 0)
+            {
+                ++m_addressIndex;
+                if (!ConnectNextAddress())
+                {
+                    //* The cached addresses may be outdated; look the host up again next time
+                    if (m_resolver)
+                    {
+                        m_resolver->Invalidate(m_host, m_port);
+                    }
+                    FailConnection(std::make_exception_ptr(FTPException("Failed to connect to the server.")));
+                }
+                return;
+            }
+            m_connecting = false;
+            if (m_addressIndex > 0 && m_resolver)
+            {
+                //* Try the address that answered first next time, instead of waiting on the dead one again
+                m_resolver->Promote(m_host, m_port, m_addresses[m_addressIndex]);
+            }
+        }
+
+        if (events & FTPEventLoop::kRead)
+        {
+            char buffer[4096];
+            ssize_t bytesRead;
+            while ((bytesRead = recv(m_socket, buffer, sizeof(buffer), 0)) > 0)
+            {
+                m_reader->Feed(buffer, bytesRead);
+            }
+            bool closed = bytesRead == 0 || !FTPEventLoop::WouldBlock();
+
+            std::string reply;
+            while (m_socket >= 0 && m_reader->TryPopReply(reply))
+            {
+                if (m_pendingReplies.empty())
+                {
+                    continue; //* Unsolicited reply (e.g. 421 timeout notice)
+                }
+
+                PendingReply pending = std::move(m_pendingReplies.front());
+                m_pendingReplies.pop_front();
+                try
+                {
+                    if (!pending.handler(reply) && m_socket >= 0)
+                    {
+                        m_pendingReplies.push_front(std::move(pending));
+                    }
+                }
+                catch (...)
+                {
+                    Fail(pending.operation, std::current_exception());
+                }
+            }
+
+            //* Replies that arrived before the close (e.g. 221 after QUIT) have been handled above
+            if (closed && m_socket >= 0)
+            {
+                FailConnection(std::make_exception_ptr(FTPException(
+                    bytesRead == 0 ? "Connection closed by server." : "Failed to receive response.")));
+                return;
+            }
+        }
+
+        if (m_socket >= 0 && (events & FTPEventLoop::kWrite) && !m_outbox.empty())
+        {
+            ssize_t bytesSent = send(m_socket, m_outbox.data(), static_cast<int>(m_outbox.size()), kSendFlags);
+            if (bytesSent > 0)
+            {
+                m_outbox.erase(0, bytesSent);
+            }
+            else if (bytesSent < 0 && !FTPEventLoop::WouldBlock())
+            {
+                FailConnection(std::make_exception_ptr(FTPException("Failed to send command.")));
+                return;
+            }
+        }
+
+        UpdateInterest();
+    }
+
+    //! Recompute the control socket readiness flags
+    void FTPAsyncClient::UpdateInterest()
+    {
+        if (m_socket < 0)
+        {
+            return;
+        }
+        uint32_t events = FTPEventLoop::kRead;
+        if (m_connecting || !m_outbox.empty())
+        {
+            events |= FTPEventLoop::kWrite;
+        }
+        m_loop.Modify(m_socket, events);
+    }
+
+    //! Close the control socket and drop all pending replies
+    void FTPAsyncClient::CloseControl()
+    {
+        if (m_socket >= 0)
+        {
+            m_loop.Unwatch(m_socket);
+            closesocket(m_socket);
+            m_socket = -1;
+        }
+        m_connected = false;
+        m_connecting = false;
+        m_outbox.clear();
+        m_pendingReplies.clear();
+        m_reader->Reset();
+    }
+
+    //! Enter passive mode, connect the data socket, then issue the transfer command
+    //@ param transfer The transfer state
+    //@ param command The LIST/RETR/STOR command to issue once connected
+    void FTPAsyncClient::StartTransfer(std::shared_ptr<DataTransfer> transfer, const std::string &command)
+    {
+        uint64_t id = transfer->operation;
+        //* PASV cannot carry an IPv6 address
+        bool extended = m_socket >= 0 && m_addresses[m_addressIndex].Family() == AF_INET6;
+        SendCommand(id, extended ? "EPSV" : "PASV", [this, transfer, command, id, extended](const std::string &reply)
+                    {
+                        ResolvedAddress dataAddress;
+                        if (extended)
+                        {
+                            //* EPSV names only the port; the host is the one the control connection reached
+                            Expect(reply, {229});
+                            dataAddress = m_addresses[m_addressIndex];
+                            reinterpret_cast<sockaddr_in6 &>(dataAddress.address).sin6_port =
+                                htons(FTPUtilities::ParseExtendedPassiveResponse(reply));
+                        }
+                        else
+                        {
+                            Expect(reply, {227});
+                            auto [ip, port] = FTPUtilities::ParsePassiveModeResponse(reply);
+                            auto &dataAddr = reinterpret_cast<sockaddr_in &>(dataAddress.address);
+                            dataAddr.sin_family = AF_INET;
+                            dataAddr.sin_port = htons(port);
+                            inet_pton(AF_INET, ip.c_str(), &dataAddr.sin_addr);
+                            dataAddress.length = sizeof(sockaddr_in);
+                        }
+
+                        transfer->socket = socket(dataAddress.Family(), SOCK_STREAM, 0);
+                        if (transfer->socket < 0)
+                        {
+                            throw FTPException("Failed to create data socket.");
+                        }
+                        FTPEventLoop::SetNonBlocking(transfer->socket);
+                        SuppressSigPipe(transfer->socket);
+
+                        if (::connect(transfer->socket, reinterpret_cast<const sockaddr *>(&dataAddress.address),
+                                      dataAddress.length) < 0 &&
+                            !FTPEventLoop::WouldBlock())
+                        {
+                            throw FTPException("Failed to connect to passive mode address.");
+                        }
+
+                        m_loop.Watch(transfer->socket, FTPEventLoop::kWrite, [this, transfer, command, id](uint32_t)
+                                     {
+                                         int error = 0;
+                                         socklen_t length = sizeof(error);
+                                         getsockopt(transfer->socket, SOL_SOCKET, SO_ERROR,
+                                                    reinterpret_cast<char *>(&error), &length);
+                                         if (error != 0)
+                                         {
+                                             Fail(id, std::make_exception_ptr(
+                                                          FTPException("Failed to connect to passive mode address.")));
+                                             return;
+                                         }
+
+                                         //* Connected: read straight away, write only after the 150 preliminary reply
+                                         transfer->start = std::chrono::steady_clock::now();
+                                         transfer->buffer.resize(FTPTransfer::kDefaultBufferSize);
+                                         m_loop.Rewatch(transfer->socket,
+                                                        transfer->kind == DataTransfer::Upload ? 0u : static_cast<uint32_t>(FTPEventLoop::kRead),
+                                                        [this, transfer](uint32_t events)
+                                                        { OnDataEvent(transfer, events); });
+
+                                         try
+                                         {
+                                             SendCommand(id, command, [this, transfer](const std::string &transferReply)
+                                                         {
+                                                             int code = FTPResponseParser::ExtractCode(transferReply);
+                                                             if (code >= 100 && code < 200)
+                                                             {
+                                                                 if (transfer->kind == DataTransfer::Upload && transfer->socket >= 0)
+                                                                 {
+                                                                     m_loop.Modify(transfer->socket, FTPEventLoop::kWrite);
+                                                                 }
+                                                                 return false;
+                                                             }
+                                                             Expect(transferReply, {226, 250});
+                                                             transfer->controlDone = true;
+                                                             MaybeFinishTransfer(transfer);
+                                                             return true;
+                                                         });
+                                         }
+                                         catch (...)
+                                         {
+                                             Fail(id, std::current_exception());
+                                         } });
+                        return true;
+                    });
+    }
+
+    //! Handle readiness on a data socket
+    //@ param transfer The transfer state
+    //@ param events The ready flags
+    void FTPAsyncClient::OnDataEvent(const std::shared_ptr<DataTransfer> &transfer, uint32_t events)
+    {
+        try
+        {
+            if (transfer->kind != DataTransfer::Upload && (events & FTPEventLoop::kRead))
+            {
+                while (true)
+                {
+                    ssize_t bytesRead = recv(transfer->socket, transfer->buffer.data(),
+                                             static_cast<int>(transfer->buffer.size()), 0);
+                    ++transfer->stats.syscalls;
+                    if (bytesRead > 0)
+                    {
+                        if (transfer->kind == DataTransfer::List)
+                        {
+                            transfer->listing.append(transfer->buffer.data(), bytesRead);
+                        }
+                        else if (fwrite(transfer->buffer.data(), 1, bytesRead, transfer->file) !=
+                                 static_cast<size_t>(bytesRead))
+                        {
+                            throw FTPException("Failed to write local file.");
+                        }
+                        transfer->stats.bytes += bytesRead;
+                        continue;
+                    }
+                    if (bytesRead < 0 && FTPEventLoop::WouldBlock())
+                    {
+                        return;
+                    }
+                    if (bytesRead < 0)
+                    {
+                        throw FTPException("Failed to receive file data.");
+                    }
+                    break;
+                }
+            }
+            else if (transfer->kind == DataTransfer::Upload && (events & (FTPEventLoop::kWrite | FTPEventLoop::kError)))
+            {
+                while (true)
+                {
+                    if (transfer->bufferOffset == transfer->bufferLength)
+                    {
+                        transfer->bufferLength = fread(transfer->buffer.data(), 1, transfer->buffer.size(), transfer->file);
+                        transfer->bufferOffset = 0;
+                        if (transfer->bufferLength == 0)
+                        {
+                            if (ferror(transfer->file))
+                            {
+                                throw FTPException("Failed to read local file.");
+                            }
+                            break;
+                        }
+                    }
+
+                    ssize_t bytesSent = send(transfer->socket, transfer->buffer.data() + transfer->bufferOffset,
+                                             static_cast<int>(transfer->bufferLength - transfer->bufferOffset),
+                                             kSendFlags);
+                    ++transfer->stats.syscalls;
+                    if (bytesSent < 0 && FTPEventLoop::WouldBlock())
+                    {
+                        return;
+                    }
+                    if (bytesSent <= 0)
+                    {
+                        throw FTPException("Failed to send file data.");
+                    }
+                    transfer->bufferOffset += bytesSent;
+                    transfer->stats.bytes += bytesSent;
+                }
+            }
+            else
+            {
+                return;
+            }
+
+            //* End of data: closing the socket tells the server an upload is complete
+            transfer->stats.seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - transfer->start).count();
+            transfer->dataDone = true;
+            CloseData(*transfer);
+            MaybeFinishTransfer(transfer);
+        }
+        catch (...)
+        {
+            Fail(transfer->operation, std::current_exception());
+        }
+    }
+
+    //! Complete the transfer once both the data stream and the final reply are done
+    //@ param transfer The transfer state
+    void FTPAsyncClient::MaybeFinishTransfer(const std::shared_ptr<DataTransfer> &transfer)
+    {
+        if (!transfer->dataDone || !transfer->controlDone)
+        {
+            return;
+        }
+        CloseData(*transfer);
+        Notify([transfer]()
+               { transfer->complete(nullptr, *transfer); });
+        Succeed(transfer->operation);
+    }
+
+    //! Close the data socket and the local file of a transfer
+    //@ param transfer The transfer state
+    void FTPAsyncClient::CloseData(DataTransfer &transfer)
+    {
+        if (transfer.socket >= 0)
+        {
+            m_loop.Unwatch(transfer.socket);
+            closesocket(transfer.socket);
+            transfer.socket = -1;
+        }
+        if (transfer.file)
+        {
+            fclose(transfer.file);
+            transfer.file = nullptr;
+        }
+    }
+
+}
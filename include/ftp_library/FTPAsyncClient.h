@@ -0,0 +1,189 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPAsyncClient.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:45:15 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPASYNCCLIENT_H
+#define FTPASYNCCLIENT_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    class FTPEventLoop;
+    class FTPReplyReader;
+    class FTPListingCache;
+    class FTPResolver;
+    struct ResolvedAddress;
+    struct TransferStats;
+
+    //! Non-blocking FTP client driven by an FTPEventLoop
+    //! Every operation returns immediately and completes through a callback
+    //! (posted to the loop thread) or a future. Operations on one client run
+    //! in the order they were issued; many clients can share one loop.
+    class FTPAsyncClient
+    {
+    public:
+        using DoneCallback = std::function<void(std::exception_ptr error)>;
+        using ListCallback = std::function<void(std::exception_ptr error, std::vector<std::string> entries)>;
+        using TransferCallback = std::function<void(std::exception_ptr error, TransferStats stats)>;
+        using RefreshCallback = std::function<void(const std::string &remoteDir, std::vector<std::string> entries)>;
+
+        //! Constructor and destructor
+        //! @param loop The event loop that drives this client; must outlive it
+        explicit FTPAsyncClient(FTPEventLoop &loop);
+        ~FTPAsyncClient();
+
+        //! Prevent copy construction and assignment
+        FTPAsyncClient(const FTPAsyncClient &) = delete;
+        FTPAsyncClient &operator=(const FTPAsyncClient &) = delete;
+
+        //! Connect to an FTP server
+        //! The host is resolved through the resolver; a lookup that is not cached runs on
+        //! a worker thread, so the loop keeps serving other clients meanwhile. IPv4 and
+        //! IPv6 addresses are tried in turn until one accepts the connection.
+        //! @param host The hostname or IP address of the server
+        //! @param port The port number to connect to
+        //! @param done Called when the greeting has been received
+        void Connect(const std::string &host, uint16_t port, DoneCallback done);
+
+        //! Authenticate with username and password
+        //! @param username The username to authenticate with
+        //! @param password The password to authenticate with
+        //! @param done Called when the login completes
+        void Authenticate(const std::string &username, const std::string &password, DoneCallback done);
+
+        //! List a remote directory
+        //! @param remoteDir The directory to list
+        //! @param done Called with the listing lines
+        void ListDirectory(const std::string &remoteDir, ListCallback done);
+
+        //! Download a file from the server
+        //! @param remoteFilePath The path to the file on the server
+        //! @param localFilePath The path to save the file locally
+        //! @param done Called with the transfer statistics
+        void DownloadFile(const std::string &remoteFilePath, const std::string &localFilePath, TransferCallback done);
+
+        //! Upload a file to the server
+        //! @param localFilePath The path to the file to upload
+        //! @param remoteFilePath The path to save the file on the server
+        //! @param done Called with the transfer statistics
+        void UploadFile(const std::string &localFilePath, const std::string &remoteFilePath, TransferCallback done);
+
+        //! Send QUIT and close the control connection
+        //! @param done Called once the connection is closed
+        void Disconnect(DoneCallback done);
+
+        //! Future-returning variants; never wait on these from the loop thread
+        std::future<void> Connect(const std::string &host, uint16_t port = 21);
+        std::future<void> Authenticate(const std::string &username, const std::string &password);
+        std::future<std::vector<std::string>> ListDirectory(const std::string &remoteDir = "/");
+        std::future<TransferStats> DownloadFile(const std::string &remoteFilePath, const std::string &localFilePath);
+        std::future<TransferStats> UploadFile(const std::string &localFilePath, const std::string &remoteFilePath);
+        std::future<void> Disconnect();
+
+        //! Attach a listing cache (may be shared with other clients), or nullptr to detach
+        //! Fresh listings complete without touching the network. A stale listing is
+        //! delivered at once and then revalidated in the background; if the listing
+        //! changed, refreshed receives the new one. Uploads invalidate their directory.
+        //! Call before issuing operations or from the loop thread.
+        //! @param cache The cache to use
+        //! @param refreshed Called with revalidated listings that changed (may be empty)
+        void SetListingCache(std::shared_ptr<FTPListingCache> cache, RefreshCallback refreshed = nullptr)
+        {
+            m_listingCache = std::move(cache);
+            m_listingRefreshed = std::move(refreshed);
+        }
+
+        //! Attach a host name resolver (may be shared with other clients), or nullptr to look up on every connect
+        //! Every client starts with FTPResolver::Shared(). Call before Connect or from the loop thread.
+        //! @param resolver The resolver to use
+        void SetResolver(std::shared_ptr<FTPResolver> resolver)
+        {
+            m_resolver = std::move(resolver);
+        }
+
+        //! Check the connection state (loop thread only)
+        bool IsConnected() const
+        {
+            return m_connected;
+        }
+
+        //! Get the event loop that drives this client
+        FTPEventLoop &Loop() const
+        {
+            return m_loop;
+        }
+
+    private:
+        using ReplyHandler = std::function<bool(const std::string &reply)>; //* Returns false to wait for another reply
+
+        struct PendingReply
+        {
+            uint64_t operation;  //* Operation that issued the command
+            ReplyHandler handler; //* Handler for the reply
+        };
+
+        struct Operation
+        {
+            uint64_t id;                                  //* Operation identifier
+            std::function<void()> start;                  //* Issues the first command
+            std::function<void(std::exception_ptr)> fail; //* Reports a failure to the caller
+            std::function<void()> cleanup;                //* Releases sockets and files on failure
+        };
+
+        struct DataTransfer;
+        struct LookupHandoff;
+
+        void Enqueue(std::function<void(uint64_t id)> start, std::function<void(std::exception_ptr)> fail,
+                     std::function<void()> cleanup = {});
+        void Notify(std::function<void()> callback);                   //* Run a user callback from the loop
+        void StartNext();                                              //* Start the next queued operation
+        void Succeed(uint64_t id);                                     //* Finish an operation successfully
+        void Fail(uint64_t id, std::exception_ptr error);              //* Finish an operation with an error
+        void FailConnection(std::exception_ptr error);                 //* Tear down and fail everything
+        void ConnectResolved(uint64_t id, const std::vector<ResolvedAddress> &addresses, //* Start connecting
+                             DoneCallback done);
+        bool ConnectNextAddress();                                     //* Connect to m_addresses from m_addressIndex on
+        void SendCommand(uint64_t id, const std::string &command, ReplyHandler handler);
+        void OnControlEvent(uint32_t events);                          //* Control socket readiness
+        void UpdateInterest();                                         //* Recompute control socket flags
+        void CloseControl();                                           //* Close the control socket
+        void StartTransfer(std::shared_ptr<DataTransfer> transfer, const std::string &command);
+        void OnDataEvent(const std::shared_ptr<DataTransfer> &transfer, uint32_t events);
+        void MaybeFinishTransfer(const std::shared_ptr<DataTransfer> &transfer);
+        void CloseData(DataTransfer &transfer);
+
+        FTPEventLoop &m_loop;                          //* Loop driving this client
+        int m_socket;                                  //* Control socket
+        bool m_connected;                              //* True after the 220 greeting
+        bool m_connecting;                             //* True while the TCP connect is in flight
+        std::unique_ptr<FTPReplyReader> m_reader;      //* Incremental reply framer
+        std::string m_outbox;                          //* Commands not yet written
+        std::deque<PendingReply> m_pendingReplies;     //* Handlers in command order
+        std::deque<Operation> m_operations;            //* Queued operations, front is running
+        bool m_busy;                                   //* True while an operation is running
+        uint64_t m_nextOperation;                      //* Next operation identifier
+        std::shared_ptr<bool> m_alive;                 //* Cleared on destruction for posted tasks
+        std::string m_server;                          //* "host:port" for listing cache keys
+        std::string m_host;                            //* Host name given to Connect
+        uint16_t m_port;                               //* Port given to Connect
+        std::shared_ptr<FTPResolver> m_resolver;       //* Host name resolver, may be shared
+        std::shared_ptr<LookupHandoff> m_handoff;      //* Lets lookup threads post back while the client exists
+        std::vector<ResolvedAddress> m_addresses;      //* Addresses of the server, in connect order
+        size_t m_addressIndex;                         //* Address being connected to, then the connected one
+        std::shared_ptr<FTPListingCache> m_listingCache; //* Optional directory listing cache
+        RefreshCallback m_listingRefreshed;            //* Receives changed listings after revalidation
+    };
+
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:45:43 
+ * Last Modified: Sat October 17th 2026 23:11:01 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -16,7 +16,16 @@ namespace ftp_library
 {
 
     //! Constructor
-    FTPClient::FTPClient() : m_socket(-1), m_connected(false), m_port(21), m_remoteDir("/")
+    FTPClient::FTPClient() : m_socket(-1), m_connected(false), m_port(21), m_remoteDir("/"),
+                             m_replyReader(std::make_unique<FTPReplyReader>()),
+                             m_transferBufferSize(FTPTransfer::kDefaultBufferSize), m_zeroCopy(true),
+                             m_binaryMode(false), m_verbose(true),
+                             m_transferLimiter(std::make_shared<FTPRateLimiter>()),
+                             m_resolver(FTPResolver::Shared()), m_peerAddress{}, m_peerAddressLength(0),
+                             m_handshakeSeconds(0.0), m_bandwidthEstimate(0.0), m_compressionLevel(0), m_modeZ(false),
+                             m_modeZRefused(false), m_modeZLevel(0), m_pipelineTransfers(false),
+                             m_epsvConfirmed(false), m_epsvRefused(false), m_verifyActivePeer(true),
+                             m_replyHeld(false)
     {
 #if defined(_WIN32) || defined(_WIN64)
         if (!InitializeWinsock())
@@ -41,10 +50,26 @@ namespace ftp_library
     //! Move constructor
     FTPClient::FTPClient(FTPClient &&other) noexcept
         : m_socket(other.m_socket), m_connected(other.m_connected), m_host(std::move(other.m_host)),
-          m_port(other.m_port), m_remoteDir(std::move(other.m_remoteDir))
+          m_port(other.m_port), m_remoteDir(std::move(other.m_remoteDir)),
+          m_replyReader(std::move(other.m_replyReader)), m_transferBufferSize(other.m_transferBufferSize),
+          m_zeroCopy(other.m_zeroCopy), m_lastTransferStats(other.m_lastTransferStats),
+          m_username(std::move(other.m_username)), m_password(std::move(other.m_password)),
+          m_binaryMode(other.m_binaryMode), m_verbose(other.m_verbose), m_retryPolicy(other.m_retryPolicy),
+          m_listingCache(std::move(other.m_listingCache)), m_metricsSink(std::move(other.m_metricsSink)),
+          m_tracer(std::move(other.m_tracer)), m_bandwidthLimits(std::move(other.m_bandwidthLimits)),
+          m_transferLimiter(std::move(other.m_transferLimiter)), m_socketOptions(other.m_socketOptions),
+          m_resolver(std::move(other.m_resolver)), m_peerAddress(other.m_peerAddress),
+          m_peerAddressLength(other.m_peerAddressLength), m_handshakeSeconds(other.m_handshakeSeconds), m_bandwidthEstimate(other.m_bandwidthEstimate),
+          m_compressionLevel(other.m_compressionLevel), m_modeZ(other.m_modeZ), m_modeZRefused(other.m_modeZRefused),
+          m_modeZLevel(other.m_modeZLevel), m_pipelineTransfers(other.m_pipelineTransfers),
+          m_epsvConfirmed(other.m_epsvConfirmed), m_epsvRefused(other.m_epsvRefused),
+          m_listeners(std::move(other.m_listeners)), m_verifyActivePeer(other.m_verifyActivePeer),
+          m_replyHeld(other.m_replyHeld),
+          m_reply(std::move(other.m_reply))
     {
         other.m_socket = -1;
         other.m_connected = false;
+        other.m_replyHeld = false;
     }
 
     //! Move assignment
@@ -61,9 +86,41 @@ namespace ftp_library
             m_host = std::move(other.m_host);
             m_port = other.m_port;
             m_remoteDir = std::move(other.m_remoteDir);
+            m_replyReader = std::move(other.m_replyReader);
+            m_transferBufferSize = other.m_transferBufferSize;
+            m_zeroCopy = other.m_zeroCopy;
+            m_lastTransferStats = other.m_lastTransferStats;
+            m_username = std::move(other.m_username);
+            m_password = std::move(other.m_password);
+            m_binaryMode = other.m_binaryMode;
+            m_verbose = other.m_verbose;
+            m_retryPolicy = other.m_retryPolicy;
+            m_listingCache = std::move(other.m_listingCache);
+            m_metricsSink = std::move(other.m_metricsSink);
+            m_tracer = std::move(other.m_tracer);
+            m_bandwidthLimits = std::move(other.m_bandwidthLimits);
+            m_transferLimiter = std::move(other.m_transferLimiter);
+            m_socketOptions = other.m_socketOptions;
+            m_resolver = std::move(other.m_resolver);
+            m_peerAddress = other.m_peerAddress;
+            m_peerAddressLength = other.m_peerAddressLength;
+            m_handshakeSeconds = other.m_handshakeSeconds;
+            m_bandwidthEstimate = other.m_bandwidthEstimate;
+            m_compressionLevel = other.m_compressionLevel;
+            m_modeZ = other.m_modeZ;
+            m_modeZRefused = other.m_modeZRefused;
+            m_modeZLevel = other.m_modeZLevel;
+            m_pipelineTransfers = other.m_pipelineTransfers;
+            m_epsvConfirmed = other.m_epsvConfirmed;
+            m_epsvRefused = other.m_epsvRefused;
+            m_listeners = std::move(other.m_listeners);
+            m_verifyActivePeer = other.m_verifyActivePeer;
+            m_replyHeld = other.m_replyHeld;
+            m_reply = std::move(other.m_reply);
 
             other.m_socket = -1;
             other.m_connected = false;
+            other.m_replyHeld = false;
         }
         return *this;
     }
@@ -88,45 +145,180 @@ namespace ftp_library
 #endif
     }
 
+    //! Get the seconds elapsed since a point in time
+    static double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //! Set an integer socket option, ignoring failures (every option is a tuning hint)
+    static void SetIntOption(int socket, int level, int name, int value)
+    {
+        setsockopt(socket, level, name, reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    //! Apply the Nagle and keepalive settings to a socket
+    //@ param socket The socket
+    //@ param noDelay True to disable Nagle's algorithm
+    //@ param options The keepalive settings
+    static void ApplyTcpOptions(int socket, bool noDelay, const SocketOptions &options)
+    {
+        SetIntOption(socket, IPPROTO_TCP, TCP_NODELAY, noDelay ? 1 : 0);
+        SetIntOption(socket, SOL_SOCKET, SO_KEEPALIVE, options.keepAlive ? 1 : 0);
+        if (!options.keepAlive)
+        {
+            return;
+        }
+
+        //* Probe well inside typical NAT idle timeouts so long transfers keep the control mapping alive
+#if defined(TCP_KEEPIDLE)
+        SetIntOption(socket, IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(options.keepAliveIdle.count()));
+#elif defined(TCP_KEEPALIVE)
+        SetIntOption(socket, IPPROTO_TCP, TCP_KEEPALIVE, static_cast<int>(options.keepAliveIdle.count()));
+#endif
+#if defined(TCP_KEEPINTVL)
+        SetIntOption(socket, IPPROTO_TCP, TCP_KEEPINTVL, static_cast<int>(options.keepAliveInterval.count()));
+#endif
+#if defined(TCP_KEEPCNT)
+        SetIntOption(socket, IPPROTO_TCP, TCP_KEEPCNT, options.keepAliveProbes);
+#endif
+    }
+
+    //! Times one client operation and reports it to the sink and tracer when the scope ends
+    //! The operation failed if the scope is left through an exception. Without a
+    //! sink or tracer the scope only reads the clock once.
+    class OperationScope
+    {
+    public:
+        OperationScope(FTPMetricsSink *sink, FTPTracer *tracer, MetricsOperation operation, const std::string &host,
+                       uint16_t port, const std::string &path = "")
+            : m_sink(sink), m_span(tracer, "operation", MetricsOperationName(operation)),
+              m_exceptions(std::uncaught_exceptions()), m_start(std::chrono::steady_clock::now())
+        {
+            if (m_sink || m_span.Active())
+            {
+                m_metrics.operation = operation;
+                m_metrics.host = host + ":" + std::to_string(port);
+                m_metrics.path = path;
+            }
+        }
+
+        ~OperationScope()
+        {
+            m_metrics.success = std::uncaught_exceptions() == m_exceptions;
+            if (m_span.Active())
+            {
+                m_span.Arg("session", m_metrics.host);
+                if (!m_metrics.path.empty())
+                {
+                    m_span.Arg("path", m_metrics.path);
+                }
+                m_span.Arg("bytes", static_cast<int64_t>(m_metrics.bytes));
+                m_span.Arg("success", m_metrics.success ? 1 : 0);
+            }
+            if (!m_sink)
+            {
+                return;
+            }
+            m_metrics.seconds = SecondsSince(m_start);
+            try
+            {
+                m_sink->Record(m_metrics);
+            }
+            catch (...)
+            {
+                //* A failing sink must not turn into a failed transfer
+            }
+        }
+
+        OperationScope(const OperationScope &) = delete;
+        OperationScope &operator=(const OperationScope &) = delete;
+
+        //! Get the measurements being collected
+        OperationMetrics &Metrics()
+        {
+            return m_metrics;
+        }
+
+        //! Copy the data transfer figures into the measurements
+        //! @param stats The transfer loop statistics
+        void SetTransfer(const TransferStats &stats)
+        {
+            m_metrics.bytes = stats.bytes;
+            m_metrics.syscalls = stats.syscalls;
+            m_metrics.transferSeconds = stats.seconds;
+        }
+
+    private:
+        FTPMetricsSink *m_sink;                        //* Sink to report to, or null
+        FTPTraceSpan m_span;                           //* Operation span, inactive without a tracer
+        int m_exceptions;                              //* Uncaught exceptions when the scope began
+        std::chrono::steady_clock::time_point m_start; //* When the operation began
+        OperationMetrics m_metrics;                    //* Measurements being collected
+    };
+
     //! Connect to an FTP server
     //@ param host The hostname or IP address of the server
     //@ param port The port number to connect to (default is 21)
     void FTPClient::Connect(const std::string &host, uint16_t port)
     {
+        if (m_connected)
+        {
+            Disconnect();
+        }
+
         m_host = FTPUtilities::Trim(host);
         m_port = port;
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Connect, m_host, m_port);
 
-        addrinfo hints = {};
-        hints.ai_family = AF_INET;
-        hints.ai_socktype = SOCK_STREAM;
-        hints.ai_protocol = IPPROTO_TCP;
-
-        addrinfo *result = nullptr;
-        int res = getaddrinfo(m_host.c_str(), std::to_string(m_port).c_str(), &hints, &result);
-        if (res != 0 || result == nullptr)
-        {
-            throw FTPException("Failed to resolve server address.");
-        }
+        auto start = std::chrono::steady_clock::now();
+        FTPResolver::Addresses addresses = FTPResolver::Interleave(
+            m_resolver ? m_resolver->Resolve(m_host, m_port) : FTPResolver::SystemLookup(m_host, m_port));
 
-        m_socket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        auto handshake = std::chrono::steady_clock::now();
+        size_t winner = 0;
+        auto prepare = [this](int socket)
+        { ApplyTcpOptions(socket, m_socketOptions.controlNoDelay, m_socketOptions); };
+        m_socket = FTPResolver::ConnectFirst(addresses, m_socketOptions.connectAttemptDelay,
+                                             m_socketOptions.connectTimeout, prepare, &winner);
         if (m_socket < 0)
         {
-            freeaddrinfo(result);
-            throw FTPException("Failed to create socket.");
+            //* The cached addresses may be outdated; look the host up again next time
+            if (m_resolver)
+            {
+                m_resolver->Invalidate(m_host, m_port);
+            }
+            throw FTPException("Failed to connect to the server.");
         }
-
-        res = ::connect(m_socket, result->ai_addr, result->ai_addrlen);
-        freeaddrinfo(result);
-        if (res < 0)
+        auto connected = std::chrono::steady_clock::now();
+        if (winner > 0 && m_resolver)
         {
-            throw FTPException("Failed to connect to the server.");
+            //* Try the address that answered first next time, instead of waiting on the dead one again
+            m_resolver->Promote(m_host, m_port, addresses[winner]);
         }
+        m_peerAddress = addresses[winner].address;
+        m_peerAddressLength = addresses[winner].length;
+        m_handshakeSeconds = std::chrono::duration<double>(connected - handshake).count();
+        scope.Metrics().setupSeconds = std::chrono::duration<double>(connected - start).count();
+
+        m_replyReader->Reset();
+        m_binaryMode = false;
+        m_modeZ = false;
+        m_modeZRefused = false;
+        m_modeZLevel = 0;
+        m_epsvConfirmed = false;
+        m_epsvRefused = false;
+        m_replyHeld = false;
 
         std::string response = ReceiveResponse();
+        scope.Metrics().firstByteSeconds = SecondsSince(connected);
         response = FTPUtilities::Trim(response);
         m_connected = true;
         ValidateResponse(response, {220});
-        std::cout << "Connected to FTP server: " << m_host << std::endl;
+        if (m_verbose)
+        {
+            std::cout << "Connected to FTP server: " << m_host << std::endl;
+        }
     }
 
     //! Authenticate with username and password
@@ -134,14 +326,22 @@ namespace ftp_library
     //@ param password The password to authenticate with
     void FTPClient::Authenticate(const std::string &username, const std::string &password)
     {
-        SendCommand("USER " + FTPUtilities::Trim(username));
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Authenticate, m_host,
+                             m_port);
+
+        SendCommand("USER", username);
         std::string response = ReceiveResponse();
         ValidateResponse(response, {331});
 
-        SendCommand("PASS " + FTPUtilities::Trim(password));
+        SendCommand("PASS", password);
         response = ReceiveResponse();
         ValidateResponse(response, {230});
-        std::cout << "Authentication successful." << std::endl;
+        m_username = FTPUtilities::Trim(username);
+        m_password = FTPUtilities::Trim(password);
+        if (m_verbose)
+        {
+            std::cout << "Authentication successful." << std::endl;
+        }
     }
 
     //! Get a list of files and directories in the current working directory
@@ -149,46 +349,133 @@ namespace ftp_library
     //@ return A vector of strings containing the names of the files and directories
     std::vector<std::string> FTPClient::ListDirectory(const std::string &remoteDir)
     {
-        m_remoteDir = FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir);
-
-        SendCommand("PASV");
-        std::string response = ReceiveResponse();
-        ValidateResponse(response, {227});
+        std::string directory = FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir);
+        std::string resolvedDir = FTPListingCache::ResolvePath(m_remoteDir, directory);
+        std::string cacheHost = ServerKey();
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::List, m_host, m_port,
+                             resolvedDir);
 
-        auto [ip, port] = FTPUtilities::ParsePassiveModeResponse(response);
-        int dataSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (dataSocket < 0)
+        std::vector<std::string> cached;
+        FTPListingCache::State state = FTPListingCache::State::Miss;
+        if (m_listingCache)
         {
-            throw FTPException("Failed to create data socket.");
+            state = m_listingCache->Lookup(cacheHost, resolvedDir, cached);
+        }
+        bool refreshing = state == FTPListingCache::State::Stale && m_listingCache->BeginRefresh(cacheHost, resolvedDir);
+        if (state == FTPListingCache::State::Fresh || (state == FTPListingCache::State::Stale && !refreshing))
+        {
+            //* Fresh, or stale while another caller refreshes it
+            //* Keep the server's working directory where an uncached listing would leave it
+            if (resolvedDir != m_remoteDir)
+            {
+                SendCommand("CWD", FTPUtilities::ToLowerCase(directory));
+                ValidateResponse(ReceiveResponse(), {250});
+                m_remoteDir = resolvedDir;
+            }
+            return cached;
         }
 
-        sockaddr_in dataAddr{};
-        dataAddr.sin_family = AF_INET;
-        dataAddr.sin_port = htons(port);
-        inet_pton(AF_INET, ip.c_str(), &dataAddr.sin_addr);
-
-        if (::connect(dataSocket, (struct sockaddr *)&dataAddr, sizeof(dataAddr)) < 0)
+        try
         {
-            closesocket(dataSocket);
-            throw FTPException("Failed to connect to passive mode address.");
+            std::vector<std::string> entries = FetchListing(directory, scope.Metrics());
+            m_remoteDir = resolvedDir;
+            if (m_listingCache)
+            {
+                m_listingCache->Store(cacheHost, resolvedDir, entries);
+            }
+            return entries;
+        }
+        catch (const FTPException &e)
+        {
+            if (refreshing)
+            {
+                m_listingCache->CancelRefresh(cacheHost, resolvedDir);
+            }
+            if (state != FTPListingCache::State::Stale || !e.IsTransient())
+            {
+                throw;
+            }
+            //* Stale-if-error: an outdated listing beats none on a flaky link
+            return cached;
+        }
+        catch (...)
+        {
+            if (refreshing)
+            {
+                m_listingCache->CancelRefresh(cacheHost, resolvedDir);
+            }
+            throw;
         }
+    }
 
-        SendCommand("CWD " + FTPUtilities::ToLowerCase(m_remoteDir));
-        response = ReceiveResponse();
+    //! Run CWD and LIST and collect the listing lines
+    //@ param remoteDir The directory to list
+    //@ param metrics Receives the data setup, first byte and transfer figures
+    //@ return The listing lines
+    std::vector<std::string> FTPClient::FetchListing(const std::string &remoteDir, OperationMetrics &metrics)
+    {
+        bool compressed = SelectTransferMode(true);
+        SendCommand("CWD", FTPUtilities::ToLowerCase(remoteDir));
+        std::string response = ReceiveResponse();
         ValidateResponse(response, {250});
 
-        SendCommand("LIST");
-        response = ReceiveResponse();
-        ValidateResponse(response, {150});
+        auto start = std::chrono::steady_clock::now();
+        int dataSocket = OpenDataConnection("LIST");
+        metrics.setupSeconds = SecondsSince(start);
+
+        auto sent = std::chrono::steady_clock::now();
+        try
+        {
+            response = ReceiveResponse();
+            ValidateResponse(response, {125, 150});
+        }
+        catch (...)
+        {
+            closesocket(dataSocket);
+            throw;
+        }
 
         char buffer[1024];
         std::string directoryListing;
         ssize_t bytesRead;
+        FTPTraceSpan span(m_tracer.get(), "transfer", "LIST data");
+        auto loopStart = std::chrono::steady_clock::now();
 
-        while ((bytesRead = recv(dataSocket, buffer, sizeof(buffer) - 1, 0)) > 0)
+        std::unique_ptr<FTPInflater> inflater;
+        try
+        {
+            if (compressed)
+            {
+                inflater = std::make_unique<FTPInflater>();
+            }
+            while ((bytesRead = recv(dataSocket, buffer, sizeof(buffer) - 1, 0)) > 0)
+            {
+                if (metrics.bytes == 0)
+                {
+                    metrics.firstByteSeconds = SecondsSince(sent);
+                }
+                metrics.bytes += static_cast<uint64_t>(bytesRead);
+                ++metrics.syscalls;
+                if (inflater)
+                {
+                    inflater->Write(buffer, static_cast<size_t>(bytesRead), [&](const char *data, size_t size)
+                                    { directoryListing.append(data, size); });
+                }
+                else
+                {
+                    directoryListing.append(buffer, bytesRead);
+                }
+            }
+        }
+        catch (...)
         {
-            directoryListing.append(buffer, bytesRead);
+            AbortTransfer(dataSocket);
+            throw;
         }
+        ++metrics.syscalls;
+        metrics.transferSeconds = SecondsSince(loopStart);
+        span.Arg("bytes", static_cast<int64_t>(metrics.bytes));
+        span.End();
 
         closesocket(dataSocket);
 
@@ -198,66 +485,241 @@ namespace ftp_library
         return FTPUtilities::SplitString(directoryListing, '\n');
     }
 
-    //! Download a file from the server
-    //@ param remoteFilePath The path to the file on the server
-    //@ param localFilePath The path to save the file locally
-    void FTPClient::DownloadFile(const std::string &remoteFilePath, const std::string localFilePath)
+    //! Get the server as "host:port" for listing cache keys
+    std::string FTPClient::ServerKey() const
     {
-        std::string fileName = remoteFilePath.substr(remoteFilePath.find_last_of("/\\") + 1);
-        std::string resolvedPath = localFilePath.empty() ? "./" + fileName : localFilePath;
+        return m_host + ":" + std::to_string(m_port);
+    }
 
-        if (!FTPUtilities::EndsWith(resolvedPath, fileName))
+    //! Drop the cached listing of the directory containing a path
+    //@ param remotePath The changed file or directory, absolute or relative to the working directory
+    void FTPClient::InvalidateCachedParent(const std::string &remotePath)
+    {
+        if (m_listingCache)
         {
-            resolvedPath += "/" + fileName;
+            m_listingCache->InvalidateParent(ServerKey(), FTPListingCache::ResolvePath(m_remoteDir, remotePath));
         }
+    }
 
-        SendCommand("PASV");
-        std::string response = ReceiveResponse();
-        ValidateResponse(response, {227});
+    //! Limit the rate of each transfer made by this client
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    void FTPClient::SetTransferRateLimit(uint64_t bytesPerSecond)
+    {
+        if (!m_transferLimiter)
+        {
+            m_transferLimiter = std::make_shared<FTPRateLimiter>();
+        }
+        m_transferLimiter->SetRate(bytesPerSecond);
+    }
 
-        auto [ip, port] = FTPUtilities::ParsePassiveModeResponse(response);
-        int dataSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (dataSocket < 0)
+    //! Set the TCP options for the control and data connections
+    //@ param options The options to use
+    void FTPClient::SetSocketOptions(const SocketOptions &options)
+    {
+        if (options == m_socketOptions)
         {
-            throw FTPException("Failed to create data socket.");
+            return;
+        }
+        m_socketOptions = options;
+        if (m_socket >= 0)
+        {
+            ApplyTcpOptions(m_socket, m_socketOptions.controlNoDelay, m_socketOptions);
         }
+    }
 
-        sockaddr_in dataAddr{};
-        dataAddr.sin_family = AF_INET;
-        dataAddr.sin_port = htons(port);
-        inet_pton(AF_INET, ip.c_str(), &dataAddr.sin_addr);
+    //! Get the round trip time of the control connection
+    //@ return The kernel's smoothed RTT where available, else the handshake time, 0 if unknown
+    double FTPClient::RoundTripSeconds() const
+    {
+#if defined(__linux__)
+        tcp_info info{};
+        socklen_t length = sizeof(info);
+        if (m_socket >= 0 && getsockopt(m_socket, IPPROTO_TCP, TCP_INFO, &info, &length) == 0 && info.tcpi_rtt > 0)
+        {
+            return info.tcpi_rtt / 1e6;
+        }
+#endif
+        return m_handshakeSeconds;
+    }
 
-        if (::connect(dataSocket, (struct sockaddr *)&dataAddr, sizeof(dataAddr)) < 0)
+    //! Feed a finished transfer into the bandwidth estimate used to size data buffers
+    //@ param stats The transfer statistics
+    void FTPClient::RecordThroughput(const TransferStats &stats)
+    {
+        //* Short transfers end in slow start and say little about the path
+        if (stats.bytes < 1024 * 1024 || stats.seconds <= 0.0)
         {
-            closesocket(dataSocket);
-            throw FTPException("Failed to connect to passive mode address.");
+            return;
         }
+        double rate = stats.BytesPerSecond();
+        m_bandwidthEstimate = m_bandwidthEstimate > 0.0 ? (m_bandwidthEstimate + rate) / 2.0 : rate;
+    }
 
-        SendCommand("RETR " + FTPUtilities::Trim(remoteFilePath));
-        response = ReceiveResponse();
-        ValidateResponse(response, {150});
+    //! Collect the limiters the next transfer is charged to
+    //@ return The per-transfer, per-host and global limiters, or an empty throttle if no limit is configured
+    FTPThrottle FTPClient::MakeThrottle()
+    {
+        FTPThrottle throttle;
+        if (m_bandwidthLimits || (m_transferLimiter && m_transferLimiter->Rate() > 0))
+        {
+            //* Keep unlimited limiters too, so limits set mid-transfer take effect
+            throttle.Add(m_transferLimiter);
+            if (m_bandwidthLimits)
+            {
+                throttle.Add(m_bandwidthLimits->HostLimiter(m_host));
+                throttle.Add(m_bandwidthLimits->GlobalLimiter());
+            }
+        }
+        return throttle;
+    }
+
+    //! Stream a directory listing into a parser
+    //@ param remoteDir The directory to list
+    //@ param parser Receives the listing
+    void FTPClient::ListDirectory(const std::string &remoteDir, FTPListingParser &parser)
+    {
+        std::string directory = FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir);
+        bool machineListing = parser.GetFormat() == FTPListingParser::Format::MLSD;
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::List, m_host, m_port,
+                             directory);
+        OperationMetrics &metrics = scope.Metrics();
+        bool compressed = SelectTransferMode(true);
+
+        auto start = std::chrono::steady_clock::now();
+        int dataSocket = OpenDataConnection(machineListing ? "MLSD" : "LIST", directory);
+        metrics.setupSeconds = SecondsSince(start);
 
-        FILE *localFile = fopen(resolvedPath.c_str(), "wb");
-        if (!localFile)
+        auto sent = std::chrono::steady_clock::now();
+        std::string response;
+        try
+        {
+            response = ReceiveResponse();
+            ValidateResponse(response, {125, 150});
+        }
+        catch (...)
         {
             closesocket(dataSocket);
-            throw FTPException("Failed to open local file for writing: " + resolvedPath);
+            throw;
         }
 
-        char buffer[1024];
+        std::vector<char> buffer(m_transferBufferSize);
         ssize_t bytesRead;
-
-        while ((bytesRead = recv(dataSocket, buffer, sizeof(buffer), 0)) > 0)
+        FTPTraceSpan span(m_tracer.get(), "transfer", machineListing ? "MLSD data" : "LIST data");
+        auto loopStart = std::chrono::steady_clock::now();
+        std::unique_ptr<FTPInflater> inflater;
+        try
         {
-            fwrite(buffer, 1, bytesRead, localFile);
+            if (compressed)
+            {
+                inflater = std::make_unique<FTPInflater>();
+            }
+            while ((bytesRead = recv(dataSocket, buffer.data(), static_cast<int>(buffer.size()), 0)) > 0)
+            {
+                if (metrics.bytes == 0)
+                {
+                    metrics.firstByteSeconds = SecondsSince(sent);
+                }
+                metrics.bytes += static_cast<uint64_t>(bytesRead);
+                ++metrics.syscalls;
+                if (inflater)
+                {
+                    inflater->Write(buffer.data(), static_cast<size_t>(bytesRead),
+                                    [&](const char *data, size_t size) { parser.Feed(data, size); });
+                }
+                else
+                {
+                    parser.Feed(buffer.data(), static_cast<size_t>(bytesRead));
+                }
+            }
         }
+        catch (...)
+        {
+            AbortTransfer(dataSocket);
+            throw;
+        }
+        ++metrics.syscalls;
+        metrics.transferSeconds = SecondsSince(loopStart);
+        parser.Finish();
+        span.Arg("bytes", static_cast<int64_t>(metrics.bytes));
+        span.End();
 
-        fclose(localFile);
         closesocket(dataSocket);
 
         response = ReceiveResponse();
-        ValidateResponse(response, {226});
-        std::cout << "File downloaded successfully: " << resolvedPath << std::endl;
+        ValidateResponse(response, {226, 250});
+    }
+
+    //! Resolve the local destination for a download
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The requested local path or directory (may be empty)
+    //@ return The local file path to write to
+    static std::string ResolveLocalPath(const std::string &remoteFilePath, const std::string &localFilePath)
+    {
+        std::string fileName = remoteFilePath.substr(remoteFilePath.find_last_of("/\\") + 1);
+        std::string resolvedPath = localFilePath.empty() ? "./" + fileName : localFilePath;
+
+        if (!FTPUtilities::EndsWith(resolvedPath, fileName))
+        {
+            resolvedPath += "/" + fileName;
+        }
+        return resolvedPath;
+    }
+
+    //! Download a file from the server
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The path to save the file locally
+    void FTPClient::DownloadFile(const std::string &remoteFilePath, const std::string localFilePath)
+    {
+        std::string resolvedPath = ResolveLocalPath(remoteFilePath, localFilePath);
+        Retrieve(remoteFilePath, resolvedPath,
+                 [&](int dataSocket, FTPThrottle *throttle, bool inflate)
+                 {
+                     FILE *localFile = fopen(resolvedPath.c_str(), "wb");
+                     if (!localFile)
+                     {
+                         throw FTPException("Failed to open local file for writing: " + resolvedPath, -1);
+                     }
+
+                     TransferStats stats;
+                     try
+                     {
+                         if (inflate)
+                         {
+                             stats = FTPTransfer::ReceiveToSink(
+                                 dataSocket,
+                                 [localFile](const char *data, size_t size)
+                                 {
+                                     if (fwrite(data, 1, size, localFile) != size)
+                                     {
+                                         throw FTPException("Failed to write local file.", -1);
+                                     }
+                                 },
+                                 m_transferBufferSize, throttle, true);
+                         }
+                         else
+                         {
+                             stats = FTPTransfer::ReceiveToFile(dataSocket, localFile, m_transferBufferSize,
+                                                                m_zeroCopy, throttle);
+                         }
+                     }
+                     catch (...)
+                     {
+                         fclose(localFile);
+                         throw;
+                     }
+                     fclose(localFile);
+                     return stats;
+                 });
+    }
+
+    //! Download a file straight into a sink
+    //@ param remoteFilePath The path to the file on the server
+    //@ param sink Receives the file contents in order
+    void FTPClient::DownloadFile(const std::string &remoteFilePath, const DataSink &sink)
+    {
+        Retrieve(remoteFilePath, FTPUtilities::Trim(remoteFilePath),
+                 [&](int dataSocket, FTPThrottle *throttle, bool inflate)
+                 { return FTPTransfer::ReceiveToSink(dataSocket, sink, m_transferBufferSize, throttle, inflate); });
     }
 
     //! Upload a file to the server
@@ -265,113 +727,1486 @@ namespace ftp_library
     //@ param remoteFilePath The path to save the file on the server
     void FTPClient::UploadFile(const std::string &localFilePath, const std::string &remoteFilePath)
     {
-        SendCommand("PASV");
-        std::string response = ReceiveResponse();
-        ValidateResponse(response, {227});
+        Store(remoteFilePath,
+              [&](int dataSocket, FTPThrottle *throttle, int deflateLevel)
+              {
+                  FILE *localFile = fopen(localFilePath.c_str(), "rb");
+                  if (!localFile)
+                  {
+                      throw FTPException("Failed to open local file for reading: " + localFilePath, -1);
+                  }
 
-        auto [ip, port] = FTPUtilities::ParsePassiveModeResponse(response);
-        int dataSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (dataSocket < 0)
-        {
-            throw FTPException("Failed to create data socket.");
-        }
+                  TransferStats stats;
+                  try
+                  {
+                      if (deflateLevel > 0)
+                      {
+                          stats = FTPTransfer::SendFromSource(
+                              dataSocket,
+                              [localFile](char *buffer, size_t capacity)
+                              {
+                                  size_t bytesRead = fread(buffer, 1, capacity, localFile);
+                                  if (bytesRead == 0 && ferror(localFile))
+                                  {
+                                      throw FTPException("Failed to read local file.", -1);
+                                  }
+                                  return bytesRead;
+                              },
+                              m_transferBufferSize, throttle, deflateLevel);
+                      }
+                      else
+                      {
+                          stats = FTPTransfer::SendFromFile(dataSocket, localFile, m_transferBufferSize, m_zeroCopy,
+                                                            throttle);
+                      }
+                  }
+                  catch (...)
+                  {
+                      fclose(localFile);
+                      throw;
+                  }
+                  fclose(localFile);
+                  return stats;
+              });
+    }
 
-        sockaddr_in dataAddr{};
-        dataAddr.sin_family = AF_INET;
-        dataAddr.sin_port = htons(port);
-        inet_pton(AF_INET, ip.c_str(), &dataAddr.sin_addr);
+    //! Upload data pulled from a source
+    //@ param source Produces the file contents in order
+    //@ param remoteFilePath The path to save the file on the server
+    void FTPClient::UploadFile(const DataSource &source, const std::string &remoteFilePath)
+    {
+        Store(remoteFilePath,
+              [&](int dataSocket, FTPThrottle *throttle, int deflateLevel)
+              { return FTPTransfer::SendFromSource(dataSocket, source, m_transferBufferSize, throttle, deflateLevel); });
+    }
 
-        if (::connect(dataSocket, (struct sockaddr *)&dataAddr, sizeof(dataAddr)) < 0)
+    //! Close the data connection of a failed transfer and resynchronize the control connection
+    //! Whatever failed (local file, sink, source, data socket or inflater), the server still
+    //! sends a final reply for the transfer (226, 426 or 451); it is read here so the next
+    //! command does not get it. If the control connection cannot deliver it, the session is
+    //! closed rather than left out of step.
+    //@ param dataSocket The data socket to close
+    void FTPClient::AbortTransfer(int dataSocket)
+    {
+        closesocket(dataSocket);
+        try
         {
-            closesocket(dataSocket);
-            throw FTPException("Failed to connect to passive mode address.");
+            ReceiveResponse();
+        }
+        catch (const FTPException &)
+        {
+            //* The original failure is the one worth reporting
+            Disconnect();
         }
+    }
 
-        SendCommand("STOR " + FTPUtilities::ToLowerCase(remoteFilePath));
-        response = ReceiveResponse();
-        ValidateResponse(response, {150});
+    //! Run a RETR and hand the data connection to a receive loop
+    //@ param remoteFilePath The path to the file on the server
+    //@ param destination Where the data goes, for progress output
+    //@ param receive Copies the data connection to its destination
+    void FTPClient::Retrieve(const std::string &remoteFilePath, const std::string &destination,
+                             const ReceiveLoop &receive)
+    {
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Download, m_host, m_port,
+                             FTPUtilities::Trim(remoteFilePath));
+        bool compressed = SelectTransferMode(true);
 
-        FILE *localFile = fopen(localFilePath.c_str(), "rb");
-        if (!localFile)
+        auto start = std::chrono::steady_clock::now();
+        int dataSocket = OpenDataConnection("RETR", remoteFilePath);
+        scope.Metrics().setupSeconds = SecondsSince(start);
+
+        auto sent = std::chrono::steady_clock::now();
+        try
+        {
+            ValidateResponse(ReceiveResponse(), {125, 150});
+        }
+        catch (...)
         {
             closesocket(dataSocket);
-            throw FTPException("Failed to open local file for reading: " + localFilePath);
+            throw;
         }
 
-        char buffer[1024];
-        ssize_t bytesRead;
-
-        while ((bytesRead = fread(buffer, 1, sizeof(buffer), localFile)) > 0)
+        try
         {
-            if (send(dataSocket, buffer, bytesRead, 0) < 0)
+            FTPTraceSpan span(m_tracer.get(), "transfer", "RETR data");
+            auto loopStart = std::chrono::steady_clock::now();
+            FTPThrottle throttle = MakeThrottle();
+            m_lastTransferStats = receive(dataSocket, throttle.Empty() ? nullptr : &throttle, compressed);
+            span.Arg("bytes", static_cast<int64_t>(m_lastTransferStats.bytes));
+            span.Arg("syscalls", static_cast<int64_t>(m_lastTransferStats.syscalls));
+            span.End();
+            scope.SetTransfer(m_lastTransferStats);
+            RecordThroughput(m_lastTransferStats);
+            if (m_lastTransferStats.firstByteSeconds >= 0.0)
             {
-                fclose(localFile);
-                closesocket(dataSocket);
-                throw FTPException("Failed to send file data.");
+                scope.Metrics().firstByteSeconds =
+                    std::chrono::duration<double>(loopStart - sent).count() + m_lastTransferStats.firstByteSeconds;
             }
         }
+        catch (...)
+        {
+            AbortTransfer(dataSocket);
+            throw;
+        }
 
-        fclose(localFile);
         closesocket(dataSocket);
 
-        response = ReceiveResponse();
-        ValidateResponse(response, {226});
-        std::cout << "File uploaded successfully: " << remoteFilePath << std::endl;
+        ValidateResponse(ReceiveResponse(), {226});
+        if (m_verbose)
+        {
+            std::cout << "File downloaded successfully: " << destination << " (" << m_lastTransferStats.bytes
+                      << " bytes, " << FTPTransfer::FormatRate(m_lastTransferStats.BytesPerSecond()) << ")" << std::endl;
+        }
     }
 
-    //! Disconnect from the FTP server
-    void FTPClient::Disconnect()
+    //! Run a STOR and hand the data connection to a send loop
+    //@ param remoteFilePath The path to save the file on the server
+    //@ param send Copies the data from its origin to the data connection
+    void FTPClient::Store(const std::string &remoteFilePath, const SendLoop &send)
     {
-        if (m_connected)
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Upload, m_host, m_port,
+                             FTPUtilities::Trim(remoteFilePath));
+        int deflateLevel = SelectTransferMode(true) ? m_compressionLevel : 0;
+
+        auto start = std::chrono::steady_clock::now();
+        int dataSocket = OpenDataConnection("STOR", remoteFilePath);
+        scope.Metrics().setupSeconds = SecondsSince(start);
+
+        auto sent = std::chrono::steady_clock::now();
+        try
         {
-            SendCommand("QUIT");
-            closesocket(m_socket);
-            m_connected = false;
-            std::cout << "Disconnected from FTP server." << std::endl;
+            ValidateResponse(ReceiveResponse(), {125, 150});
+        }
+        catch (...)
+        {
+            closesocket(dataSocket);
+            throw;
+        }
+        scope.Metrics().firstByteSeconds = SecondsSince(sent);
+        InvalidateCachedParent(FTPUtilities::Trim(remoteFilePath));
+
+        try
+        {
+            FTPTraceSpan span(m_tracer.get(), "transfer", "STOR data");
+            FTPThrottle throttle = MakeThrottle();
+            m_lastTransferStats = send(dataSocket, throttle.Empty() ? nullptr : &throttle, deflateLevel);
+            span.Arg("bytes", static_cast<int64_t>(m_lastTransferStats.bytes));
+            span.Arg("syscalls", static_cast<int64_t>(m_lastTransferStats.syscalls));
+            span.End();
+            scope.SetTransfer(m_lastTransferStats);
+            RecordThroughput(m_lastTransferStats);
+        }
+        catch (...)
+        {
+            AbortTransfer(dataSocket);
+            throw;
+        }
+
+        closesocket(dataSocket);
+
+        const std::string &response = ReceiveResponse();
+        //* Listed again by another client while the data was in flight
+        InvalidateCachedParent(FTPUtilities::Trim(remoteFilePath));
+        ValidateResponse(response, {226});
+        if (m_verbose)
+        {
+            std::cout << "File uploaded successfully: " << remoteFilePath << " (" << m_lastTransferStats.bytes
+                      << " bytes, " << FTPTransfer::FormatRate(m_lastTransferStats.BytesPerSecond()) << ")" << std::endl;
         }
     }
 
-    //! Send a command to the server
-    //@ param command The command to send
-    void FTPClient::SendCommand(const std::string &command)
+    //! Send a NOOP to check that the control connection is alive
+    void FTPClient::Noop()
+    {
+        SendCommand("NOOP");
+        ValidateResponse(ReceiveResponse(), {200});
+    }
+
+    //! Create a directory on the server
+    //@ param remoteDir The directory to create
+    void FTPClient::MakeDirectory(const std::string &remoteDir)
+    {
+        SendCommand("MKD", remoteDir);
+        std::string response = ReceiveResponse();
+        ValidateResponse(response, {257});
+        InvalidateCachedParent(FTPUtilities::Trim(remoteDir));
+    }
+
+    //! Get the size of a remote file
+    //@ param remoteFilePath The path to the file on the server
+    //@ return The file size in bytes
+    uint64_t FTPClient::GetFileSize(const std::string &remoteFilePath)
     {
-        std::string commandWithCRLF = FTPUtilities::Trim(command) + "\r\n";
-        if (send(m_socket, commandWithCRLF.c_str(), commandWithCRLF.size(), 0) < 0)
+        SetBinaryMode();
+
+        SendCommand("SIZE", remoteFilePath);
+        const std::string &response = ReceiveResponse();
+        ValidateResponse(response, {213});
+
+        uint64_t size = 0;
+        std::string_view digits = FTPResponseParser::MessageView(response);
+        if (std::from_chars(digits.data(), digits.data() + digits.size(), size).ec != std::errc())
         {
-            throw FTPException("Failed to send command: " + command);
+            throw FTPException("Invalid SIZE response: " + response, 213);
         }
+        return size;
     }
 
-    //! Receive and return server response
-    //@ return The server response
-    std::string FTPClient::ReceiveResponse()
+    //! Get the modification time of a remote file (MDTM)
+    //@ param remoteFilePath The path to the file on the server
+    //@ return UTC seconds since the epoch
+    int64_t FTPClient::GetModificationTime(const std::string &remoteFilePath)
     {
-        char buffer[1024];
-        ssize_t bytesRead = recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-        if (bytesRead < 0)
+        SendCommand("MDTM", remoteFilePath);
+        const std::string &response = ReceiveResponse();
+        ValidateResponse(response, {213});
+
+        int64_t mtime = FTPListingParser::ParseTimestamp(FTPResponseParser::MessageView(response));
+        if (mtime < 0)
         {
-            throw FTPException("Failed to receive response.");
+            throw FTPException("Invalid MDTM response: " + response, 213);
         }
-        std::string response(buffer, bytesRead);
-        return FTPUtilities::Trim(response);
+        return mtime;
     }
 
-    //! Validate server response
-    //@ param response The server response
-    //@ param expectedCodes The expected response codes
-    void FTPClient::ValidateResponse(const std::string &response, const std::vector<int> &expectedCodes)
+    //! Download a file over several parallel connections
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The path to save the file locally
+    //@ param segments The number of parallel connections to use
+    void FTPClient::DownloadFileSegmented(const std::string &remoteFilePath, const std::string &localFilePath,
+                                          unsigned segments)
     {
-        auto [code, message] = FTPResponseParser::ParseResponse(response);
+#if defined(_WIN32) || defined(_WIN64)
+        //* No pwrite on Winsock builds, use the single stream path
+        segments = 1;
+#endif
+        uint64_t fileSize = GetFileSize(remoteFilePath);
 
-        if (!FTPResponseParser::IsExpectedCode(response, code))
+        //* Small files are not worth the extra connection setup
+        const uint64_t minSegmentSize = 1024 * 1024;
+        if (segments > fileSize / minSegmentSize)
         {
-            throw FTPException("Unexpected response code: " + std::to_string(code) + " - " + message);
+            segments = static_cast<unsigned>(fileSize / minSegmentSize);
+        }
+        if (segments <= 1)
+        {
+            DownloadFile(remoteFilePath, localFilePath);
+            return;
         }
 
-        if (std::find(expectedCodes.begin(), expectedCodes.end(), code) == expectedCodes.end())
+#if !defined(_WIN32) && !defined(_WIN64)
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Download, m_host, m_port,
+                             FTPUtilities::Trim(remoteFilePath));
+        std::string resolvedPath = ResolveLocalPath(remoteFilePath, localFilePath);
+
+        int fd = open(resolvedPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
         {
-            throw FTPException("Unexpected response code: " + std::to_string(code) + " - " + message);
+            throw FTPException("Failed to open local file for writing: " + resolvedPath, -1);
         }
+
+        //* Preallocate so the segments never extend the file concurrently
+#if defined(__linux__)
+        int allocated = posix_fallocate(fd, 0, static_cast<off_t>(fileSize));
+#else
+        int allocated = ftruncate(fd, static_cast<off_t>(fileSize));
+#endif
+        if (allocated != 0)
+        {
+            close(fd);
+            throw FTPException("Failed to preallocate local file: " + resolvedPath, -1);
+        }
+
+        uint64_t segmentSize = fileSize / segments;
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(segments);
+        std::vector<TransferStats> segmentStats(segments);
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned i = 0; i < segments; ++i)
+        {
+            uint64_t offset = i * segmentSize;
+            uint64_t length = (i == segments - 1) ? fileSize - offset : segmentSize;
+
+            workers.emplace_back([this, i, offset, length, fd, &remoteFilePath, &resolvedPath, &errors,
+                                  &segmentStats]()
+                                 {
+                                     try
+                                     {
+                                         FTPClient worker;
+                                         worker.SetVerbose(false);
+                                         worker.SetTransferBufferSize(m_transferBufferSize);
+                                         worker.SetTracer(m_tracer);
+                                         worker.SetBandwidthLimits(m_bandwidthLimits);
+                                         worker.m_transferLimiter = m_transferLimiter; //* Segments share one transfer limit
+                                         worker.SetResolver(m_resolver);
+                                         worker.SetSocketOptions(m_socketOptions);
+                                         worker.SetTransferPipelining(m_pipelineTransfers);
+                                         worker.SetActiveMode(m_listeners, m_verifyActivePeer);
+                                         worker.Connect(m_host, m_port);
+                                         worker.Authenticate(m_username, m_password);
+                                         worker.m_epsvConfirmed = m_epsvConfirmed; //* Same server, pipeline at once
+                                         segmentStats[i] = worker.DownloadRange(remoteFilePath, fd, resolvedPath,
+                                                                                offset, length);
+                                     }
+                                     catch (...)
+                                     {
+                                         errors[i] = std::current_exception();
+                                     } });
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        close(fd);
+
+        for (const auto &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        m_lastTransferStats = TransferStats();
+        for (const auto &stats : segmentStats)
+        {
+            m_lastTransferStats.bytes += stats.bytes;
+            m_lastTransferStats.syscalls += stats.syscalls;
+        }
+        m_lastTransferStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        scope.SetTransfer(m_lastTransferStats);
+
+        if (m_verbose)
+        {
+            std::cout << "File downloaded successfully: " << resolvedPath << " (" << m_lastTransferStats.bytes
+                      << " bytes in " << segments << " segments, "
+                      << FTPTransfer::FormatRate(m_lastTransferStats.BytesPerSecond()) << ")" << std::endl;
+        }
+#endif
+    }
+
+    //! Bytes received or sent between checkpoint updates
+    static constexpr uint64_t kCheckpointInterval = 8 * 1024 * 1024;
+
+    //! Sidecar state of a resumable transfer
+    struct TransferCheckpoint
+    {
+        std::string remotePath; //* Remote file the checkpoint belongs to
+        uint64_t size = 0;      //* Size of the source file when the transfer started
+        int64_t mtime = -1;     //* Modification time of the source file, -1 if unknown
+        uint64_t offset = 0;    //* Confirmed bytes at the destination
+    };
+
+    //! Get the sidecar path for a local file
+    static std::string CheckpointPath(const std::string &localFilePath)
+    {
+        return localFilePath + ".ftpckpt";
+    }
+
+    //! Read a checkpoint sidecar
+    //@ param localFilePath The local file the checkpoint belongs to
+    //@ param checkpoint Receives the checkpoint
+    //@ return True if a well-formed checkpoint exists
+    static bool ReadCheckpoint(const std::string &localFilePath, TransferCheckpoint &checkpoint)
+    {
+        FILE *file = fopen(CheckpointPath(localFilePath).c_str(), "rb");
+        if (!file)
+        {
+            return false;
+        }
+
+        char buffer[4096];
+        std::string text;
+        size_t bytesRead;
+        while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            text.append(buffer, bytesRead);
+        }
+        fclose(file);
+
+        auto lines = FTPUtilities::SplitString(text, '\n');
+        if (lines.size() < 5 || lines[0] != "ftp-checkpoint v1")
+        {
+            return false;
+        }
+        checkpoint.remotePath = lines[1];
+        checkpoint.size = std::strtoull(lines[2].c_str(), nullptr, 10);
+        checkpoint.mtime = std::strtoll(lines[3].c_str(), nullptr, 10);
+        checkpoint.offset = std::strtoull(lines[4].c_str(), nullptr, 10);
+        return true;
+    }
+
+    //! Write a checkpoint sidecar (temporary file plus rename)
+    //@ param localFilePath The local file the checkpoint belongs to
+    //@ param checkpoint The checkpoint to write
+    static void WriteCheckpoint(const std::string &localFilePath, const TransferCheckpoint &checkpoint)
+    {
+        std::string path = CheckpointPath(localFilePath);
+        std::string temporary = path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            return; //* Resuming is best effort; the transfer itself can go on
+        }
+        fprintf(file, "ftp-checkpoint v1\n%s\n%llu\n%lld\n%llu\n", checkpoint.remotePath.c_str(),
+                static_cast<unsigned long long>(checkpoint.size), static_cast<long long>(checkpoint.mtime),
+                static_cast<unsigned long long>(checkpoint.offset));
+        bool ok = fclose(file) == 0;
+
+        std::error_code error;
+        if (ok)
+        {
+            std::filesystem::rename(temporary, path, error);
+        }
+    }
+
+    //! Position a stream at a 64-bit offset
+    static void SeekFile(FILE *file, uint64_t offset)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        int res = _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#else
+        int res = fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+        if (res != 0)
+        {
+            throw FTPException("Failed to seek local file.", -1);
+        }
+    }
+
+    //! Delete a checkpoint sidecar
+    static void RemoveCheckpoint(const std::string &localFilePath)
+    {
+        std::error_code error;
+        std::filesystem::remove(CheckpointPath(localFilePath), error);
+    }
+
+    //! Download a file, resuming with REST after dropped connections
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The path to save the file locally
+    void FTPClient::DownloadFileResumable(const std::string &remoteFilePath, const std::string &localFilePath)
+    {
+        std::string remotePath = FTPUtilities::Trim(remoteFilePath);
+        std::string resolvedPath = ResolveLocalPath(remotePath, localFilePath);
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Download, m_host, m_port,
+                             remotePath);
+        TransferStats total;
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned attempt = 1;; ++attempt)
+        {
+            FILE *localFile = nullptr;
+            int dataSocket = -1;
+            bool replyPending = false;
+            TransferCheckpoint current;
+            try
+            {
+                if (!m_connected)
+                {
+                    Reconnect();
+                }
+
+                current.remotePath = remotePath;
+                current.size = GetFileSize(remotePath);
+                try
+                {
+                    current.mtime = GetModificationTime(remotePath);
+                }
+                catch (const FTPException &e)
+                {
+                    if (e.Code() == 0)
+                    {
+                        throw;
+                    }
+                    //* MDTM is optional; the size alone has to identify the file
+                }
+
+                //* Resume only when the checkpoint describes this exact remote file
+                TransferCheckpoint saved;
+                std::error_code error;
+                uint64_t localSize = std::filesystem::file_size(resolvedPath, error);
+                if (!error && ReadCheckpoint(resolvedPath, saved) && saved.remotePath == current.remotePath &&
+                    saved.size == current.size && saved.mtime == current.mtime)
+                {
+                    current.offset = std::min(saved.offset, localSize);
+                }
+
+                localFile = fopen(resolvedPath.c_str(), current.offset > 0 ? "r+b" : "wb");
+                if (!localFile)
+                {
+                    throw FTPException("Failed to open local file for writing: " + resolvedPath, -1);
+                }
+                if (current.offset > 0)
+                {
+                    //* Drop anything written after the last confirmed offset
+                    std::filesystem::resize_file(resolvedPath, current.offset);
+                    SeekFile(localFile, current.offset);
+                }
+                WriteCheckpoint(resolvedPath, current);
+
+                if (current.offset < current.size || current.size == 0)
+                {
+                    SelectTransferMode(false);
+                    dataSocket = OpenDataConnection("RETR", remotePath, current.offset);
+                    ValidateResponse(ReceiveResponse(), {125, 150});
+                    replyPending = true;
+
+                    std::vector<char> buffer(m_transferBufferSize);
+                    uint64_t sinceCheckpoint = 0;
+                    FTPThrottle throttle = MakeThrottle();
+                    FTPTraceSpan span(m_tracer.get(), "transfer", "RETR data");
+                    span.Arg("offset", static_cast<int64_t>(current.offset));
+                    while (true)
+                    {
+                        size_t wanted = throttle.Empty() ? buffer.size() : throttle.ChunkLimit(buffer.size());
+                        ssize_t bytesRead = recv(dataSocket, buffer.data(), static_cast<int>(wanted), 0);
+                        ++total.syscalls;
+                        if (bytesRead == 0)
+                        {
+                            break;
+                        }
+                        if (bytesRead < 0)
+                        {
+                            throw FTPException("Failed to receive file data.");
+                        }
+                        if (fwrite(buffer.data(), 1, bytesRead, localFile) != static_cast<size_t>(bytesRead))
+                        {
+                            throw FTPException("Failed to write local file: " + resolvedPath, -1);
+                        }
+                        current.offset += bytesRead;
+                        total.bytes += bytesRead;
+                        sinceCheckpoint += bytesRead;
+                        if (!throttle.Empty())
+                        {
+                            throttle.Consume(bytesRead);
+                        }
+                        if (sinceCheckpoint >= kCheckpointInterval)
+                        {
+                            fflush(localFile);
+                            WriteCheckpoint(resolvedPath, current);
+                            sinceCheckpoint = 0;
+                        }
+                    }
+                    span.End();
+
+                    closesocket(dataSocket);
+                    dataSocket = -1;
+                    replyPending = false;
+                    ValidateResponse(ReceiveResponse(), {226, 250});
+                }
+
+                fclose(localFile);
+                RemoveCheckpoint(resolvedPath);
+                break;
+            }
+            catch (const FTPException &e)
+            {
+                bool retry = e.IsTransient() && attempt < m_retryPolicy.maxAttempts;
+                if (dataSocket >= 0 && replyPending && !retry)
+                {
+                    //* Not reconnecting, so the session must be left in step
+                    AbortTransfer(dataSocket);
+                }
+                else if (dataSocket >= 0)
+                {
+                    closesocket(dataSocket);
+                }
+                if (localFile)
+                {
+                    fflush(localFile);
+                    if (current.offset > 0)
+                    {
+                        WriteCheckpoint(resolvedPath, current);
+                    }
+                    fclose(localFile);
+                }
+                if (!retry)
+                {
+                    throw;
+                }
+
+                if (m_verbose)
+                {
+                    std::cout << "Download interrupted (" << e.what() << "), retrying at byte " << current.offset
+                              << "..." << std::endl;
+                }
+                std::this_thread::sleep_for(m_retryPolicy.DelayAfter(attempt));
+                try
+                {
+                    Reconnect();
+                }
+                catch (const FTPException &)
+                {
+                    //* Counted as the next attempt's failure
+                    m_connected = false;
+                }
+            }
+        }
+
+        total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m_lastTransferStats = total;
+        scope.SetTransfer(total);
+        if (m_verbose)
+        {
+            std::cout << "File downloaded successfully: " << resolvedPath << " (" << total.bytes << " bytes, "
+                      << FTPTransfer::FormatRate(total.BytesPerSecond()) << ")" << std::endl;
+        }
+    }
+
+    //! Upload a file, resuming with APPE after dropped connections
+    //@ param localFilePath The path to the file to upload
+    //@ param remoteFilePath The path to save the file on the server
+    void FTPClient::UploadFileResumable(const std::string &localFilePath, const std::string &remoteFilePath)
+    {
+        std::string remotePath = FTPUtilities::Trim(remoteFilePath);
+        OperationScope scope(m_metricsSink.get(), m_tracer.get(), MetricsOperation::Upload, m_host, m_port,
+                             remotePath);
+        TransferStats total;
+        auto start = std::chrono::steady_clock::now();
+
+        std::error_code error;
+        TransferCheckpoint current;
+        current.remotePath = remotePath;
+        current.size = std::filesystem::file_size(localFilePath, error);
+        if (error)
+        {
+            throw FTPException("Failed to open local file for reading: " + localFilePath, -1);
+        }
+        current.mtime = static_cast<int64_t>(std::filesystem::last_write_time(localFilePath, error).time_since_epoch().count());
+
+        TransferCheckpoint saved;
+        bool resumable = ReadCheckpoint(localFilePath, saved) && saved.remotePath == current.remotePath &&
+                         saved.size == current.size && saved.mtime == current.mtime;
+
+        for (unsigned attempt = 1;; ++attempt)
+        {
+            FILE *localFile = nullptr;
+            int dataSocket = -1;
+            bool replyPending = false;
+            try
+            {
+                if (!m_connected)
+                {
+                    Reconnect();
+                }
+
+                //* The server's copy is the only confirmed offset for an upload
+                current.offset = 0;
+                if (resumable)
+                {
+                    try
+                    {
+                        current.offset = std::min(GetFileSize(remotePath), current.size);
+                    }
+                    catch (const FTPException &e)
+                    {
+                        if (e.Code() == 0)
+                        {
+                            throw;
+                        }
+                    }
+                }
+                WriteCheckpoint(localFilePath, current);
+                resumable = true;
+                //* Bytes lost with the dropped connection do not count
+                total.bytes = current.offset;
+
+                localFile = fopen(localFilePath.c_str(), "rb");
+                if (!localFile)
+                {
+                    throw FTPException("Failed to open local file for reading: " + localFilePath, -1);
+                }
+                SeekFile(localFile, current.offset);
+
+                SetBinaryMode();
+                SelectTransferMode(false);
+                dataSocket = OpenDataConnection(current.offset > 0 ? "APPE" : "STOR", remotePath);
+                ValidateResponse(ReceiveResponse(), {125, 150});
+                replyPending = true;
+                InvalidateCachedParent(remotePath);
+
+                std::vector<char> buffer(m_transferBufferSize);
+                size_t bytesRead;
+                FTPThrottle throttle = MakeThrottle();
+                FTPTraceSpan span(m_tracer.get(), "transfer", current.offset > 0 ? "APPE data" : "STOR data");
+                span.Arg("offset", static_cast<int64_t>(current.offset));
+                while ((bytesRead = fread(buffer.data(), 1, buffer.size(), localFile)) > 0)
+                {
+                    FTPTransfer::SendAll(dataSocket, buffer.data(), bytesRead, total,
+                                         throttle.Empty() ? nullptr : &throttle);
+                }
+                span.End();
+                if (ferror(localFile))
+                {
+                    throw FTPException("Failed to read local file: " + localFilePath, -1);
+                }
+
+                fclose(localFile);
+                localFile = nullptr;
+                closesocket(dataSocket);
+                dataSocket = -1;
+                replyPending = false;
+                std::string response = ReceiveResponse();
+                InvalidateCachedParent(remotePath);
+                ValidateResponse(response, {226, 250});
+
+                RemoveCheckpoint(localFilePath);
+                break;
+            }
+            catch (const FTPException &e)
+            {
+                bool retry = e.IsTransient() && attempt < m_retryPolicy.maxAttempts;
+                if (dataSocket >= 0 && replyPending && !retry)
+                {
+                    //* Not reconnecting, so the session must be left in step
+                    AbortTransfer(dataSocket);
+                }
+                else if (dataSocket >= 0)
+                {
+                    closesocket(dataSocket);
+                }
+                if (localFile)
+                {
+                    fclose(localFile);
+                }
+                if (!retry)
+                {
+                    throw;
+                }
+
+                if (m_verbose)
+                {
+                    std::cout << "Upload interrupted (" << e.what() << "), retrying..." << std::endl;
+                }
+                std::this_thread::sleep_for(m_retryPolicy.DelayAfter(attempt));
+                try
+                {
+                    Reconnect();
+                }
+                catch (const FTPException &)
+                {
+                    m_connected = false;
+                }
+            }
+        }
+
+        total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m_lastTransferStats = total;
+        scope.SetTransfer(total);
+        if (m_verbose)
+        {
+            std::cout << "File uploaded successfully: " << remotePath << " (" << total.bytes << " bytes, "
+                      << FTPTransfer::FormatRate(total.BytesPerSecond()) << ")" << std::endl;
+        }
+    }
+
+    //! Disconnect from the FTP server
+    void FTPClient::Disconnect()
+    {
+        if (m_connected)
+        {
+            try
+            {
+                SendCommand("QUIT");
+            }
+            catch (const FTPException &)
+            {
+                //* The connection is already gone, just release the socket
+            }
+            closesocket(m_socket);
+            m_socket = -1;
+            m_connected = false;
+            if (m_verbose)
+            {
+                std::cout << "Disconnected from FTP server." << std::endl;
+            }
+        }
+    }
+
+    //! Most pipelined commands in flight at once; bounds what either side must buffer
+    static constexpr size_t kPipelineWindow = 256;
+
+    //! Append one command line to a pipelined batch
+    //@ param batch The batch being built
+    //@ param verb The command verb, including any separating space
+    //@ param argument The command argument, trimmed before it is appended
+    static void AppendCommandLine(std::string &batch, std::string_view verb, std::string_view argument)
+    {
+        argument = FTPUtilities::TrimView(argument);
+        batch.append(verb.data(), verb.size());
+        batch.append(argument.data(), argument.size());
+        batch += "\r\n";
+    }
+
+    //! Send commands back-to-back within the pipeline window and hand each reply over in order
+    //@ param count The number of commands
+    //@ param appendCommand Called as (index, batch) to append command `index` to the batch
+    //@ param handleReply Called as (index, reply) for each reply; the reply is only valid during the call
+    template <typename AppendCommand, typename HandleReply>
+    void FTPClient::RunPipeline(size_t count, AppendCommand appendCommand, HandleReply handleReply)
+    {
+        FTPTraceSpan span(m_tracer.get(), "control", "pipeline");
+        span.Arg("commands", static_cast<int64_t>(count));
+
+        size_t sent = 0;
+        for (size_t received = 0; received < count; ++received)
+        {
+            //* Top the window up once half of it has been answered
+            if (sent < count && sent - received <= kPipelineWindow / 2)
+            {
+                m_commandBuffer.clear();
+                size_t last = std::min(count, received + kPipelineWindow);
+                for (; sent < last; ++sent)
+                {
+                    appendCommand(sent, m_commandBuffer);
+                }
+
+                TransferStats stats;
+                try
+                {
+                    FTPTransfer::SendAll(m_socket, m_commandBuffer.data(), m_commandBuffer.size(), stats);
+                }
+                catch (const FTPException &)
+                {
+                    throw FTPException("Failed to send pipelined commands.");
+                }
+            }
+
+            handleReply(received, ReceiveResponse());
+        }
+    }
+
+    //! Send several commands back-to-back and collect their replies in order
+    //@ param commands The commands to send (without CRLF)
+    //@ return The server reply for each command, in the same order
+    std::vector<std::string> FTPClient::ExecutePipelined(const std::vector<std::string> &commands)
+    {
+        std::vector<std::string> replies;
+        replies.reserve(commands.size());
+        RunPipeline(
+            commands.size(),
+            [&](size_t index, std::string &batch)
+            { AppendCommandLine(batch, {}, commands[index]); },
+            [&](size_t, const std::string &reply)
+            { replies.push_back(reply); });
+        return replies;
+    }
+
+    //! Run a batch of SIZE/MDTM queries over one pipelined exchange
+    //@ param queries The queries to run
+    //@ return The outcome of each query, in the same order
+    std::vector<MetadataResult> FTPClient::QueryMetadata(const std::vector<MetadataQuery> &queries)
+    {
+        std::vector<MetadataResult> results(queries.size());
+        RunPipeline(
+            queries.size(),
+            [&](size_t index, std::string &batch)
+            {
+                AppendCommandLine(batch, queries[index].command == MetadataCommand::Size ? "SIZE " : "MDTM ",
+                                  queries[index].path);
+            },
+            [&](size_t index, const std::string &reply)
+            {
+                MetadataResult &result = results[index];
+                result.code = std::max(FTPResponseParser::ParseCode(reply), 0);
+                std::string_view message = FTPResponseParser::MessageView(reply);
+                result.message.assign(message.data(), message.size());
+                if (!result.Ok())
+                {
+                    return;
+                }
+
+                if (queries[index].command == MetadataCommand::Size)
+                {
+                    std::from_chars(message.data(), message.data() + message.size(), result.size);
+                }
+                else
+                {
+                    result.mtime = FTPListingParser::ParseTimestamp(message);
+                }
+            });
+        return results;
+    }
+
+    //! Open a data connection and send the transfer command that will use it
+    //! Passive mode uses EPSV unless the server refused it (PASV cannot carry IPv6 addresses).
+    //! With pipelining on and EPSV known to work, EPSV, REST and the command go out in one write.
+    //@ param verb The transfer command, e.g. RETR, STOR, APPE, LIST or MLSD
+    //@ param argument The argument of the transfer command, may be empty
+    //@ param restartOffset Offset sent with REST before the command, 0 for none
+    //@ return The connected data socket; the caller reads the command's 125/150 reply
+    int FTPClient::OpenDataConnection(std::string_view verb, std::string_view argument, uint64_t restartOffset)
+    {
+        FTPTraceSpan span(m_tracer.get(), "data", "data connect");
+        bool extended = m_peerAddress.ss_family == AF_INET6 || !m_epsvRefused;
+        char offset[24] = {};
+        if (restartOffset > 0)
+        {
+            std::to_chars(offset, offset + sizeof(offset) - 1, restartOffset);
+        }
+        if (m_listeners)
+        {
+            return OpenActiveDataConnection(verb, argument, offset);
+        }
+
+        //* Created up front, so only the handshake is left once the reply names the port
+        int dataSocket = CreateDataSocket(extended ? m_peerAddress.ss_family : AF_INET);
+        try
+        {
+            if (extended && m_epsvConfirmed && m_pipelineTransfers)
+            {
+                m_commandBuffer.assign("EPSV\r\n");
+                if (restartOffset > 0)
+                {
+                    AppendCommandLine(m_commandBuffer, "REST ", offset);
+                }
+                m_commandBuffer.append(verb.data(), verb.size());
+                argument = FTPUtilities::TrimView(argument);
+                if (!argument.empty())
+                {
+                    m_commandBuffer += ' ';
+                }
+                AppendCommandLine(m_commandBuffer, {}, argument);
+
+                FTPTraceSpan sendSpan(m_tracer.get(), "control", "pipeline");
+                sendSpan.Arg("commands", static_cast<int64_t>(restartOffset > 0 ? 3 : 2));
+                TransferStats stats;
+                try
+                {
+                    FTPTransfer::SendAll(m_socket, m_commandBuffer.data(), m_commandBuffer.size(), stats);
+                }
+                catch (const FTPException &)
+                {
+                    throw FTPException("Failed to send command: EPSV");
+                }
+
+                const std::string &response = ReceiveResponse();
+                if (!FTPResponseParser::IsExpectedCode(response, 229))
+                {
+                    //* The command behind it was answered without a data connection; skip its replies
+                    std::string refusal = response;
+                    if (restartOffset > 0)
+                    {
+                        ReceiveResponse();
+                    }
+                    DrainTransferReplies();
+                    ValidateResponse(refusal, {229});
+                }
+                try
+                {
+                    ConnectDataSocket(dataSocket, ExtendedPassiveAddress(response));
+                }
+                catch (...)
+                {
+                    //* The server is left waiting on this connection with the command queued; start over
+                    Disconnect();
+                    throw;
+                }
+                if (restartOffset > 0 && !FTPResponseParser::IsExpectedCode(ReceiveResponse(), 350))
+                {
+                    //* Without the offset the server may already be sending from the start
+                    std::string refusal = m_reply;
+                    closesocket(dataSocket);
+                    dataSocket = -1;
+                    DrainTransferReplies();
+                    ValidateResponse(refusal, {350});
+                }
+                return dataSocket;
+            }
+
+            ResolvedAddress dataAddress;
+            if (extended)
+            {
+                SendCommand("EPSV");
+                const std::string &response = ReceiveResponse();
+                int code = FTPResponseParser::ParseCode(response);
+                if (code == 229)
+                {
+                    m_epsvConfirmed = true;
+                    dataAddress = ExtendedPassiveAddress(response);
+                }
+                else if (m_peerAddress.ss_family == AF_INET && code >= 500 && code < 600)
+                {
+                    //* Not implemented or not understood: fall back to PASV for the rest of the session
+                    m_epsvRefused = true;
+                    extended = false;
+                }
+                else
+                {
+                    ValidateResponse(response, {229});
+                }
+            }
+            if (!extended)
+            {
+                SendCommand("PASV");
+                std::string response = ReceiveResponse();
+                ValidateResponse(response, {227});
+
+                auto [ip, port] = FTPUtilities::ParsePassiveModeResponse(response);
+                auto *dataAddr = reinterpret_cast<sockaddr_in *>(&dataAddress.address);
+                dataAddr->sin_family = AF_INET;
+                dataAddr->sin_port = htons(port);
+                inet_pton(AF_INET, ip.c_str(), &dataAddr->sin_addr);
+                dataAddress.length = sizeof(sockaddr_in);
+            }
+            ConnectDataSocket(dataSocket, dataAddress);
+
+            if (restartOffset > 0)
+            {
+                SendCommand("REST", offset);
+                ValidateResponse(ReceiveResponse(), {350});
+            }
+            SendCommand(verb, argument);
+        }
+        catch (...)
+        {
+            if (dataSocket >= 0)
+            {
+                closesocket(dataSocket);
+            }
+            throw;
+        }
+        return dataSocket;
+    }
+
+    //! Open an active data connection: announce a listener, send the command and accept the server's connect
+    //! The server only connects once the command runs, so its 1xx reply is read here and held
+    //! for the caller's next ReceiveResponse. Unless the check is turned off, connections from
+    //! any host but the control connection's peer are closed and the wait goes on, so another
+    //! host that races to the announced port cannot feed or read the transfer.
+    //@ param verb The transfer command
+    //@ param argument The argument of the transfer command, may be empty
+    //@ param restartOffset Offset to send with REST first, empty for none
+    //@ return The accepted data socket
+    int FTPClient::OpenActiveDataConnection(std::string_view verb, std::string_view argument,
+                                            std::string_view restartOffset)
+    {
+        ResolvedAddress local;
+        local.length = sizeof(local.address);
+        if (getsockname(m_socket, reinterpret_cast<sockaddr *>(&local.address), &local.length) < 0)
+        {
+            throw FTPException("Failed to get the local address of the control connection.");
+        }
+
+        ResolvedAddress announced;
+        int listener = m_listeners->Acquire(local, announced);
+        try
+        {
+            //* Accepted sockets inherit the listener's buffer sizes
+            TuneDataBuffers(listener);
+
+            char host[INET6_ADDRSTRLEN] = {};
+            if (announced.Family() == AF_INET6)
+            {
+                const auto *ipv6 = reinterpret_cast<const sockaddr_in6 *>(&announced.address);
+                inet_ntop(AF_INET6, &ipv6->sin6_addr, host, sizeof(host));
+                SendCommand("EPRT", "|2|" + std::string(host) + "|" + std::to_string(ntohs(ipv6->sin6_port)) + "|");
+            }
+            else
+            {
+                const auto *ipv4 = reinterpret_cast<const sockaddr_in *>(&announced.address);
+                inet_ntop(AF_INET, &ipv4->sin_addr, host, sizeof(host));
+                std::string hostPort(host);
+                std::replace(hostPort.begin(), hostPort.end(), '.', ',');
+                uint16_t port = ntohs(ipv4->sin_port);
+                SendCommand("PORT", hostPort + "," + std::to_string(port / 256) + "," + std::to_string(port % 256));
+            }
+            ValidateResponse(ReceiveResponse(), {200});
+
+            if (!restartOffset.empty())
+            {
+                SendCommand("REST", restartOffset);
+                ValidateResponse(ReceiveResponse(), {350});
+            }
+            SendCommand(verb, argument);
+
+            //* A server that connects before replying is queued in the backlog until the accept
+            const std::string &response = ReceiveResponse();
+            int code = FTPResponseParser::ParseCode(response);
+            if (code < 100 || code >= 200)
+            {
+                ValidateResponse(response, {125, 150});
+            }
+        }
+        catch (...)
+        {
+            m_listeners->Release(listener);
+            throw;
+        }
+
+        FTPTraceSpan acceptSpan(m_tracer.get(), "data", "accept");
+        if (acceptSpan.Active())
+        {
+            acceptSpan.Arg("address", announced.ToString());
+        }
+        ResolvedAddress server;
+        server.address = m_peerAddress;
+        server.length = m_peerAddressLength;
+        auto deadline = std::chrono::steady_clock::now() + m_socketOptions.connectTimeout;
+        int dataSocket = -1;
+        int64_t refused = 0;
+        while (dataSocket < 0)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            pollfd waiting{static_cast<decltype(pollfd::fd)>(listener), POLLIN, 0};
+            int timeoutMs = static_cast<int>(std::max<int64_t>(remaining.count(), 0));
+#if defined(_WIN32) || defined(_WIN64)
+            int ready = WSAPoll(&waiting, 1, timeoutMs);
+#else
+            int ready = poll(&waiting, 1, timeoutMs);
+#endif
+            if (ready <= 0)
+            {
+                break;
+            }
+            ResolvedAddress peer;
+            peer.length = sizeof(peer.address);
+            int accepted = static_cast<int>(accept(listener, reinterpret_cast<sockaddr *>(&peer.address), &peer.length));
+            if (accepted < 0)
+            {
+                if (FTPEventLoop::WouldBlock())
+                {
+                    continue; //* The connect was reset before the accept; keep waiting
+                }
+                break;
+            }
+            if (m_verifyActivePeer && !peer.SameHost(server))
+            {
+                closesocket(accepted);
+                ++refused;
+                continue;
+            }
+            dataSocket = accepted;
+        }
+        if (acceptSpan.Active() && refused > 0)
+        {
+            acceptSpan.Arg("refused", refused);
+        }
+        if (dataSocket < 0)
+        {
+            //* The connect may still arrive, and the server still owes the command's final reply
+            m_listeners->Release(listener, false);
+            m_replyHeld = false;
+            Disconnect();
+            throw FTPException(refused > 0 ? "Refused " + std::to_string(refused) +
+                                                 " active mode data connection(s) from a host other than the server."
+                                           : std::string("Timed out waiting for the active mode data connection."));
+        }
+        m_listeners->Release(listener);
+        m_replyHeld = true;
+
+        FTPEventLoop::SetBlocking(dataSocket);
+        ApplyTcpOptions(dataSocket, m_socketOptions.dataNoDelay, m_socketOptions);
+        return dataSocket;
+    }
+
+    //! Create a data socket and apply the TCP options
+    //@ param family AF_INET or AF_INET6
+    //@ return The unconnected data socket
+    int FTPClient::CreateDataSocket(int family)
+    {
+        int dataSocket = static_cast<int>(socket(family, SOCK_STREAM, 0));
+        if (dataSocket < 0)
+        {
+            throw FTPException("Failed to create data socket.");
+        }
+        ApplyTcpOptions(dataSocket, m_socketOptions.dataNoDelay, m_socketOptions);
+        TuneDataBuffers(dataSocket);
+        return dataSocket;
+    }
+
+    //! Apply the data buffer sizes: the configured ones, or sized from the bandwidth-delay product
+    //@ param dataSocket The data socket, or the listener an active mode data socket is accepted from
+    void FTPClient::TuneDataBuffers(int dataSocket)
+    {
+        //* Buffer sizes must be set before the handshake so the window scale is negotiated for them
+        int tuned = m_socketOptions.autoTuneBuffers
+                        ? m_socketOptions.BufferSizeFor(RoundTripSeconds(), m_bandwidthEstimate)
+                        : 0;
+        int receiveSize = m_socketOptions.receiveBufferSize > 0 ? m_socketOptions.receiveBufferSize : tuned;
+        int sendSize = m_socketOptions.sendBufferSize > 0 ? m_socketOptions.sendBufferSize : tuned;
+        FTPTraceSpan span(m_tracer.get(), "data", "buffers");
+        if (span.Active())
+        {
+            span.Arg("receiveBuffer", static_cast<int64_t>(receiveSize)); //* 0 keeps the kernel default
+            span.Arg("sendBuffer", static_cast<int64_t>(sendSize));
+        }
+        if (receiveSize > 0)
+        {
+            SetIntOption(dataSocket, SOL_SOCKET, SO_RCVBUF, receiveSize);
+        }
+        if (sendSize > 0)
+        {
+            SetIntOption(dataSocket, SOL_SOCKET, SO_SNDBUF, sendSize);
+        }
+    }
+
+    //! Connect a data socket to the server's data port
+    //@ param dataSocket The socket from CreateDataSocket; the caller closes it on failure
+    //@ param address The server's data address
+    void FTPClient::ConnectDataSocket(int dataSocket, const ResolvedAddress &address)
+    {
+        FTPTraceSpan connectSpan(m_tracer.get(), "data", "connect");
+        if (connectSpan.Active())
+        {
+            connectSpan.Arg("address", address.ToString());
+        }
+        if (::connect(dataSocket, reinterpret_cast<const sockaddr *>(&address.address), address.length) < 0)
+        {
+            throw FTPException("Failed to connect to passive mode address.");
+        }
+    }
+
+    //! Build the data address from an EPSV reply
+    //@ param response The 229 reply
+    //@ return The control connection's peer address with the announced port
+    ResolvedAddress FTPClient::ExtendedPassiveAddress(const std::string &response) const
+    {
+        //* EPSV returns only a port; the host is the one the control connection is connected to
+        uint16_t port = FTPUtilities::ParseExtendedPassiveResponse(response);
+        ResolvedAddress address;
+        address.address = m_peerAddress;
+        address.length = m_peerAddressLength;
+        if (address.Family() == AF_INET6)
+        {
+            reinterpret_cast<sockaddr_in6 *>(&address.address)->sin6_port = htons(port);
+        }
+        else
+        {
+            reinterpret_cast<sockaddr_in *>(&address.address)->sin_port = htons(port);
+        }
+        return address;
+    }
+
+    //! Skip the replies of a pipelined transfer command whose data connection was never set up
+    void FTPClient::DrainTransferReplies()
+    {
+        //* A 1xx mark is followed by the final reply; anything else is final
+        int code = FTPResponseParser::ParseCode(ReceiveResponse());
+        while (code >= 100 && code < 200)
+        {
+            code = FTPResponseParser::ParseCode(ReceiveResponse());
+        }
+    }
+
+    //! Switch the session to binary (image) transfer type
+    void FTPClient::SetBinaryMode()
+    {
+        if (m_binaryMode)
+        {
+            return;
+        }
+
+        SendCommand("TYPE I");
+        std::string response = ReceiveResponse();
+        ValidateResponse(response, {200});
+        m_binaryMode = true;
+    }
+
+    //! Put the session into MODE Z or back into stream mode before a transfer
+    //@ param compressed Whether the next transfer should be compressed
+    //@ return True if the next transfer is compressed
+    bool FTPClient::SelectTransferMode(bool compressed)
+    {
+        compressed = compressed && m_compressionLevel > 0 && !m_modeZRefused && FTPDeflater::Available();
+        if (compressed != m_modeZ)
+        {
+            SendCommand("MODE", compressed ? "Z" : "S");
+            const std::string &response = ReceiveResponse();
+            if (compressed && !FTPResponseParser::IsExpectedCode(response, 200))
+            {
+                //* MODE Z is optional (502/504); carry on uncompressed
+                m_modeZRefused = true;
+                return false;
+            }
+            ValidateResponse(response, {200});
+            m_modeZ = compressed;
+        }
+
+        if (compressed && m_modeZLevel != m_compressionLevel)
+        {
+            //* The level only tunes the server's compressor, so a refusal is harmless
+            SendCommand("OPTS", "MODE Z LEVEL " + std::to_string(m_compressionLevel));
+            ReceiveResponse();
+            m_modeZLevel = m_compressionLevel;
+        }
+        return compressed;
+    }
+
+    //! Download one byte range of a file into an open descriptor
+    //@ param remoteFilePath The path to the file on the server
+    //@ param fd The local file descriptor to write into
+    //@ param localFilePath The path of the local file, for error messages
+    //@ param offset The first byte of the range
+    //@ param length The number of bytes in the range
+    //@ return Statistics for the range transfer
+    TransferStats FTPClient::DownloadRange(const std::string &remoteFilePath, int fd, const std::string &localFilePath,
+                                           uint64_t offset, uint64_t length)
+    {
+        TransferStats stats;
+#if !defined(_WIN32) && !defined(_WIN64)
+        SetBinaryMode();
+        SelectTransferMode(false);
+        int dataSocket = OpenDataConnection("RETR", remoteFilePath, offset);
+        std::string response = ReceiveResponse();
+        if (!FTPResponseParser::IsExpectedCode(response, 125) && !FTPResponseParser::IsExpectedCode(response, 150))
+        {
+            closesocket(dataSocket);
+            ValidateResponse(response, {125, 150});
+        }
+
+        std::vector<char> buffer(std::min<uint64_t>(m_transferBufferSize, length));
+        FTPThrottle throttle = MakeThrottle();
+        FTPTraceSpan span(m_tracer.get(), "transfer", "RETR range");
+        span.Arg("offset", static_cast<int64_t>(offset));
+        span.Arg("length", static_cast<int64_t>(length));
+        auto start = std::chrono::steady_clock::now();
+
+        while (stats.bytes < length)
+        {
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(buffer.size(), length - stats.bytes));
+            if (!throttle.Empty())
+            {
+                wanted = throttle.ChunkLimit(wanted);
+            }
+            ssize_t bytesRead = recv(dataSocket, buffer.data(), wanted, 0);
+            ++stats.syscalls;
+            if (bytesRead < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (bytesRead <= 0)
+            {
+                closesocket(dataSocket);
+                throw FTPException("Data connection closed before the segment was complete.");
+            }
+
+            ssize_t written = 0;
+            while (written < bytesRead)
+            {
+                ssize_t n = pwrite(fd, buffer.data() + written, bytesRead - written,
+                                   static_cast<off_t>(offset + stats.bytes + written));
+                ++stats.syscalls;
+                if (n < 0)
+                {
+                    std::string reason = std::strerror(errno);
+                    closesocket(dataSocket);
+                    throw FTPException("Failed to write local file: " + localFilePath + " (" + reason + ")", -1);
+                }
+                written += n;
+            }
+            stats.bytes += bytesRead;
+            if (!throttle.Empty())
+            {
+                throttle.Consume(bytesRead);
+            }
+        }
+        span.End();
+
+        //* Closing early aborts the rest of the stream, so 426/451 are expected for inner segments
+        closesocket(dataSocket);
+        response = ReceiveResponse();
+        ValidateResponse(response, {226, 250, 426, 451});
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#else
+        (void)remoteFilePath;
+        (void)fd;
+        (void)offset;
+        (void)length;
+#endif
+        return stats;
+    }
+
+    //! Reopen the control connection and log in again with the stored credentials
+    void FTPClient::Reconnect()
+    {
+        if (m_host.empty())
+        {
+            throw FTPException("Not connected to a server.", -1);
+        }
+        Connect(m_host, m_port);
+        if (!m_username.empty())
+        {
+            Authenticate(m_username, m_password);
+        }
+    }
+
+    //! Send a command to the server
+    //@ param verb The command verb, or a complete command line
+    //@ param argument The argument, appended after a space unless empty
+    void FTPClient::SendCommand(std::string_view verb, std::string_view argument)
+    {
+        //* Built in a reused buffer so a command costs no allocation once the session is warm
+        verb = FTPUtilities::TrimView(verb);
+        argument = FTPUtilities::TrimView(argument);
+        m_commandBuffer.assign(verb.data(), verb.size());
+        if (!argument.empty())
+        {
+            m_commandBuffer += ' ';
+            m_commandBuffer.append(argument.data(), argument.size());
+        }
+
+        FTPTraceSpan span(m_tracer.get(), "control", "send");
+        if (span.Active())
+        {
+            span.SetName(m_commandBuffer.substr(0, m_commandBuffer.find(' ')));
+            span.Arg("command", FTPUtilities::StartsWith(m_commandBuffer, "PASS ") ? "PASS ****" : m_commandBuffer);
+        }
+
+        m_commandBuffer += "\r\n";
+        TransferStats stats;
+        try
+        {
+            FTPTransfer::SendAll(m_socket, m_commandBuffer.data(), m_commandBuffer.size(), stats);
+        }
+        catch (const FTPException &)
+        {
+            throw FTPException("Failed to send command: " + m_commandBuffer.substr(0, m_commandBuffer.size() - 2));
+        }
+    }
+
+    //! Receive and return server response
+    //@ return The trimmed server response, valid until the next call
+    const std::string &FTPClient::ReceiveResponse()
+    {
+        if (m_replyHeld)
+        {
+            //* Already read while waiting for an active mode data connection
+            m_replyHeld = false;
+            return m_reply;
+        }
+
+        //* Spans from the end of the command to here are server think time plus one round trip
+        FTPTraceSpan span(m_tracer.get(), "control", "reply");
+        m_replyReader->ReadReply(m_socket, m_reply);
+
+        std::string_view trimmed = FTPUtilities::TrimView(m_reply);
+        m_reply.erase(static_cast<size_t>(trimmed.data() - m_reply.data()) + trimmed.size());
+        m_reply.erase(0, static_cast<size_t>(trimmed.data() - m_reply.data()));
+        if (span.Active())
+        {
+            span.SetName("reply " + m_reply.substr(0, 3));
+            span.Arg("reply", m_reply.substr(0, m_reply.find('\n')));
+        }
+        return m_reply;
+    }
+
+    //! Validate server response
+    //@ param response The server response
+    //@ param expectedCodes The expected response codes
+    void FTPClient::ValidateResponse(std::string_view response, const ReplyCodeSet &expectedCodes)
+    {
+        if (expectedCodes.Contains(FTPResponseParser::ParseCode(response)))
+        {
+            return;
+        }
+
+        auto [code, message] = FTPResponseParser::ParseResponse(std::string(response));
+        throw FTPException("Unexpected response code: " + std::to_string(code) + " - " + message, code);
     }
 
 }
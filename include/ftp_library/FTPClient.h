@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:45:43 
+ * Last Modified: Sat October 17th 2026 23:11:01 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -21,14 +21,171 @@ namespace ftp_library
     class FTPException : public std::runtime_error
     {
     public:
-        explicit FTPException(const std::string &message) : std::runtime_error(message) {}
+        explicit FTPException(const std::string &message, int code = 0) : std::runtime_error(message), m_code(code) {}
+
+        //! Get the server reply code that caused the error (0 for transport errors, -1 for local file errors)
+        int Code() const
+        {
+            return m_code;
+        }
+
+        //! Check whether retrying may succeed: transport errors and 4xx transient replies
+        bool IsTransient() const
+        {
+            return m_code == 0 || (m_code >= 400 && m_code < 500);
+        }
+
+    private:
+        int m_code; //* Server reply code, 0 if none
+    };
+
+    //! Statistics for a single data channel transfer
+    struct TransferStats
+    {
+        uint64_t bytes = 0;             //* Bytes moved over the data connection
+        double seconds = 0.0;           //* Wall-clock duration of the transfer loop
+        uint64_t syscalls = 0;          //* Number of I/O system calls issued
+        bool zeroCopy = false;          //* True if the kernel fast path was used
+        double firstByteSeconds = -1.0; //* Receive loops: delay until the first byte, -1 if none arrived
+
+        //! Get the average throughput of the transfer
+        //! @return The throughput in bytes per second
+        double BytesPerSecond() const
+        {
+            return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+        }
+    };
+
+    //! Retry policy for resumable transfers
+    //! Attempt n (from 1) waits min(maxDelay, initialDelay * multiplier^(n-1)) before retrying.
+    struct RetryPolicy
+    {
+        unsigned maxAttempts = 5;                          //* Total attempts including the first
+        std::chrono::milliseconds initialDelay{500};       //* Delay before the first retry
+        std::chrono::milliseconds maxDelay{30000};         //* Upper bound for the delay
+        double multiplier = 2.0;                           //* Growth factor between retries
+
+        //! Get the delay before a retry
+        //! @param attempt The attempt that just failed (1 = first attempt)
+        //! @return The delay to wait
+        std::chrono::milliseconds DelayAfter(unsigned attempt) const
+        {
+            double delay = static_cast<double>(initialDelay.count());
+            for (unsigned i = 1; i < attempt && delay < maxDelay.count(); ++i)
+            {
+                delay *= multiplier;
+            }
+            return std::chrono::milliseconds(static_cast<int64_t>(std::min(delay, static_cast<double>(maxDelay.count()))));
+        }
+    };
+
+    //! TCP settings for the control and data connections
+    //! Buffer sizes of 0 keep the kernel defaults and its autotuning. With
+    //! autoTuneBuffers, data connections get buffers of twice the measured
+    //! bandwidth-delay product (RTT from the control connection, bandwidth
+    //! from earlier transfers of at least 1 MiB) so the window never caps throughput.
+    struct SocketOptions
+    {
+        bool controlNoDelay = true;                  //* TCP_NODELAY on the control connection
+        bool dataNoDelay = false;                    //* TCP_NODELAY on data connections
+        bool keepAlive = true;                       //* SO_KEEPALIVE on every connection
+        std::chrono::seconds keepAliveIdle{60};      //* Idle time before the first probe
+        std::chrono::seconds keepAliveInterval{15};  //* Time between unanswered probes
+        int keepAliveProbes = 4;                     //* Unanswered probes before the connection is dropped
+        int receiveBufferSize = 0;                   //* SO_RCVBUF for data connections, 0 for auto or default
+        int sendBufferSize = 0;                      //* SO_SNDBUF for data connections, 0 for auto or default
+        bool autoTuneBuffers = false;                //* Size unset data buffers from the bandwidth-delay product
+        int minAutoBufferSize = 64 * 1024;           //* Lower bound for auto-sized buffers
+        int maxAutoBufferSize = 16 * 1024 * 1024;    //* Upper bound for auto-sized buffers
+        std::chrono::milliseconds connectTimeout{30000};   //* Limit for the control connect and active mode accept
+        std::chrono::milliseconds connectAttemptDelay{250}; //* Head start of each address over the next (happy eyeballs)
+
+        //! Get the auto-sized buffer for a path
+        //! @param rttSeconds The round trip time, 0 if unknown
+        //! @param bytesPerSecond The bandwidth, 0 if unknown
+        //! @return Twice the bandwidth-delay product within the bounds, 0 to keep the kernel default
+        int BufferSizeFor(double rttSeconds, double bytesPerSecond) const
+        {
+            if (rttSeconds <= 0.0 || bytesPerSecond <= 0.0)
+            {
+                return 0;
+            }
+            double size = 2.0 * rttSeconds * bytesPerSecond;
+            return static_cast<int>(std::clamp(size, static_cast<double>(minAutoBufferSize),
+                                               static_cast<double>(maxAutoBufferSize)));
+        }
+
+        bool operator==(const SocketOptions &other) const
+        {
+            return controlNoDelay == other.controlNoDelay && dataNoDelay == other.dataNoDelay &&
+                   keepAlive == other.keepAlive && keepAliveIdle == other.keepAliveIdle &&
+                   keepAliveInterval == other.keepAliveInterval && keepAliveProbes == other.keepAliveProbes &&
+                   receiveBufferSize == other.receiveBufferSize && sendBufferSize == other.sendBufferSize &&
+                   autoTuneBuffers == other.autoTuneBuffers && minAutoBufferSize == other.minAutoBufferSize &&
+                   maxAutoBufferSize == other.maxAutoBufferSize && connectTimeout == other.connectTimeout &&
+                   connectAttemptDelay == other.connectAttemptDelay;
+        }
+
+        bool operator!=(const SocketOptions &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    //! Metadata command in a pipelined batch
+    enum class MetadataCommand
+    {
+        Size,            //* SIZE, the file size in bytes
+        ModificationTime //* MDTM, the modification time in UTC seconds
+    };
+
+    //! One query of a pipelined metadata batch
+    struct MetadataQuery
+    {
+        MetadataCommand command; //* What to ask for
+        std::string path;        //* The path to the file on the server
+    };
+
+    //! Typed outcome of one metadata query
+    struct MetadataResult
+    {
+        int code = 0;        //* Reply code
+        uint64_t size = 0;   //* Size in bytes (Size queries)
+        int64_t mtime = -1;  //* UTC seconds since the epoch (ModificationTime queries), -1 if unknown
+        std::string message; //* Reply text, explains a failed query
+
+        //! Check whether the server answered the query with 213
+        bool Ok() const
+        {
+            return code == 213;
+        }
     };
 
     class FTPResponseParser;
+    class ReplyCodeSet;
+    class FTPReplyReader;
+    class FTPListingParser;
+    class FTPListingCache;
+    class FTPMetricsSink;
+    struct OperationMetrics;
+    class FTPTracer;
+    class FTPRateLimiter;
+    class FTPBandwidthLimits;
+    class FTPThrottle;
+    class FTPResolver;
+    struct ResolvedAddress;
+    class FTPListenerPool;
 
     class FTPClient
     {
     public:
+        //! Receives downloaded data as it arrives; the chunk is only valid during the call
+        using DataSink = std::function<void(const char *data, size_t size)>;
+
+        //! Fills up to `capacity` bytes of `buffer` with data to upload and returns the
+        //! number of bytes written, or 0 once the data is exhausted
+        using DataSource = std::function<size_t(char *buffer, size_t capacity)>;
+
         //! Constructor and destructor
         FTPClient();
         virtual ~FTPClient();
@@ -57,9 +214,20 @@ namespace ftp_library
         virtual void Authenticate(const std::string &username, const std::string &password);
 
         //! Get a list of files and directories in the current working directory
+        //! With a listing cache attached, a fresh cached listing is returned without
+        //! opening a data connection. A stale one is refreshed in the call by the first
+        //! caller and served only if that refresh fails with a transient error; callers
+        //! that find the refresh already claimed get the stale listing right away.
         //! @return A vector of strings containing the names of the files and directories
         virtual std::vector<std::string> ListDirectory(const std::string &remoteDir = "/");
 
+        //! Stream a directory listing into a parser
+        //! Sends MLSD when the parser expects MLSD and LIST otherwise; entries are
+        //! parsed as the bytes arrive and never buffered as one string.
+        //! @param remoteDir The directory to list
+        //! @param parser Receives the listing; its entries stay valid while it lives
+        void ListDirectory(const std::string &remoteDir, FTPListingParser &parser);
+
         //! Download a file from the server
         //! @param remoteFilePath The path to the file on the server
         //! @param localFilePath The path to save the file locally
@@ -70,17 +238,256 @@ namespace ftp_library
         //! @param remoteFilePath The path to save the file on the server
         virtual void UploadFile(const std::string &localFilePath, const std::string &remoteFilePath);
 
+        //! Download a file straight into a sink instead of a local file
+        //! If the sink throws, the transfer is aborted and the exception propagates.
+        //! @param remoteFilePath The path to the file on the server
+        //! @param sink Receives the file contents in order
+        void DownloadFile(const std::string &remoteFilePath, const DataSink &sink);
+
+        //! Upload data pulled from a source instead of a local file
+        //! If the source throws, the transfer is aborted and the exception propagates.
+        //! @param source Produces the file contents in order
+        //! @param remoteFilePath The path to save the file on the server
+        void UploadFile(const DataSource &source, const std::string &remoteFilePath);
+
+        //! Download a file, resuming with REST after dropped connections
+        //! Progress is checkpointed to "<local>.ftpckpt"; a later call picks up from the
+        //! confirmed offset as long as the remote size and modification time are unchanged.
+        //! Transient failures reconnect and retry according to the retry policy.
+        //! @param remoteFilePath The path to the file on the server
+        //! @param localFilePath The path to save the file locally
+        void DownloadFileResumable(const std::string &remoteFilePath, const std::string &localFilePath);
+
+        //! Upload a file, resuming with APPE after dropped connections
+        //! The server's SIZE of the partial file is the resume offset; the checkpoint
+        //! "<local>.ftpckpt" ties it to the unchanged local file.
+        //! @param localFilePath The path to the file to upload
+        //! @param remoteFilePath The path to save the file on the server
+        void UploadFileResumable(const std::string &localFilePath, const std::string &remoteFilePath);
+
+        //! Attach a listing cache (may be shared with other clients), or nullptr to detach
+        //! @param cache The cache to use
+        void SetListingCache(std::shared_ptr<FTPListingCache> cache)
+        {
+            m_listingCache = std::move(cache);
+        }
+
+        //! Attach a metrics sink (may be shared with other clients), or nullptr to detach
+        //! Connect, Authenticate, listings, downloads and uploads each report one
+        //! OperationMetrics, whether they succeed or throw.
+        //! @param sink The sink to report to
+        void SetMetricsSink(std::shared_ptr<FTPMetricsSink> sink)
+        {
+            m_metricsSink = std::move(sink);
+        }
+
+        //! Attach a tracer (may be shared with other clients), or nullptr to detach
+        //! Records spans for operations, control commands, reply waits, data
+        //! connection setup and transfer loops; see FTPTracer.
+        //! @param tracer The tracer to record into
+        void SetTracer(std::shared_ptr<FTPTracer> tracer)
+        {
+            m_tracer = std::move(tracer);
+        }
+
+        //! Attach global and per-host bandwidth limits (may be shared with other clients), or nullptr to detach
+        //! @param limits The limits to obey
+        void SetBandwidthLimits(std::shared_ptr<FTPBandwidthLimits> limits)
+        {
+            m_bandwidthLimits = std::move(limits);
+        }
+
+        //! Limit the rate of each transfer made by this client
+        //! May be called from another thread while a transfer runs; a transfer
+        //! started with no limit configured at all runs unthrottled.
+        //! @param bytesPerSecond The rate, 0 for unlimited
+        void SetTransferRateLimit(uint64_t bytesPerSecond);
+
+        //! Attach a host name resolver (may be shared with other clients), or nullptr to resolve on every connect
+        //! Every client starts with FTPResolver::Shared(), so reconnects and pool warm-up
+        //! reuse one cached lookup. Connect races the resolved IPv4 and IPv6 addresses;
+        //! see FTPResolver::ConnectFirst and SocketOptions::connectAttemptDelay.
+        //! @param resolver The resolver to use
+        void SetResolver(std::shared_ptr<FTPResolver> resolver)
+        {
+            m_resolver = std::move(resolver);
+        }
+
+        //! Set the TCP options for the control and data connections
+        //! Applies to the open control connection at once and to data connections from the next transfer on.
+        //! @param options The options to use
+        void SetSocketOptions(const SocketOptions &options);
+
+        //! Get the TCP options for the control and data connections
+        const SocketOptions &GetSocketOptions() const
+        {
+            return m_socketOptions;
+        }
+
+        //! Compress data connections with MODE Z (deflate) where the server supports it
+        //! Applies to downloads, uploads and listings. The server is asked for the same
+        //! level with OPTS MODE Z LEVEL. Resumable and segmented transfers stay in stream
+        //! mode, because REST offsets are not defined for compressed data. A server that
+        //! refuses MODE Z is not asked again until the next Connect.
+        //! @param level The zlib level, 1 (fastest) to 9 (smallest), or 0 to turn compression off
+        void SetCompressionLevel(int level)
+        {
+            m_compressionLevel = std::clamp(level, 0, 9);
+        }
+
+        //! Get the MODE Z compression level, 0 if compression is off
+        int GetCompressionLevel() const
+        {
+            return m_compressionLevel;
+        }
+
+        //! Send the transfer command right behind EPSV instead of after the data connection is up
+        //! EPSV, REST and RETR/STOR/LIST then leave in one write and the data connect
+        //! overlaps the server's handling of the command, which saves a round trip per
+        //! transfer. Starts once the server has accepted a plain EPSV on the session;
+        //! servers that refuse EPSV keep the sequential PASV exchange.
+        //! @param enabled True to pipeline the data connection setup
+        void SetTransferPipelining(bool enabled)
+        {
+            m_pipelineTransfers = enabled;
+        }
+
+        //! Use active mode: announce a listener with PORT (IPv4) or EPRT (IPv6) and let the server connect
+        //! For servers whose passive data connections cannot be reached, e.g. behind a load
+        //! balancer that sends the data connect to a different backend than the control
+        //! connection. Listeners come from the pool and go back to it after the transfer;
+        //! transfer pipelining applies to passive mode only. Connections from any host but
+        //! the control connection's peer are refused, so no one else can take the announced
+        //! port; turn verifyPeer off only for servers that connect from another address,
+        //! such as a load balancer's backend.
+        //! @param listeners The listener pool, or nullptr for passive mode (the default)
+        //! @param verifyPeer Accept data connections from the control connection's peer only
+        void SetActiveMode(std::shared_ptr<FTPListenerPool> listeners, bool verifyPeer = true)
+        {
+            m_listeners = std::move(listeners);
+            m_verifyActivePeer = verifyPeer;
+        }
+
+        //! Set the retry policy for resumable transfers
+        //! @param policy The policy to use
+        void SetRetryPolicy(const RetryPolicy &policy)
+        {
+            m_retryPolicy = policy;
+        }
+
         //! Disconnect from the FTP server
         virtual void Disconnect();
 
+        //! Send a NOOP to check that the control connection is alive
+        //! Throws FTPException if the server does not answer with 200
+        void Noop();
+
+        //! Create a directory on the server
+        //! Throws FTPException if the server does not answer with 257
+        //! @param remoteDir The directory to create
+        void MakeDirectory(const std::string &remoteDir);
+
+        //! Get the size of a remote file
+        //! @param remoteFilePath The path to the file on the server
+        //! @return The file size in bytes
+        uint64_t GetFileSize(const std::string &remoteFilePath);
+
+        //! Get the modification time of a remote file (MDTM)
+        //! @param remoteFilePath The path to the file on the server
+        //! @return UTC seconds since the epoch
+        int64_t GetModificationTime(const std::string &remoteFilePath);
+
+        //! Download a file over several parallel connections using REST byte ranges
+        //! Each segment opens its own authenticated session and writes with pwrite
+        //! into a preallocated local file. Falls back to DownloadFile for small files.
+        //! @param remoteFilePath The path to the file on the server
+        //! @param localFilePath The path to save the file locally
+        //! @param segments The number of parallel connections to use
+        void DownloadFileSegmented(const std::string &remoteFilePath, const std::string &localFilePath,
+                                   unsigned segments = 4);
+
+        //! Enable or disable the progress messages written to std::cout
+        //! @param verbose True to print progress messages
+        void SetVerbose(bool verbose)
+        {
+            m_verbose = verbose;
+        }
+
+        //! Set the size of the user space buffer used by the transfer loops
+        //! @param bufferSize The buffer size in bytes
+        void SetTransferBufferSize(size_t bufferSize)
+        {
+            m_transferBufferSize = bufferSize;
+        }
+
+        //! Enable or disable the kernel zero-copy fast paths (splice/sendfile on Linux)
+        //! @param enabled True to use the fast path when available
+        void SetZeroCopy(bool enabled)
+        {
+            m_zeroCopy = enabled;
+        }
+
+        //! Get statistics for the most recent download or upload
+        //! @return The transfer statistics
+        const TransferStats &GetLastTransferStats() const
+        {
+            return m_lastTransferStats;
+        }
+
+        //! Send several commands back-to-back and collect their replies in order
+        //! At most a window of commands is in flight, so arbitrarily large batches
+        //! cannot deadlock on full socket buffers.
+        //! @param commands The commands to send (without CRLF)
+        //! @return The server reply for each command, in the same order
+        std::vector<std::string> ExecutePipelined(const std::vector<std::string> &commands);
+
+        //! Run a batch of SIZE/MDTM queries over one pipelined exchange
+        //! A failed query (e.g. 550 for a missing file) only affects its own result;
+        //! a broken connection throws FTPException.
+        //! @param queries The queries to run
+        //! @return The outcome of each query, in the same order
+        std::vector<MetadataResult> QueryMetadata(const std::vector<MetadataQuery> &queries);
+
     private:
         //! Helper methods --
         bool InitializeWinsock();                          //* Initialize Winsock
         void CleanupWinsock();                             //* Clean up Winsock
-        void SendCommand(const std::string &command);      //* Send a command to the server
-        std::string ReceiveResponse();                     //* Receive and return server response
-        void ValidateResponse(const std::string &response, //* Validate server response
-                              const std::vector<int> &expectedCodes);
+        void SendCommand(std::string_view verb,            //* Send "verb argument" to the server
+                         std::string_view argument = {});
+        const std::string &ReceiveResponse();              //* Receive a reply, valid until the next one
+        void ValidateResponse(std::string_view response,   //* Throw unless the reply code is expected
+                              const ReplyCodeSet &expectedCodes);
+        template <typename AppendCommand, typename HandleReply> //* Windowed pipelined exchange
+        void RunPipeline(size_t count, AppendCommand appendCommand, HandleReply handleReply);
+        int OpenDataConnection(std::string_view verb,      //* Connect a data socket and send the transfer command
+                               std::string_view argument = {}, uint64_t restartOffset = 0);
+        int OpenActiveDataConnection(std::string_view verb, //* PORT/EPRT, REST, command, then accept
+                                     std::string_view argument, std::string_view restartOffset);
+        int CreateDataSocket(int family);                  //* Create a data socket with the TCP options applied
+        void TuneDataBuffers(int dataSocket);              //* Apply SO_RCVBUF/SO_SNDBUF before the handshake
+        void ConnectDataSocket(int dataSocket,             //* Connect a data socket to the server's data port
+                               const ResolvedAddress &address);
+        ResolvedAddress ExtendedPassiveAddress(const std::string &response) const; //* Control peer + EPSV port
+        void DrainTransferReplies();                       //* Skip the replies of a command whose setup failed
+        using ReceiveLoop = std::function<TransferStats(int dataSocket, FTPThrottle *throttle, bool inflate)>;
+        using SendLoop = std::function<TransferStats(int dataSocket, FTPThrottle *throttle, int deflateLevel)>;
+        bool SelectTransferMode(bool compressed);          //* Switch between MODE S and MODE Z; true if compressed
+        void Retrieve(const std::string &remoteFilePath,   //* RETR into whatever `receive` writes to
+                      const std::string &destination, const ReceiveLoop &receive);
+        void Store(const std::string &remoteFilePath,      //* STOR from whatever `send` reads from
+                   const SendLoop &send);
+        void AbortTransfer(int dataSocket);                //* Close the data socket, drain the final reply
+        void SetBinaryMode();                              //* Switch to TYPE I once per session
+        TransferStats DownloadRange(const std::string &remoteFilePath, int fd, //* Download one byte range
+                                    const std::string &localFilePath, uint64_t offset, uint64_t length);
+        void Reconnect();                                  //* Reopen and re-authenticate the session
+        std::vector<std::string> FetchListing(const std::string &remoteDir, //* CWD + LIST without the cache
+                                              OperationMetrics &metrics);
+        std::string ServerKey() const;                     //* "host:port" for listing cache keys
+        void InvalidateCachedParent(const std::string &remotePath); //* Drop the cached listing containing a path
+        FTPThrottle MakeThrottle();                        //* Limiters for the next transfer, empty if none apply
+        double RoundTripSeconds() const;                   //* Control connection RTT, 0 if unknown
+        void RecordThroughput(const TransferStats &stats); //* Feed a transfer into the bandwidth estimate
 
         //! Data members
         int m_socket;                                        //* Socket descriptor for the connection
@@ -89,6 +496,38 @@ namespace ftp_library
         uint16_t m_port;                                     //* Server port
         std::string m_remoteDir;                             //* Current remote directory (default is "/")
         std::unique_ptr<FTPResponseParser> m_responseParser; //* Response parser (composition)
+        std::unique_ptr<FTPReplyReader> m_replyReader;       //* Buffered control channel reader
+        size_t m_transferBufferSize;                         //* Fallback transfer buffer size
+        bool m_zeroCopy;                                     //* Use the kernel fast path when available
+        TransferStats m_lastTransferStats;                   //* Statistics for the last transfer
+        std::string m_username;                              //* Credentials for opening extra sessions
+        std::string m_password;                              //* Credentials for opening extra sessions
+        bool m_binaryMode;                                   //* True once TYPE I has been sent
+        bool m_verbose;                                      //* Print progress messages to std::cout
+        RetryPolicy m_retryPolicy;                           //* Retry policy for resumable transfers
+        std::shared_ptr<FTPListingCache> m_listingCache;     //* Optional directory listing cache
+        std::shared_ptr<FTPMetricsSink> m_metricsSink;       //* Optional per-operation metrics sink
+        std::shared_ptr<FTPTracer> m_tracer;                 //* Optional span tracer
+        std::shared_ptr<FTPBandwidthLimits> m_bandwidthLimits; //* Optional shared global and per-host limits
+        std::shared_ptr<FTPRateLimiter> m_transferLimiter;   //* Per-transfer limit
+        SocketOptions m_socketOptions;                       //* TCP settings for new connections
+        std::shared_ptr<FTPResolver> m_resolver;             //* Cached resolver, or null to resolve every time
+        sockaddr_storage m_peerAddress;                      //* Address the control connection is connected to
+        socklen_t m_peerAddressLength;                       //* Valid bytes of m_peerAddress, 0 before Connect
+        double m_handshakeSeconds;                           //* Duration of the control TCP handshake
+        double m_bandwidthEstimate;                          //* Moving average of transfer throughput in bytes/s
+        int m_compressionLevel;                              //* MODE Z level, 0 when compression is off
+        bool m_modeZ;                                        //* True while the session is in MODE Z
+        bool m_modeZRefused;                                 //* True once the server rejected MODE Z
+        int m_modeZLevel;                                    //* Level last sent with OPTS MODE Z LEVEL, 0 if none
+        bool m_pipelineTransfers;                            //* Send the transfer command right behind EPSV
+        bool m_epsvConfirmed;                                //* True once the server accepted EPSV
+        bool m_epsvRefused;                                  //* True once the server rejected EPSV; use PASV
+        std::shared_ptr<FTPListenerPool> m_listeners;        //* Listener pool for active mode, null for passive
+        bool m_verifyActivePeer;                             //* Refuse active data connects from other hosts
+        bool m_replyHeld;                                    //* m_reply is unread; return it on the next receive
+        std::string m_commandBuffer;                         //* Reused buffer for outgoing command lines
+        std::string m_reply;                                 //* Reused buffer for the last reply
     };
 
 }
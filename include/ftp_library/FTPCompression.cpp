@@ -0,0 +1,198 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPCompression.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:35:59 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPCompression.h>
+
+#if defined(FTP_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace ftp_library
+{
+
+    //! Size of the buffer zlib writes its output into
+    static constexpr size_t kCompressionBufferSize = 64 * 1024;
+
+#if defined(FTP_HAVE_ZLIB)
+    struct FTPDeflater::Stream
+    {
+        z_stream z{};
+    };
+
+    struct FTPInflater::Stream
+    {
+        z_stream z{};
+    };
+#else
+    struct FTPDeflater::Stream
+    {
+    };
+
+    struct FTPInflater::Stream
+    {
+    };
+#endif
+
+    //! Check whether the library was built with zlib
+    //@ return True if MODE Z can be used
+    bool FTPDeflater::Available()
+    {
+#if defined(FTP_HAVE_ZLIB)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    //! Constructor
+    //@ param level The zlib compression level, 1 (fastest) to 9 (smallest)
+    FTPDeflater::FTPDeflater(int level) : m_stream(std::make_unique<Stream>()), m_buffer(kCompressionBufferSize)
+    {
+#if defined(FTP_HAVE_ZLIB)
+        if (deflateInit(&m_stream->z, std::clamp(level, 1, 9)) != Z_OK)
+        {
+            throw FTPException("Failed to initialize the MODE Z compressor.", -1);
+        }
+#else
+        (void)level;
+        throw FTPException("MODE Z requires a build with zlib.", -1);
+#endif
+    }
+
+    //! Destructor
+    FTPDeflater::~FTPDeflater()
+    {
+#if defined(FTP_HAVE_ZLIB)
+        deflateEnd(&m_stream->z);
+#endif
+    }
+
+    //! Compress a chunk
+    //@ param data The uncompressed bytes
+    //@ param size The number of bytes
+    //@ param output Receives the compressed bytes
+    void FTPDeflater::Write(const char *data, size_t size, const Output &output)
+    {
+        if (size > 0)
+        {
+            Run(data, size, false, output);
+        }
+    }
+
+    //! Flush what is buffered and end the stream
+    //@ param output Receives the remaining compressed bytes
+    void FTPDeflater::Finish(const Output &output)
+    {
+        Run(nullptr, 0, true, output);
+    }
+
+    //! Feed input to deflate and drain its output
+    //@ param data The uncompressed bytes
+    //@ param size The number of bytes
+    //@ param finish End the stream once the input is consumed
+    //@ param output Receives the compressed bytes
+    void FTPDeflater::Run(const char *data, size_t size, bool finish, const Output &output)
+    {
+#if defined(FTP_HAVE_ZLIB)
+        z_stream &z = m_stream->z;
+        z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        z.avail_in = static_cast<uInt>(size);
+
+        int result;
+        do
+        {
+            z.next_out = reinterpret_cast<Bytef *>(m_buffer.data());
+            z.avail_out = static_cast<uInt>(m_buffer.size());
+            result = deflate(&z, finish ? Z_FINISH : Z_NO_FLUSH);
+            if (result == Z_STREAM_ERROR)
+            {
+                throw FTPException("Failed to compress MODE Z data.", -1);
+            }
+            size_t produced = m_buffer.size() - z.avail_out;
+            if (produced > 0)
+            {
+                output(m_buffer.data(), produced);
+            }
+        } while (z.avail_out == 0 || (finish && result != Z_STREAM_END));
+#else
+        (void)data;
+        (void)size;
+        (void)finish;
+        (void)output;
+#endif
+    }
+
+    //! Constructor
+    FTPInflater::FTPInflater() : m_stream(std::make_unique<Stream>()), m_buffer(kCompressionBufferSize)
+    {
+#if defined(FTP_HAVE_ZLIB)
+        if (inflateInit(&m_stream->z) != Z_OK)
+        {
+            throw FTPException("Failed to initialize the MODE Z decompressor.", -1);
+        }
+#else
+        throw FTPException("MODE Z requires a build with zlib.", -1);
+#endif
+    }
+
+    //! Destructor
+    FTPInflater::~FTPInflater()
+    {
+#if defined(FTP_HAVE_ZLIB)
+        inflateEnd(&m_stream->z);
+#endif
+    }
+
+    //! Decompress a chunk of the data connection
+    //@ param data The compressed bytes
+    //@ param size The number of bytes
+    //@ param output Receives the decompressed bytes
+    void FTPInflater::Write(const char *data, size_t size, const Output &output)
+    {
+#if defined(FTP_HAVE_ZLIB)
+        z_stream &z = m_stream->z;
+        z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        z.avail_in = static_cast<uInt>(size);
+
+        do
+        {
+            z.next_out = reinterpret_cast<Bytef *>(m_buffer.data());
+            z.avail_out = static_cast<uInt>(m_buffer.size());
+            int result = inflate(&z, Z_NO_FLUSH);
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+            {
+                throw FTPException("Corrupt MODE Z data on the data connection.");
+            }
+            size_t produced = m_buffer.size() - z.avail_out;
+            if (produced > 0)
+            {
+                output(m_buffer.data(), produced);
+            }
+            if (result == Z_STREAM_END)
+            {
+                //* More input after the end belongs to a new stream
+                inflateReset(&z);
+            }
+            else if (result == Z_BUF_ERROR)
+            {
+                //* No progress possible until more input arrives
+                break;
+            }
+        } while (z.avail_in > 0 || z.avail_out == 0);
+#else
+        (void)data;
+        (void)size;
+        (void)output;
+#endif
+    }
+
+}
@@ -0,0 +1,87 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPCompression.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:35:59 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPCOMPRESSION_H
+#define FTPCOMPRESSION_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Streaming deflate compressor for MODE Z data connections
+    //! Requires a build with zlib (FTP_HAVE_ZLIB); otherwise construction throws.
+    class FTPDeflater
+    {
+    public:
+        //! Receives compressed output; the chunk is only valid during the call
+        using Output = std::function<void(const char *data, size_t size)>;
+
+        //! Check whether the library was built with zlib
+        static bool Available();
+
+        //! Constructor
+        //! @param level The zlib compression level, 1 (fastest) to 9 (smallest)
+        explicit FTPDeflater(int level = 6);
+        ~FTPDeflater();
+
+        FTPDeflater(const FTPDeflater &) = delete;
+        FTPDeflater &operator=(const FTPDeflater &) = delete;
+
+        //! Compress a chunk; output is passed on as soon as zlib produces it
+        //! @param data The uncompressed bytes
+        //! @param size The number of bytes
+        //! @param output Receives the compressed bytes
+        void Write(const char *data, size_t size, const Output &output);
+
+        //! Flush what is buffered and end the stream
+        //! @param output Receives the remaining compressed bytes
+        void Finish(const Output &output);
+
+    private:
+        void Run(const char *data, size_t size, bool finish, const Output &output);
+
+        struct Stream;
+        std::unique_ptr<Stream> m_stream; //* zlib state, kept out of the header
+        std::vector<char> m_buffer;       //* Output buffer
+    };
+
+    //! Streaming inflater for MODE Z data connections
+    //! Concatenated deflate streams are accepted, since some servers restart the
+    //! stream on every flush.
+    class FTPInflater
+    {
+    public:
+        //! Receives decompressed output; the chunk is only valid during the call
+        using Output = std::function<void(const char *data, size_t size)>;
+
+        FTPInflater();
+        ~FTPInflater();
+
+        FTPInflater(const FTPInflater &) = delete;
+        FTPInflater &operator=(const FTPInflater &) = delete;
+
+        //! Decompress a chunk of the data connection
+        //! @param data The compressed bytes
+        //! @param size The number of bytes
+        //! @param output Receives the decompressed bytes
+        void Write(const char *data, size_t size, const Output &output);
+
+    private:
+        struct Stream;
+        std::unique_ptr<Stream> m_stream; //* zlib state, kept out of the header
+        std::vector<char> m_buffer;       //* Output buffer
+    };
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPCoroutine.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:14:33 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPCOROUTINE_H
+#define FTPCOROUTINE_H
+
+#include <ftp_library/Framework.h>
+#include <ftp_library/FTPAsyncClient.h>
+
+//* Not part of Framework.h: include it directly, after the rest of the library.
+//* The co_await interface needs a C++20 compiler; C++17 builds simply skip it.
+#if defined(__cpp_impl_coroutine)
+
+namespace ftp_library
+{
+
+    template <typename T = void>
+    class FTPTask;
+
+    namespace detail
+    {
+        //! Resumes whoever awaited a finished task
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+            {
+                auto continuation = handle.promise().m_continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        //! State shared by every task promise
+        struct TaskPromiseBase
+        {
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { m_error = std::current_exception(); }
+
+            std::coroutine_handle<> m_continuation; //* Coroutine waiting on this task
+            std::exception_ptr m_error;             //* Exception thrown by the task body
+        };
+
+        template <typename T>
+        struct TaskPromise : TaskPromiseBase
+        {
+            FTPTask<T> get_return_object() noexcept;
+            void return_value(T value) { m_value.emplace(std::move(value)); }
+
+            T Result()
+            {
+                if (m_error)
+                {
+                    std::rethrow_exception(m_error);
+                }
+                return std::move(*m_value);
+            }
+
+            std::optional<T> m_value; //* Value passed to co_return
+        };
+
+        template <>
+        struct TaskPromise<void> : TaskPromiseBase
+        {
+            FTPTask<void> get_return_object() noexcept;
+            void return_void() const noexcept {}
+
+            void Result()
+            {
+                if (m_error)
+                {
+                    std::rethrow_exception(m_error);
+                }
+            }
+        };
+
+        //! Fire-and-forget coroutine used by Spawn()
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() const noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+    }
+
+    //! Lazily started coroutine returning T
+    //! The body runs when the task is first awaited and resumes its awaiter
+    //! directly when it finishes, so chains of tasks never grow the stack.
+    template <typename T>
+    class FTPTask
+    {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        FTPTask(FTPTask &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+        FTPTask &operator=(FTPTask &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_handle)
+                {
+                    m_handle.destroy();
+                }
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+
+        FTPTask(const FTPTask &) = delete;
+        FTPTask &operator=(const FTPTask &) = delete;
+
+        ~FTPTask()
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+        {
+            m_handle.promise().m_continuation = awaiter;
+            return m_handle;
+        }
+
+        T await_resume() { return m_handle.promise().Result(); }
+
+    private:
+        friend promise_type;
+
+        explicit FTPTask(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+        std::coroutine_handle<promise_type> m_handle; //* Owned coroutine frame
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        FTPTask<T> TaskPromise<T>::get_return_object() noexcept
+        {
+            return FTPTask<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline FTPTask<void> TaskPromise<void>::get_return_object() noexcept
+        {
+            return FTPTask<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    }
+
+    //! Awaitable that starts one FTPAsyncClient operation and resumes with its result
+    //! The client completes operations on the loop thread, so the awaiting
+    //! coroutine continues there; many sessions can interleave on one loop.
+    template <typename T>
+    class FTPOperationAwaiter
+    {
+    public:
+        using Callback = std::function<void(std::exception_ptr, T)>;
+        using Starter = std::function<void(Callback)>;
+
+        explicit FTPOperationAwaiter(Starter start) : m_start(std::move(start)) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            //* The client never completes inline, so this frame is still alive when the callback runs
+            m_start([this, handle](std::exception_ptr error, T value)
+                    {
+                        m_error = error;
+                        m_value.emplace(std::move(value));
+                        handle.resume(); });
+        }
+
+        T await_resume()
+        {
+            if (m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+            return std::move(*m_value);
+        }
+
+    private:
+        Starter m_start;           //* Issues the operation
+        std::exception_ptr m_error; //* Failure reported by the client
+        std::optional<T> m_value;  //* Result reported by the client
+    };
+
+    template <>
+    class FTPOperationAwaiter<void>
+    {
+    public:
+        using Callback = std::function<void(std::exception_ptr)>;
+        using Starter = std::function<void(Callback)>;
+
+        explicit FTPOperationAwaiter(Starter start) : m_start(std::move(start)) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_start([this, handle](std::exception_ptr error)
+                    {
+                        m_error = error;
+                        handle.resume(); });
+        }
+
+        void await_resume()
+        {
+            if (m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+        }
+
+    private:
+        Starter m_start;           //* Issues the operation
+        std::exception_ptr m_error; //* Failure reported by the client
+    };
+
+    //! co_await-able versions of the FTPAsyncClient operations
+    //! @param client The client to issue the operation on; must outlive the await
+    inline FTPOperationAwaiter<void> AsyncConnect(FTPAsyncClient &client, const std::string &host, uint16_t port = 21)
+    {
+        return FTPOperationAwaiter<void>([&client, host, port](auto done)
+                                         { client.Connect(host, port, std::move(done)); });
+    }
+
+    inline FTPOperationAwaiter<void> AsyncAuthenticate(FTPAsyncClient &client, const std::string &username,
+                                                       const std::string &password)
+    {
+        return FTPOperationAwaiter<void>([&client, username, password](auto done)
+                                         { client.Authenticate(username, password, std::move(done)); });
+    }
+
+    inline FTPOperationAwaiter<std::vector<std::string>> AsyncListDirectory(FTPAsyncClient &client,
+                                                                            const std::string &remoteDir)
+    {
+        return FTPOperationAwaiter<std::vector<std::string>>([&client, remoteDir](auto done)
+                                                             { client.ListDirectory(remoteDir, std::move(done)); });
+    }
+
+    inline FTPOperationAwaiter<TransferStats> AsyncDownloadFile(FTPAsyncClient &client, const std::string &remoteFilePath,
+                                                                const std::string &localFilePath)
+    {
+        return FTPOperationAwaiter<TransferStats>([&client, remoteFilePath, localFilePath](auto done)
+                                                  { client.DownloadFile(remoteFilePath, localFilePath, std::move(done)); });
+    }
+
+    inline FTPOperationAwaiter<TransferStats> AsyncUploadFile(FTPAsyncClient &client, const std::string &localFilePath,
+                                                              const std::string &remoteFilePath)
+    {
+        return FTPOperationAwaiter<TransferStats>([&client, localFilePath, remoteFilePath](auto done)
+                                                  { client.UploadFile(localFilePath, remoteFilePath, std::move(done)); });
+    }
+
+    inline FTPOperationAwaiter<void> AsyncDisconnect(FTPAsyncClient &client)
+    {
+        return FTPOperationAwaiter<void>([&client](auto done)
+                                         { client.Disconnect(std::move(done)); });
+    }
+
+    //! Start a task without awaiting it
+    //! @param task The task to run; it starts immediately on the calling thread
+    //! @param done Optional callback invoked with the task's failure (or null) when it finishes
+    template <typename T>
+    detail::DetachedTask Spawn(FTPTask<T> task, std::function<void(std::exception_ptr)> done = {})
+    {
+        std::exception_ptr error;
+        try
+        {
+            co_await task;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        if (done)
+        {
+            done(error);
+        }
+    }
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,373 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPEventLoop.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:14:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPEventLoop.h>
+
+namespace ftp_library
+{
+
+#if defined(__linux__)
+    //! Translate loop flags to epoll flags
+    static uint32_t ToEpoll(uint32_t events)
+    {
+        uint32_t result = EPOLLRDHUP;
+        if (events & FTPEventLoop::kRead)
+        {
+            result |= EPOLLIN;
+        }
+        if (events & FTPEventLoop::kWrite)
+        {
+            result |= EPOLLOUT;
+        }
+        return result;
+    }
+#else
+    //! Translate loop flags to poll flags
+    static short ToPoll(uint32_t events)
+    {
+        short result = 0;
+        if (events & FTPEventLoop::kRead)
+        {
+            result |= POLLIN;
+        }
+        if (events & FTPEventLoop::kWrite)
+        {
+            result |= POLLOUT;
+        }
+        return result;
+    }
+#endif
+
+    //! Constructor
+    FTPEventLoop::FTPEventLoop() : m_stopped(false), m_wakeRead(-1), m_wakeWrite(-1)
+    {
+#if defined(__linux__)
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0)
+        {
+            throw FTPException("Failed to create epoll instance.");
+        }
+        m_wakeRead = m_wakeWrite = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeRead < 0)
+        {
+            close(m_epoll);
+            throw FTPException("Failed to create wakeup event.");
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = m_wakeRead;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeRead, &event);
+#elif !defined(_WIN32) && !defined(_WIN64)
+        int fds[2];
+        if (pipe(fds) < 0)
+        {
+            throw FTPException("Failed to create wakeup pipe.");
+        }
+        m_wakeRead = fds[0];
+        m_wakeWrite = fds[1];
+        SetNonBlocking(m_wakeRead);
+        SetNonBlocking(m_wakeWrite);
+#endif
+    }
+
+    //! Destructor
+    FTPEventLoop::~FTPEventLoop()
+    {
+#if defined(__linux__)
+        close(m_wakeRead);
+        close(m_epoll);
+#elif !defined(_WIN32) && !defined(_WIN64)
+        close(m_wakeRead);
+        close(m_wakeWrite);
+#endif
+    }
+
+    //! Start watching a socket
+    //@ param fd The socket to watch
+    //@ param events The readiness flags of interest
+    //@ param handler Called with the ready flags
+    void FTPEventLoop::Watch(int fd, uint32_t events, Handler handler)
+    {
+        m_watchers[fd] = {events, std::make_shared<Handler>(std::move(handler))};
+#if defined(__linux__)
+        epoll_event event{};
+        event.events = ToEpoll(events);
+        event.data.fd = fd;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            m_watchers.erase(fd);
+            throw FTPException("Failed to watch socket.");
+        }
+#endif
+    }
+
+    //! Change the readiness flags of a watched socket
+    //@ param fd The watched socket
+    //@ param events The new readiness flags of interest
+    void FTPEventLoop::Modify(int fd, uint32_t events)
+    {
+        auto it = m_watchers.find(fd);
+        if (it == m_watchers.end() || it->second.events == events)
+        {
+            return;
+        }
+        it->second.events = events;
+#if defined(__linux__)
+        epoll_event event{};
+        event.events = ToEpoll(events);
+        event.data.fd = fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event);
+#endif
+    }
+
+    //! Replace the handler of a watched socket
+    //@ param fd The watched socket
+    //@ param events The new readiness flags of interest
+    //@ param handler The new handler
+    void FTPEventLoop::Rewatch(int fd, uint32_t events, Handler handler)
+    {
+        auto it = m_watchers.find(fd);
+        if (it == m_watchers.end())
+        {
+            Watch(fd, events, std::move(handler));
+            return;
+        }
+        it->second.handler = std::make_shared<Handler>(std::move(handler));
+        Modify(fd, events);
+    }
+
+    //! Stop watching a socket
+    //@ param fd The watched socket
+    void FTPEventLoop::Unwatch(int fd)
+    {
+        if (m_watchers.erase(fd) > 0)
+        {
+#if defined(__linux__)
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        }
+    }
+
+    //! Queue a task to run on the loop thread
+    //@ param task The task to run
+    void FTPEventLoop::Post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_taskMutex);
+            m_tasks.push_back(std::move(task));
+        }
+        Wake();
+    }
+
+    //! Run the loop until Stop() is called
+    void FTPEventLoop::Run()
+    {
+        m_stopped = false;
+        while (!m_stopped)
+        {
+            RunOnce(-1);
+        }
+    }
+
+    //! Wait for events once and dispatch them
+    //@ param timeoutMs The maximum time to wait in milliseconds (-1 = forever)
+    //@ return The number of handlers and tasks run
+    size_t FTPEventLoop::RunOnce(int timeoutMs)
+    {
+        size_t dispatched = RunTasks();
+        if (dispatched > 0)
+        {
+            timeoutMs = 0;
+        }
+
+        std::vector<std::pair<int, uint32_t>> ready;
+
+#if defined(__linux__)
+        epoll_event events[64];
+        int count = epoll_wait(m_epoll, events, 64, timeoutMs);
+        for (int i = 0; i < count; ++i)
+        {
+            int fd = events[i].data.fd;
+            if (fd == m_wakeRead)
+            {
+                uint64_t value;
+                while (read(m_wakeRead, &value, sizeof(value)) > 0)
+                {
+                }
+                continue;
+            }
+
+            uint32_t flags = 0;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP))
+            {
+                flags |= kRead;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                flags |= kWrite;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                flags |= kError | kRead;
+            }
+            ready.emplace_back(fd, flags);
+        }
+#else
+        std::vector<pollfd> fds;
+        fds.reserve(m_watchers.size() + 1);
+        for (const auto &[fd, watcher] : m_watchers)
+        {
+            pollfd entry{};
+            entry.fd = fd;
+            entry.events = ToPoll(watcher.events);
+            fds.push_back(entry);
+        }
+#if defined(_WIN32) || defined(_WIN64)
+        //* No wakeup channel for WSAPoll, so bound the wait to pick up posted tasks
+        if (timeoutMs < 0 || timeoutMs > 20)
+        {
+            timeoutMs = 20;
+        }
+        int count = fds.empty() ? (Sleep(timeoutMs), 0) : WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeoutMs);
+#else
+        pollfd wake{};
+        wake.fd = m_wakeRead;
+        wake.events = POLLIN;
+        fds.push_back(wake);
+        int count = poll(fds.data(), fds.size(), timeoutMs);
+#endif
+        for (int i = 0; count > 0 && i < static_cast<int>(fds.size()); ++i)
+        {
+            if (fds[i].revents == 0)
+            {
+                continue;
+            }
+#if !defined(_WIN32) && !defined(_WIN64)
+            if (fds[i].fd == m_wakeRead)
+            {
+                char drain[64];
+                while (read(m_wakeRead, drain, sizeof(drain)) > 0)
+                {
+                }
+                continue;
+            }
+#endif
+
+            uint32_t flags = 0;
+            if (fds[i].revents & POLLIN)
+            {
+                flags |= kRead;
+            }
+            if (fds[i].revents & POLLOUT)
+            {
+                flags |= kWrite;
+            }
+            if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+            {
+                flags |= kError | kRead;
+            }
+            ready.emplace_back(static_cast<int>(fds[i].fd), flags);
+        }
+#endif
+
+        for (const auto &[fd, flags] : ready)
+        {
+            //* Look the handler up again: an earlier handler may have unwatched this socket
+            auto it = m_watchers.find(fd);
+            if (it == m_watchers.end())
+            {
+                continue;
+            }
+            std::shared_ptr<Handler> handler = it->second.handler;
+            (*handler)(flags);
+            ++dispatched;
+        }
+
+        return dispatched + RunTasks();
+    }
+
+    //! Ask Run() to return
+    void FTPEventLoop::Stop()
+    {
+        m_stopped = true;
+        Wake();
+    }
+
+    //! Put a socket into non-blocking mode
+    //@ param fd The socket
+    void FTPEventLoop::SetNonBlocking(int fd)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        u_long mode = 1;
+        ioctlsocket(fd, FIONBIO, &mode);
+#else
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+#endif
+    }
+
+    //! Put a socket back into blocking mode
+    //@ param fd The socket
+    void FTPEventLoop::SetBlocking(int fd)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        u_long mode = 0;
+        ioctlsocket(fd, FIONBIO, &mode);
+#else
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+#endif
+    }
+
+    //! Check whether the last socket call failed only because it would block
+    //@ return True for EAGAIN/EWOULDBLOCK/EINPROGRESS
+    bool FTPEventLoop::WouldBlock()
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        int error = WSAGetLastError();
+        return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS || errno == EINTR;
+#endif
+    }
+
+    //! Interrupt a blocking wait
+    void FTPEventLoop::Wake()
+    {
+#if defined(__linux__)
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeWrite, &one, sizeof(one));
+        (void)written;
+#elif !defined(_WIN32) && !defined(_WIN64)
+        char one = 1;
+        ssize_t written = write(m_wakeWrite, &one, 1);
+        (void)written;
+#endif
+    }
+
+    //! Run the posted tasks
+    //@ return The number of tasks run
+    size_t FTPEventLoop::RunTasks()
+    {
+        std::vector<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_taskMutex);
+            tasks.swap(m_tasks);
+        }
+        for (auto &task : tasks)
+        {
+            task();
+        }
+        return tasks.size();
+    }
+
+}
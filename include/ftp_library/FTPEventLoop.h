@@ -0,0 +1,122 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPEventLoop.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:14:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPEVENTLOOP_H
+#define FTPEVENTLOOP_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Single-threaded readiness loop for non-blocking sockets
+    //! Uses epoll on Linux and poll (WSAPoll on Windows) elsewhere. Handlers
+    //! run on the thread that calls Run(); Post() is the only thread-safe entry.
+    class FTPEventLoop
+    {
+    public:
+        //! Readiness flags passed to Watch() and to handlers
+        enum Events : uint32_t
+        {
+            kRead = 1,
+            kWrite = 2,
+            kError = 4
+        };
+
+        using Handler = std::function<void(uint32_t events)>;
+
+        //! Constructor and destructor
+        FTPEventLoop();
+        ~FTPEventLoop();
+
+        //! Prevent copy construction and assignment
+        FTPEventLoop(const FTPEventLoop &) = delete;
+        FTPEventLoop &operator=(const FTPEventLoop &) = delete;
+
+        //! Start watching a socket
+        //! @param fd The socket to watch
+        //! @param events The readiness flags of interest (kRead, kWrite)
+        //! @param handler Called with the ready flags; kError is always reported
+        void Watch(int fd, uint32_t events, Handler handler);
+
+        //! Change the readiness flags of a watched socket
+        //! @param fd The watched socket
+        //! @param events The new readiness flags of interest
+        void Modify(int fd, uint32_t events);
+
+        //! Replace the handler of a watched socket
+        //! @param fd The watched socket
+        //! @param events The new readiness flags of interest
+        //! @param handler The new handler
+        void Rewatch(int fd, uint32_t events, Handler handler);
+
+        //! Stop watching a socket (does not close it)
+        //! @param fd The watched socket
+        void Unwatch(int fd);
+
+        //! Queue a task to run on the loop thread; safe to call from any thread
+        //! @param task The task to run
+        void Post(std::function<void()> task);
+
+        //! Run the loop until Stop() is called
+        void Run();
+
+        //! Wait for events once and dispatch them
+        //! @param timeoutMs The maximum time to wait in milliseconds (-1 = forever)
+        //! @return The number of handlers and tasks run
+        size_t RunOnce(int timeoutMs = -1);
+
+        //! Ask Run() to return; safe to call from any thread
+        void Stop();
+
+        //! Get the number of watched sockets
+        size_t WatchCount() const
+        {
+            return m_watchers.size();
+        }
+
+        //! Put a socket into non-blocking mode
+        //! @param fd The socket
+        static void SetNonBlocking(int fd);
+
+        //! Put a socket back into blocking mode
+        //! @param fd The socket
+        static void SetBlocking(int fd);
+
+        //! Check whether the last socket call failed only because it would block
+        //! @return True for EAGAIN/EWOULDBLOCK/EINPROGRESS (or the Winsock equivalents)
+        static bool WouldBlock();
+
+    private:
+        struct Watcher
+        {
+            uint32_t events;                  //* Readiness flags of interest
+            std::shared_ptr<Handler> handler; //* Shared so a handler can unwatch itself safely
+        };
+
+        void Wake();     //* Interrupt a blocking wait
+        size_t RunTasks(); //* Run the posted tasks
+
+        std::unordered_map<int, Watcher> m_watchers;  //* Watched sockets
+        std::mutex m_taskMutex;                       //* Guards m_tasks
+        std::vector<std::function<void()>> m_tasks;   //* Tasks posted from any thread
+        std::atomic<bool> m_stopped;                  //* Set by Stop()
+        int m_wakeRead;                               //* Read end of the wakeup channel
+        int m_wakeWrite;                              //* Write end of the wakeup channel
+#if defined(__linux__)
+        int m_epoll; //* epoll instance
+#endif
+    };
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListenerPool.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:14:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPListenerPool.h>
+
+namespace ftp_library
+{
+
+    //! Check whether two addresses have the same family and IP, whatever the port
+    //@ param a The first address
+    //@ param b The second address
+    //@ return True if a listener bound to one serves the other
+    static bool SameHost(const sockaddr_storage &a, const sockaddr_storage &b)
+    {
+        if (a.ss_family != b.ss_family)
+        {
+            return false;
+        }
+        if (a.ss_family == AF_INET6)
+        {
+            return std::memcmp(&reinterpret_cast<const sockaddr_in6 &>(a).sin6_addr,
+                               &reinterpret_cast<const sockaddr_in6 &>(b).sin6_addr, sizeof(in6_addr)) == 0;
+        }
+        return reinterpret_cast<const sockaddr_in &>(a).sin_addr.s_addr ==
+               reinterpret_cast<const sockaddr_in &>(b).sin_addr.s_addr;
+    }
+
+    //! Set the port of an IPv4 or IPv6 address
+    //@ param address The address to change
+    //@ param port The port number
+    static void SetPort(sockaddr_storage &address, uint16_t port)
+    {
+        if (address.ss_family == AF_INET6)
+        {
+            reinterpret_cast<sockaddr_in6 &>(address).sin6_port = htons(port);
+        }
+        else
+        {
+            reinterpret_cast<sockaddr_in &>(address).sin_port = htons(port);
+        }
+    }
+
+    //! Constructor
+    //@ param firstPort First port of the range, 0 to let the system pick
+    //@ param lastPort Last port of the range, inclusive
+    //@ param maxIdle Maximum number of listeners kept open between transfers
+    FTPListenerPool::FTPListenerPool(uint16_t firstPort, uint16_t lastPort, size_t maxIdle)
+        : m_firstPort(firstPort), m_lastPort(std::max(firstPort, lastPort)), m_nextPort(firstPort),
+          m_maxIdle(maxIdle)
+    {
+    }
+
+    //! Destructor; closes the idle listeners
+    FTPListenerPool::~FTPListenerPool()
+    {
+        for (const auto &listener : m_idle)
+        {
+            closesocket(listener.socket);
+        }
+    }
+
+    //! Announce this IPv4 address in PORT instead of the local one
+    //@ param address The address, or an empty string to announce the local one
+    void FTPListenerPool::SetAdvertisedAddress(const std::string &address)
+    {
+        in_addr parsed{};
+        if (!address.empty() && inet_pton(AF_INET, address.c_str(), &parsed) != 1)
+        {
+            throw std::invalid_argument("Advertised address must be an IPv4 address: " + address);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_advertisedAddress = address;
+    }
+
+    //! Get the address announced in PORT
+    //@ return The address, empty if the local one is used
+    std::string FTPListenerPool::GetAdvertisedAddress() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_advertisedAddress;
+    }
+
+    //! Get a listener on the local address of a control connection
+    //@ param local The local address of the control connection
+    //@ param announced Receives the address to send with PORT or EPRT
+    //@ return The listening socket, non-blocking
+    int FTPListenerPool::Acquire(const ResolvedAddress &local, ResolvedAddress &announced)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int listener = -1;
+        for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it)
+        {
+            if (SameHost(it->address, local.address))
+            {
+                listener = it->socket;
+                announced.address = it->address;
+                m_idle.erase(std::next(it).base());
+                break;
+            }
+        }
+
+        if (listener >= 0)
+        {
+            //* A connection left over from an abandoned transfer must not be taken for the next one
+            for (int stale; (stale = static_cast<int>(accept(listener, nullptr, nullptr))) >= 0;)
+            {
+                closesocket(stale);
+            }
+        }
+        else
+        {
+            listener = Bind(local);
+            socklen_t length = sizeof(announced.address);
+            getsockname(listener, reinterpret_cast<sockaddr *>(&announced.address), &length);
+        }
+
+        announced.length = announced.Family() == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        if (announced.Family() == AF_INET && !m_advertisedAddress.empty())
+        {
+            inet_pton(AF_INET, m_advertisedAddress.c_str(),
+                      &reinterpret_cast<sockaddr_in &>(announced.address).sin_addr);
+        }
+        return listener;
+    }
+
+    //! Open a new listener on the local address, walking the port range (m_mutex held)
+    //@ param local The address to listen on
+    //@ return The listening socket, non-blocking
+    int FTPListenerPool::Bind(const ResolvedAddress &local)
+    {
+        sockaddr_storage address = local.address;
+        socklen_t length = local.Family() == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        uint32_t attempts = m_firstPort == 0 ? 1 : static_cast<uint32_t>(m_lastPort - m_firstPort) + 1;
+
+        for (uint32_t attempt = 0; attempt < attempts; ++attempt)
+        {
+            uint16_t port = m_nextPort;
+            if (m_firstPort != 0)
+            {
+                //* Start after the last port handed out, so a port in TIME_WAIT gets time to clear
+                m_nextPort = port >= m_lastPort ? m_firstPort : static_cast<uint16_t>(port + 1);
+            }
+
+            int listener = static_cast<int>(socket(local.Family(), SOCK_STREAM, IPPROTO_TCP));
+            if (listener < 0)
+            {
+                throw FTPException("Failed to create listening socket.", -1);
+            }
+#if !defined(_WIN32) && !defined(_WIN64)
+            //* Lets a port be listened on again while connections it accepted are still in TIME_WAIT
+            int reuse = 1;
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+#endif
+            SetPort(address, port);
+            if (bind(listener, reinterpret_cast<const sockaddr *>(&address), length) == 0 &&
+                listen(listener, 4) == 0)
+            {
+                FTPEventLoop::SetNonBlocking(listener);
+                return listener;
+            }
+            closesocket(listener);
+        }
+        throw FTPException("No free port for an active mode data connection.", -1);
+    }
+
+    //! Return a listener after its transfer
+    //@ param listener The socket from Acquire
+    //@ param reusable False if a late connection may still arrive on it
+    void FTPListenerPool::Release(int listener, bool reusable)
+    {
+        if (listener < 0)
+        {
+            return;
+        }
+        Listener idle{listener, {}};
+        socklen_t length = sizeof(idle.address);
+        bool bound = getsockname(listener, reinterpret_cast<sockaddr *>(&idle.address), &length) == 0;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (reusable && bound && m_idle.size() < m_maxIdle)
+        {
+            m_idle.push_back(idle);
+            return;
+        }
+        closesocket(listener);
+    }
+
+    //! Get the number of listeners kept open for reuse
+    //@ return The number of idle listeners
+    size_t FTPListenerPool::IdleCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_idle.size();
+    }
+
+}
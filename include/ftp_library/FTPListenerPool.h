@@ -0,0 +1,83 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListenerPool.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:14:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPLISTENERPOOL_H
+#define FTPLISTENERPOOL_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    struct ResolvedAddress;
+
+    //! Listening sockets for active mode (PORT/EPRT) data connections
+    //! A listener stays open after its transfer and is handed to the next one on
+    //! the same local address, so a session does not bind, listen and close for
+    //! every file. New listeners take their port from the configured range, which
+    //! is what a firewall in front of the client has to let through; without a
+    //! range the system picks one. Safe to share between clients.
+    class FTPListenerPool
+    {
+    public:
+        //! Constructor
+        //! @param firstPort First port of the range, 0 to let the system pick
+        //! @param lastPort Last port of the range, inclusive
+        //! @param maxIdle Maximum number of listeners kept open between transfers
+        explicit FTPListenerPool(uint16_t firstPort = 0, uint16_t lastPort = 0, size_t maxIdle = 8);
+        ~FTPListenerPool();
+
+        FTPListenerPool(const FTPListenerPool &) = delete;
+        FTPListenerPool &operator=(const FTPListenerPool &) = delete;
+
+        //! Announce this IPv4 address in PORT instead of the local one, e.g. the public address behind NAT
+        //! @param address The address, or an empty string to announce the local one
+        void SetAdvertisedAddress(const std::string &address);
+
+        //! Get the address announced in PORT, empty if the local one is used
+        std::string GetAdvertisedAddress() const;
+
+        //! Get a listener on the local address of a control connection
+        //! @param local The local address of the control connection; its port is ignored
+        //! @param announced Receives the address to send with PORT or EPRT
+        //! @return The listening socket, non-blocking; throws FTPException if no port in the range is free
+        int Acquire(const ResolvedAddress &local, ResolvedAddress &announced);
+
+        //! Return a listener after its transfer
+        //! @param listener The socket from Acquire
+        //! @param reusable False if a late connection may still arrive on it; it is closed instead
+        void Release(int listener, bool reusable = true);
+
+        //! Get the number of listeners kept open for reuse
+        size_t IdleCount() const;
+
+    private:
+        struct Listener
+        {
+            int socket;                //* The listening socket
+            sockaddr_storage address;  //* Address and port it is bound to
+        };
+
+        int Bind(const ResolvedAddress &local); //* Open a new listener, walking the port range
+
+        uint16_t m_firstPort;            //* First port of the range, 0 for any
+        uint16_t m_lastPort;             //* Last port of the range
+        uint16_t m_nextPort;             //* Where the next search of the range starts
+        size_t m_maxIdle;                //* Maximum number of idle listeners
+        std::string m_advertisedAddress; //* IPv4 address for PORT, empty for the local one
+        std::vector<Listener> m_idle;    //* Listeners waiting for a transfer
+        mutable std::mutex m_mutex;      //* Guards all members
+    };
+
+}
+
+#endif
@@ -0,0 +1,289 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListingCache.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:35:57 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPListingCache.h>
+
+namespace ftp_library
+{
+
+    //! First line of every cache file
+    static const char *const kCacheHeader = "# ftp-listing-cache v1";
+
+    //! Constructor
+    //@ param ttl How long a listing is served without refreshing
+    //@ param staleWindow How long after the TTL a stale listing may still be served
+    FTPListingCache::FTPListingCache(std::chrono::seconds ttl, std::chrono::seconds staleWindow)
+        : m_ttl(std::chrono::duration_cast<std::chrono::milliseconds>(ttl).count()),
+          m_staleWindow(std::chrono::duration_cast<std::chrono::milliseconds>(staleWindow).count())
+    {
+    }
+
+    //! Look up a listing
+    //@ param host The server, as "host:port"
+    //@ param remoteDir The absolute directory path
+    //@ param entries Receives the cached listing unless the result is Miss
+    //@ return The freshness of the cached listing
+    FTPListingCache::State FTPListingCache::Lookup(const std::string &host, const std::string &remoteDir,
+                                                   std::vector<std::string> &entries) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(Key(host, remoteDir));
+        if (it == m_entries.end())
+        {
+            return State::Miss;
+        }
+
+        int64_t age = Now() - it->second.stored;
+        if (age >= m_ttl + m_staleWindow)
+        {
+            return State::Miss;
+        }
+        entries = it->second.lines;
+        return age < m_ttl ? State::Fresh : State::Stale;
+    }
+
+    //! Claim the refresh of a stale listing
+    //@ param host The server, as "host:port"
+    //@ param remoteDir The absolute directory path
+    //@ return True if the caller should refresh the listing
+    bool FTPListingCache::BeginRefresh(const std::string &host, const std::string &remoteDir)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(Key(host, remoteDir));
+        if (it == m_entries.end())
+        {
+            return true;
+        }
+        if (it->second.refreshing)
+        {
+            return false;
+        }
+        it->second.refreshing = true;
+        return true;
+    }
+
+    //! Give up a claimed refresh
+    //@ param host The server, as "host:port"
+    //@ param remoteDir The absolute directory path
+    void FTPListingCache::CancelRefresh(const std::string &host, const std::string &remoteDir)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(Key(host, remoteDir));
+        if (it != m_entries.end())
+        {
+            it->second.refreshing = false;
+        }
+    }
+
+    //! Store a freshly received listing
+    //@ param host The server, as "host:port"
+    //@ param remoteDir The absolute directory path
+    //@ param entries The listing lines
+    void FTPListingCache::Store(const std::string &host, const std::string &remoteDir, std::vector<std::string> entries)
+    {
+        Entry entry;
+        entry.lines = std::move(entries);
+        entry.stored = Now();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[Key(host, remoteDir)] = std::move(entry);
+    }
+
+    //! Drop one directory
+    //@ param host The server, as "host:port"
+    //@ param remoteDir The absolute directory path
+    void FTPListingCache::Invalidate(const std::string &host, const std::string &remoteDir)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.erase(Key(host, remoteDir));
+    }
+
+    //! Drop the directory that contains a file or subdirectory
+    //@ param host The server, as "host:port"
+    //@ param remotePath The absolute path of the changed file
+    void FTPListingCache::InvalidateParent(const std::string &host, const std::string &remotePath)
+    {
+        Invalidate(host, ParentDirectory(remotePath));
+    }
+
+    //! Drop every listing
+    void FTPListingCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    //! Get the number of cached listings
+    size_t FTPListingCache::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    //! Load a cache file, replacing the current contents
+    //@ param path The cache file
+    void FTPListingCache::Load(const std::string &path)
+    {
+        std::unordered_map<std::string, Entry> entries;
+
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file)
+        {
+            //* "D <stored>\t<key>" starts a listing, each "L <line>" that follows belongs to it
+            Entry *current = nullptr;
+            std::string line;
+            char buffer[4096];
+            while (fgets(buffer, sizeof(buffer), file))
+            {
+                line += buffer;
+                if (line.empty() || line.back() != '\n')
+                {
+                    continue; //* Long line, keep reading
+                }
+                line.pop_back();
+
+                if (line.compare(0, 2, "D ") == 0)
+                {
+                    char *end = nullptr;
+                    int64_t stored = std::strtoll(line.c_str() + 2, &end, 10);
+                    current = nullptr;
+                    if (*end == '\t' && end[1] != '\0')
+                    {
+                        current = &entries[std::string(end + 1)];
+                        current->lines.clear();
+                        current->stored = stored;
+                    }
+                }
+                else if (line.compare(0, 2, "L ") == 0 && current)
+                {
+                    current->lines.push_back(line.substr(2));
+                }
+                line.clear();
+            }
+            fclose(file);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries = std::move(entries);
+    }
+
+    //! Write the cache atomically
+    //@ param path The cache file
+    void FTPListingCache::Save(const std::string &path) const
+    {
+        std::string temporary = path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            throw FTPException("Failed to open listing cache for writing: " + temporary, -1);
+        }
+
+        bool ok = fprintf(file, "%s\n", kCacheHeader) > 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            int64_t now = Now();
+            for (const auto &[key, entry] : m_entries)
+            {
+                if (now - entry.stored >= m_ttl + m_staleWindow)
+                {
+                    continue; //* Expired, would be a miss after loading anyway
+                }
+                ok = ok && fprintf(file, "D %lld\t%s\n", static_cast<long long>(entry.stored), key.c_str()) > 0;
+                for (const auto &entryLine : entry.lines)
+                {
+                    ok = ok && fprintf(file, "L %s\n", entryLine.c_str()) > 0;
+                }
+            }
+        }
+        ok = fclose(file) == 0 && ok;
+
+        std::error_code error;
+        if (ok)
+        {
+            std::filesystem::rename(temporary, path, error);
+        }
+        if (!ok || error)
+        {
+            std::filesystem::remove(temporary, error);
+            throw FTPException("Failed to write listing cache: " + path, -1);
+        }
+    }
+
+    //! Resolve a remote path against a working directory
+    //@ param workingDir The absolute directory relative paths start from
+    //@ param remotePath The path to resolve
+    //@ return The absolute path
+    std::string FTPListingCache::ResolvePath(const std::string &workingDir, const std::string &remotePath)
+    {
+        std::string path = FTPUtilities::Trim(remotePath);
+        if (path.empty() || path[0] != '/')
+        {
+            path = workingDir + "/" + path;
+        }
+
+        std::vector<std::string> segments;
+        size_t start = 0;
+        while (start <= path.size())
+        {
+            size_t end = path.find('/', start);
+            if (end == std::string::npos)
+            {
+                end = path.size();
+            }
+            std::string segment = path.substr(start, end - start);
+            if (segment == "..")
+            {
+                if (!segments.empty())
+                {
+                    segments.pop_back();
+                }
+            }
+            else if (!segment.empty() && segment != ".")
+            {
+                segments.push_back(std::move(segment));
+            }
+            start = end + 1;
+        }
+
+        std::string resolved;
+        for (const auto &segment : segments)
+        {
+            resolved += "/" + segment;
+        }
+        return resolved.empty() ? "/" : resolved;
+    }
+
+    //! Get the directory part of an absolute path
+    //@ param remotePath The absolute path
+    //@ return The parent directory
+    std::string FTPListingCache::ParentDirectory(const std::string &remotePath)
+    {
+        std::string path = ResolvePath("/", remotePath);
+        size_t slash = path.find_last_of('/');
+        return slash == 0 ? "/" : path.substr(0, slash);
+    }
+
+    //! Build the map key for a directory
+    std::string FTPListingCache::Key(const std::string &host, const std::string &remoteDir)
+    {
+        return host + " " + ResolvePath("/", remoteDir);
+    }
+
+    //! Get the current wall clock time in milliseconds since the epoch
+    int64_t FTPListingCache::Now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+}
@@ -0,0 +1,124 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListingCache.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:35:57 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPLISTINGCACHE_H
+#define FTPLISTINGCACHE_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! In-memory cache of directory listings keyed by host and path
+    //! An entry younger than the TTL is fresh and is served without touching
+    //! the network. After that it stays usable as a stale copy for the stale
+    //! window, while the caller refreshes it (stale-while-revalidate). Uploads
+    //! and directory creation invalidate the parent directory. The cache can be
+    //! saved to and loaded from a text file and is safe to share between clients.
+    class FTPListingCache
+    {
+    public:
+        //! Freshness of a cached listing
+        enum class State
+        {
+            Miss,  //* Not cached, or older than TTL + stale window
+            Fresh, //* Younger than the TTL
+            Stale  //* Usable, but should be refreshed
+        };
+
+        //! Constructor
+        //! @param ttl How long a listing is served without refreshing
+        //! @param staleWindow How long after the TTL a stale listing may still be served
+        explicit FTPListingCache(std::chrono::seconds ttl = std::chrono::seconds(30),
+                                 std::chrono::seconds staleWindow = std::chrono::seconds(300));
+
+        //! Look up a listing
+        //! @param host The server, as "host:port"
+        //! @param remoteDir The absolute directory path
+        //! @param entries Receives the cached listing unless the result is Miss
+        //! @return The freshness of the cached listing
+        State Lookup(const std::string &host, const std::string &remoteDir, std::vector<std::string> &entries) const;
+
+        //! Claim the refresh of a stale listing so concurrent lookups do not all refresh it
+        //! @param host The server, as "host:port"
+        //! @param remoteDir The absolute directory path
+        //! @return True if the caller should refresh the listing
+        bool BeginRefresh(const std::string &host, const std::string &remoteDir);
+
+        //! Give up a refresh claimed with BeginRefresh without storing a listing
+        //! @param host The server, as "host:port"
+        //! @param remoteDir The absolute directory path
+        void CancelRefresh(const std::string &host, const std::string &remoteDir);
+
+        //! Store a freshly received listing
+        //! @param host The server, as "host:port"
+        //! @param remoteDir The absolute directory path
+        //! @param entries The listing lines
+        void Store(const std::string &host, const std::string &remoteDir, std::vector<std::string> entries);
+
+        //! Drop one directory
+        //! @param host The server, as "host:port"
+        //! @param remoteDir The absolute directory path
+        void Invalidate(const std::string &host, const std::string &remoteDir);
+
+        //! Drop the directory that contains a file or subdirectory
+        //! @param host The server, as "host:port"
+        //! @param remotePath The absolute path of the changed file
+        void InvalidateParent(const std::string &host, const std::string &remotePath);
+
+        //! Drop every listing
+        void Clear();
+
+        //! Get the number of cached listings
+        size_t Size() const;
+
+        //! Load a cache file, replacing the current contents
+        //! A missing file yields an empty cache; malformed records are skipped.
+        //! @param path The cache file
+        void Load(const std::string &path);
+
+        //! Write the cache atomically (temporary file plus rename)
+        //! @param path The cache file
+        void Save(const std::string &path) const;
+
+        //! Resolve a remote path against a working directory
+        //! Collapses repeated and trailing slashes, "." and ".." segments.
+        //! @param workingDir The absolute directory relative paths start from
+        //! @param remotePath The path to resolve
+        //! @return The absolute path
+        static std::string ResolvePath(const std::string &workingDir, const std::string &remotePath);
+
+        //! Get the directory part of an absolute path
+        //! @param remotePath The absolute path
+        //! @return The parent directory ("/" for top-level entries)
+        static std::string ParentDirectory(const std::string &remotePath);
+
+    private:
+        struct Entry
+        {
+            std::vector<std::string> lines; //* Listing lines
+            int64_t stored = 0;             //* When the listing was received, in ms since the epoch
+            bool refreshing = false;        //* A refresh has been claimed
+        };
+
+        static std::string Key(const std::string &host, const std::string &remoteDir);
+        static int64_t Now();
+
+        std::unordered_map<std::string, Entry> m_entries; //* Listings by "host:port path"
+        int64_t m_ttl;                                    //* TTL in milliseconds
+        int64_t m_staleWindow;                            //* Stale window in milliseconds
+        mutable std::mutex m_mutex;                       //* Guards m_entries
+    };
+
+}
+
+#endif
@@ -0,0 +1,475 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListingParser.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:38:33 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPListingParser.h>
+
+namespace ftp_library
+{
+
+    //! Size of each arena block; longer names get a block of their own
+    static constexpr size_t kArenaBlockSize = 64 * 1024;
+
+    //! Seconds in a day
+    static constexpr int64_t kSecondsPerDay = 86400;
+
+    //! Convert a civil date to days since 1970-01-01 (proleptic Gregorian)
+    static int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+        const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+    }
+
+    //! Get the year containing a UTC timestamp
+    static int64_t YearFromTime(int64_t seconds)
+    {
+        int64_t days = seconds / kSecondsPerDay - (seconds % kSecondsPerDay < 0);
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+        const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+        return static_cast<int64_t>(yearOfEra) + era * 400 + (monthIndex >= 10);
+    }
+
+    //! Parse an unsigned decimal number
+    //@ param text The digits
+    //@ param value Receives the value
+    //@ return True if text was a non-empty run of digits
+    static bool ParseNumber(std::string_view text, uint64_t &value)
+    {
+        if (text.empty())
+        {
+            return false;
+        }
+        value = 0;
+        for (char c : text)
+        {
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        return true;
+    }
+
+    //! Parse a fixed-width decimal field
+    static unsigned ParseDigits(const char *text, size_t count)
+    {
+        unsigned value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            value = value * 10 + static_cast<unsigned>(text[i] - '0');
+        }
+        return value;
+    }
+
+    //! Compare two strings ignoring ASCII case
+    static bool EqualsNoCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Split the next whitespace separated field off the front of a line
+    static std::string_view NextField(std::string_view &line)
+    {
+        size_t start = line.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            line = {};
+            return {};
+        }
+        size_t end = line.find(' ', start);
+        std::string_view field = line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        line = end == std::string_view::npos ? std::string_view() : line.substr(end);
+        return field;
+    }
+
+    //! Get the month number (1-12) of a three letter English month name
+    static unsigned MonthFromName(std::string_view name)
+    {
+        static const char *const kMonths[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                              "jul", "aug", "sep", "oct", "nov", "dec"};
+        for (unsigned i = 0; i < 12; ++i)
+        {
+            if (EqualsNoCase(name, kMonths[i]))
+            {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    //! Parse "rwxr-xr-x" into permission bits
+    static uint16_t ParsePermissions(std::string_view mode)
+    {
+        uint16_t perms = 0;
+        for (size_t i = 0; i < 9 && i < mode.size(); ++i)
+        {
+            char c = mode[i];
+            if (c != '-' && c != 'S' && c != 'T')
+            {
+                perms |= static_cast<uint16_t>(1u << (8 - i));
+            }
+        }
+        return perms;
+    }
+
+    //! Parse a Unix "ls -l" line
+    static bool ParseUnixLine(std::string_view line, DirEntry &entry, int64_t now)
+    {
+        std::string_view rest = line;
+        std::string_view mode = NextField(rest);
+        if (mode.size() < 10)
+        {
+            return false; //* "total 123" and anything else that is not an entry
+        }
+
+        switch (mode[0])
+        {
+        case '-':
+            entry.type = EntryType::File;
+            break;
+        case 'd':
+            entry.type = EntryType::Directory;
+            break;
+        case 'l':
+            entry.type = EntryType::Link;
+            break;
+        case 'b':
+        case 'c':
+        case 'p':
+        case 's':
+            entry.type = EntryType::Other;
+            break;
+        default:
+            return false;
+        }
+        entry.perms = ParsePermissions(mode.substr(1));
+
+        //* links, owner, group, size, month, day, time-or-year
+        std::string_view fields[7];
+        for (auto &field : fields)
+        {
+            field = NextField(rest);
+        }
+
+        //* Some servers omit the group column; the month then sits one field earlier
+        size_t sizeIndex = 3;
+        if (!MonthFromName(fields[4]) && MonthFromName(fields[3]))
+        {
+            if (fields[6].empty())
+            {
+                return false;
+            }
+            sizeIndex = 2;
+            rest = std::string_view(fields[6].data() - 1, line.data() + line.size() - fields[6].data() + 1);
+        }
+        if (!ParseNumber(fields[sizeIndex], entry.size))
+        {
+            return false;
+        }
+
+        unsigned month = MonthFromName(fields[sizeIndex + 1]);
+        uint64_t day = 0;
+        std::string_view when = fields[sizeIndex + 3];
+        entry.mtime = -1;
+        if (month && ParseNumber(fields[sizeIndex + 2], day) && day >= 1 && day <= 31)
+        {
+            if (when.size() == 5 && when[2] == ':')
+            {
+                //* "HH:MM" means within the last six months
+                int64_t year = YearFromTime(now);
+                int64_t seconds = DaysFromCivil(year, month, static_cast<unsigned>(day)) * kSecondsPerDay +
+                                  ParseDigits(when.data(), 2) * 3600 + ParseDigits(when.data() + 3, 2) * 60;
+                if (seconds > now + kSecondsPerDay)
+                {
+                    seconds = DaysFromCivil(year - 1, month, static_cast<unsigned>(day)) * kSecondsPerDay +
+                              ParseDigits(when.data(), 2) * 3600 + ParseDigits(when.data() + 3, 2) * 60;
+                }
+                entry.mtime = seconds;
+            }
+            else
+            {
+                uint64_t year = 0;
+                if (ParseNumber(when, year))
+                {
+                    entry.mtime = DaysFromCivil(static_cast<int64_t>(year), month, static_cast<unsigned>(day)) *
+                                  kSecondsPerDay;
+                }
+            }
+        }
+
+        //* The name is everything after a single separating space, spaces included
+        if (rest.empty() || rest[0] != ' ')
+        {
+            return false;
+        }
+        std::string_view name = rest.substr(1);
+        if (entry.type == EntryType::Link)
+        {
+            size_t arrow = name.find(" -> ");
+            if (arrow != std::string_view::npos)
+            {
+                name = name.substr(0, arrow);
+            }
+        }
+        if (name.empty() || name == "." || name == "..")
+        {
+            return false;
+        }
+        entry.name = name;
+        return true;
+    }
+
+    //! Parse an MLSD "fact=value;...; name" line
+    static bool ParseMlsdLine(std::string_view line, DirEntry &entry)
+    {
+        size_t separator = line.find(' ');
+        if (separator == std::string_view::npos)
+        {
+            return false;
+        }
+
+        std::string_view facts = line.substr(0, separator);
+        entry.name = line.substr(separator + 1);
+        entry.type = EntryType::Other;
+        entry.mtime = -1;
+
+        while (!facts.empty())
+        {
+            size_t end = facts.find(';');
+            std::string_view fact = facts.substr(0, end);
+            facts = end == std::string_view::npos ? std::string_view() : facts.substr(end + 1);
+
+            size_t equals = fact.find('=');
+            if (equals == std::string_view::npos)
+            {
+                continue;
+            }
+            std::string_view key = fact.substr(0, equals);
+            std::string_view value = fact.substr(equals + 1);
+
+            if (EqualsNoCase(key, "type"))
+            {
+                if (EqualsNoCase(value, "file"))
+                {
+                    entry.type = EntryType::File;
+                }
+                else if (EqualsNoCase(value, "dir"))
+                {
+                    entry.type = EntryType::Directory;
+                }
+                else if (EqualsNoCase(value, "cdir") || EqualsNoCase(value, "pdir"))
+                {
+                    return false;
+                }
+                else if (EqualsNoCase(value.substr(0, 8), "OS.unix=") &&
+                         value.find("link") != std::string_view::npos)
+                {
+                    entry.type = EntryType::Link; //* "OS.unix=symlink" / "OS.unix=slink:target"
+                }
+            }
+            else if (EqualsNoCase(key, "size") || EqualsNoCase(key, "sizd"))
+            {
+                ParseNumber(value, entry.size);
+            }
+            else if (EqualsNoCase(key, "modify"))
+            {
+                entry.mtime = FTPListingParser::ParseTimestamp(value);
+            }
+            else if (EqualsNoCase(key, "UNIX.mode"))
+            {
+                uint16_t perms = 0;
+                for (char c : value)
+                {
+                    if (c < '0' || c > '7')
+                    {
+                        perms = 0;
+                        break;
+                    }
+                    perms = static_cast<uint16_t>((perms << 3) | (c - '0'));
+                }
+                entry.perms = perms & 0777;
+            }
+        }
+
+        return !entry.name.empty() && entry.name != "." && entry.name != "..";
+    }
+
+    //! Constructor
+    //@ param format The listing format to expect
+    FTPListingParser::FTPListingParser(Format format)
+        : m_format(format), m_now(static_cast<int64_t>(std::time(nullptr))), m_blockUsed(kArenaBlockSize)
+    {
+    }
+
+    //! Install a callback that receives entries instead of storing them
+    //@ param callback The callback, or nullptr to store entries again
+    void FTPListingParser::SetEntryCallback(EntryCallback callback)
+    {
+        m_callback = std::move(callback);
+    }
+
+    //! Set the current time used to date LIST entries that omit the year
+    //@ param now The reference time in UTC seconds since the epoch
+    void FTPListingParser::SetReferenceTime(int64_t now)
+    {
+        m_now = now;
+    }
+
+    //! Parse a chunk of listing bytes
+    //@ param data The received bytes
+    //@ param size The number of bytes
+    void FTPListingParser::Feed(const char *data, size_t size)
+    {
+        const char *end = data + size;
+        while (data < end)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(data, '\n', end - data));
+            if (!newline)
+            {
+                m_partial.append(data, end - data);
+                return;
+            }
+
+            if (m_partial.empty())
+            {
+                //* Common case: the whole line is inside this chunk
+                ConsumeLine(std::string_view(data, newline - data));
+            }
+            else
+            {
+                m_partial.append(data, newline - data);
+                ConsumeLine(m_partial);
+                m_partial.clear();
+            }
+            data = newline + 1;
+        }
+    }
+
+    //! Parse a final line that was not terminated by a newline
+    void FTPListingParser::Finish()
+    {
+        if (!m_partial.empty())
+        {
+            ConsumeLine(m_partial);
+            m_partial.clear();
+        }
+    }
+
+    //! Discard all entries and buffered bytes
+    void FTPListingParser::Clear()
+    {
+        m_partial.clear();
+        m_entries.clear();
+        m_blocks.clear();
+        m_blockUsed = kArenaBlockSize;
+    }
+
+    //! Parse an RFC 3659 "YYYYMMDDHHMMSS[.sss]" time value (MLSD modify fact, MDTM reply)
+    //@ param value The time value
+    //@ return UTC seconds since the epoch, or -1 if the value is malformed
+    int64_t FTPListingParser::ParseTimestamp(std::string_view value)
+    {
+        uint64_t check = 0;
+        if (value.size() < 14 || !ParseNumber(value.substr(0, 14), check))
+        {
+            return -1;
+        }
+        const char *v = value.data();
+        return DaysFromCivil(ParseDigits(v, 4), ParseDigits(v + 4, 2), ParseDigits(v + 6, 2)) * kSecondsPerDay +
+               ParseDigits(v + 8, 2) * 3600 + ParseDigits(v + 10, 2) * 60 + ParseDigits(v + 12, 2);
+    }
+
+    //! Parse one listing line
+    //@ param line The line (without line terminator)
+    //@ param entry Receives the parsed entry; its name points into line
+    //@ param format The line format
+    //@ param now The reference time for LIST dates without a year
+    //@ return True if the line held an entry
+    bool FTPListingParser::ParseLine(std::string_view line, DirEntry &entry, Format format, int64_t now)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.empty())
+        {
+            return false;
+        }
+
+        entry = DirEntry();
+        if (format == Format::Auto)
+        {
+            //* MLSD lines start with "fact=value;" before the first space
+            size_t space = line.find(' ');
+            size_t equals = line.find('=');
+            format = equals != std::string_view::npos && equals < space ? Format::MLSD : Format::Unix;
+        }
+        return format == Format::MLSD ? ParseMlsdLine(line, entry) : ParseUnixLine(line, entry, now);
+    }
+
+    //! Parse one complete line and store or report the entry
+    //@ param line The line (without the newline)
+    void FTPListingParser::ConsumeLine(std::string_view line)
+    {
+        DirEntry entry;
+        if (!ParseLine(line, entry, m_format, m_now))
+        {
+            return;
+        }
+
+        if (m_callback)
+        {
+            m_callback(entry);
+            return;
+        }
+
+        entry.name = Intern(entry.name);
+        m_entries.push_back(entry);
+    }
+
+    //! Copy a name into the arena
+    //@ param name The name to copy
+    //@ return A view of the stored copy
+    std::string_view FTPListingParser::Intern(std::string_view name)
+    {
+        if (m_blocks.empty() || name.size() > kArenaBlockSize - m_blockUsed)
+        {
+            //* Blocks are never moved, so earlier views stay valid
+            m_blocks.push_back(std::make_unique<char[]>(std::max(kArenaBlockSize, name.size())));
+            m_blockUsed = 0;
+        }
+        char *copy = m_blocks.back().get() + m_blockUsed;
+        std::memcpy(copy, name.data(), name.size());
+        m_blockUsed = std::min(m_blockUsed + name.size(), kArenaBlockSize);
+        return std::string_view(copy, name.size());
+    }
+
+}
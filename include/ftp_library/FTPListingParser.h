@@ -0,0 +1,130 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPListingParser.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:23:47 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPLISTINGPARSER_H
+#define FTPLISTINGPARSER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Kind of directory entry
+    enum class EntryType : uint8_t
+    {
+        File,
+        Directory,
+        Link,
+        Other
+    };
+
+    //! One parsed directory entry
+    //! The name points into the owning FTPListingParser's arena (or into the
+    //! line being parsed when an entry callback is installed).
+    struct DirEntry
+    {
+        std::string_view name;         //* Entry name
+        uint64_t size = 0;             //* Size in bytes
+        int64_t mtime = -1;            //* Modification time in UTC seconds since the epoch, -1 if unknown
+        EntryType type = EntryType::Other; //* Entry kind
+        uint16_t perms = 0;            //* Unix permission bits, 0 if unknown
+    };
+
+    //! Streaming parser for LIST (Unix "ls -l" style) and MLSD listings
+    //! Bytes are fed as they arrive from the data connection; complete lines are
+    //! parsed in place and only partial lines are carried over. Entry names are
+    //! copied into a block arena, so a listing costs one small struct plus the
+    //! name bytes per entry.
+    class FTPListingParser
+    {
+    public:
+        enum class Format
+        {
+            Auto, //* Detect per line
+            Unix, //* LIST output in "ls -l" form
+            MLSD  //* RFC 3659 machine listing
+        };
+
+        using EntryCallback = std::function<void(const DirEntry &entry)>;
+
+        //! Constructor
+        //! @param format The listing format to expect
+        explicit FTPListingParser(Format format = Format::Auto);
+
+        //! Prevent copy construction and assignment; entries point into the arena
+        FTPListingParser(const FTPListingParser &) = delete;
+        FTPListingParser &operator=(const FTPListingParser &) = delete;
+
+        //! Install a callback that receives entries instead of storing them
+        //! The entry name is only valid for the duration of the call.
+        //! @param callback The callback, or nullptr to store entries again
+        void SetEntryCallback(EntryCallback callback);
+
+        //! Set the current time used to date LIST entries that omit the year
+        //! @param now The reference time in UTC seconds since the epoch
+        void SetReferenceTime(int64_t now);
+
+        //! Parse a chunk of listing bytes
+        //! @param data The received bytes
+        //! @param size The number of bytes
+        void Feed(const char *data, size_t size);
+
+        //! Parse a final line that was not terminated by a newline
+        void Finish();
+
+        //! Discard all entries and buffered bytes
+        void Clear();
+
+        //! Get the listing format
+        Format GetFormat() const
+        {
+            return m_format;
+        }
+
+        //! Get the stored entries
+        const std::vector<DirEntry> &Entries() const
+        {
+            return m_entries;
+        }
+
+        //! Parse one listing line
+        //! @param line The line (without line terminator)
+        //! @param entry Receives the parsed entry; its name points into line
+        //! @param format The line format
+        //! @param now The reference time for LIST dates without a year
+        //! @return True if the line held an entry, false for totals, "." and ".." or unknown input
+        static bool ParseLine(std::string_view line, DirEntry &entry, Format format, int64_t now);
+
+        //! Parse an RFC 3659 "YYYYMMDDHHMMSS[.sss]" time value (MLSD modify fact, MDTM reply)
+        //! @param value The time value
+        //! @return UTC seconds since the epoch, or -1 if the value is malformed
+        static int64_t ParseTimestamp(std::string_view value);
+
+    private:
+        //! Parse one complete line and store or report the entry
+        void ConsumeLine(std::string_view line);
+
+        //! Copy a name into the arena
+        std::string_view Intern(std::string_view name);
+
+        Format m_format;                              //* Expected listing format
+        int64_t m_now;                                //* Reference time for dates without a year
+        std::string m_partial;                        //* Bytes of an unterminated line
+        std::vector<DirEntry> m_entries;              //* Stored entries
+        std::vector<std::unique_ptr<char[]>> m_blocks; //* Arena blocks holding names
+        size_t m_blockUsed;                           //* Bytes used in the last block
+        EntryCallback m_callback;                     //* Optional streaming consumer
+    };
+
+}
+
+#endif
@@ -0,0 +1,310 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPMetrics.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 23:14:09 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPMetrics.h>
+
+namespace ftp_library
+{
+
+    //! Get the lower-case name of an operation
+    //@ param operation The operation
+    //@ return The name used by the sinks
+    const char *MetricsOperationName(MetricsOperation operation)
+    {
+        switch (operation)
+        {
+        case MetricsOperation::Connect:
+            return "connect";
+        case MetricsOperation::Authenticate:
+            return "authenticate";
+        case MetricsOperation::List:
+            return "list";
+        case MetricsOperation::Download:
+            return "download";
+        case MetricsOperation::Upload:
+            return "upload";
+        }
+        return "unknown";
+    }
+
+    //! Format a double the way both JSON and Prometheus accept it
+    //@ param value The value
+    //@ return The formatted number
+    static std::string FormatNumber(double value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        return buffer;
+    }
+
+    //! Constructor
+    //@ param bounds The inclusive upper bounds of the buckets, ascending
+    FTPHistogram::FTPHistogram(std::vector<double> bounds)
+        : m_bounds(std::move(bounds)), m_counts(m_bounds.size() + 1, 0)
+    {
+    }
+
+    //! Record one value
+    //@ param value The observed value
+    void FTPHistogram::Observe(double value)
+    {
+        size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+        ++m_counts[bucket];
+        ++m_count;
+        m_sum += value;
+    }
+
+    //! Default bounds for durations, 1 ms to 60 s
+    std::vector<double> FTPHistogram::LatencyBounds()
+    {
+        return {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0};
+    }
+
+    //! Default bounds for throughput, 64 KiB/s to 1 GiB/s
+    std::vector<double> FTPHistogram::ThroughputBounds()
+    {
+        std::vector<double> bounds;
+        for (double bound = 64.0 * 1024; bound <= 1024.0 * 1024 * 1024; bound *= 4)
+        {
+            bounds.push_back(bound);
+        }
+        return bounds;
+    }
+
+    //! Constructor
+    //@ param callback Called for each operation
+    FTPCallbackMetricsSink::FTPCallbackMetricsSink(Callback callback) : m_callback(std::move(callback))
+    {
+    }
+
+    //! Forward one measurement to the callback
+    //@ param metrics The measurements
+    void FTPCallbackMetricsSink::Record(const OperationMetrics &metrics)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_callback)
+        {
+            m_callback(metrics);
+        }
+    }
+
+    //! Constructor; opens the file for appending
+    //@ param path The JSON lines file
+    FTPJsonLinesMetricsSink::FTPJsonLinesMetricsSink(const std::string &path) : m_file(fopen(path.c_str(), "ab"))
+    {
+        if (!m_file)
+        {
+            throw FTPException("Failed to open metrics file for writing: " + path, -1);
+        }
+    }
+
+    //! Destructor
+    FTPJsonLinesMetricsSink::~FTPJsonLinesMetricsSink()
+    {
+        fclose(m_file);
+    }
+
+    //! Append one measurement as a JSON line
+    //@ param metrics The measurements
+    void FTPJsonLinesMetricsSink::Record(const OperationMetrics &metrics)
+    {
+        std::string line = Format(metrics);
+        line += '\n';
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        fwrite(line.data(), 1, line.size(), m_file);
+        fflush(m_file);
+    }
+
+    //! Format one measurement as a single-line JSON object
+    //@ param metrics The measurements
+    //@ return The JSON text
+    std::string FTPJsonLinesMetricsSink::Format(const OperationMetrics &metrics)
+    {
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count();
+
+        std::string json = "{\"timestamp_ms\":" + std::to_string(timestamp);
+        json += ",\"operation\":\"" + std::string(MetricsOperationName(metrics.operation)) + "\"";
+        json += ",\"host\":\"" + FTPUtilities::EscapeJson(metrics.host) + "\"";
+        json += ",\"path\":\"" + FTPUtilities::EscapeJson(metrics.path) + "\"";
+        json += ",\"success\":" + std::string(metrics.success ? "true" : "false");
+        json += ",\"seconds\":" + FormatNumber(metrics.seconds);
+        if (metrics.setupSeconds >= 0.0)
+        {
+            json += ",\"setup_seconds\":" + FormatNumber(metrics.setupSeconds);
+        }
+        if (metrics.firstByteSeconds >= 0.0)
+        {
+            json += ",\"first_byte_seconds\":" + FormatNumber(metrics.firstByteSeconds);
+        }
+        json += ",\"bytes\":" + std::to_string(metrics.bytes);
+        json += ",\"bytes_per_second\":" + FormatNumber(metrics.BytesPerSecond());
+        json += ",\"syscalls\":" + std::to_string(metrics.syscalls);
+        json += "}";
+        return json;
+    }
+
+    //! Constructor
+    //@ param path The .prom file to keep up to date, or empty to only aggregate
+    FTPPrometheusMetricsSink::FTPPrometheusMetricsSink(std::string path) : m_path(std::move(path))
+    {
+    }
+
+    //! Add one measurement to the aggregates
+    //@ param metrics The measurements
+    void FTPPrometheusMetricsSink::Record(const OperationMetrics &metrics)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Aggregate &aggregate = m_aggregates[static_cast<size_t>(metrics.operation)];
+
+        ++(metrics.success ? aggregate.succeeded : aggregate.failed);
+        aggregate.duration.Observe(metrics.seconds);
+        if (metrics.setupSeconds >= 0.0)
+        {
+            aggregate.setup.Observe(metrics.setupSeconds);
+        }
+        if (metrics.firstByteSeconds >= 0.0)
+        {
+            aggregate.firstByte.Observe(metrics.firstByteSeconds);
+        }
+        if (metrics.success && metrics.bytes > 0)
+        {
+            aggregate.throughput.Observe(metrics.BytesPerSecond());
+        }
+        aggregate.bytes += metrics.bytes;
+        aggregate.syscalls += metrics.syscalls;
+
+        if (!m_path.empty())
+        {
+            WriteFile();
+        }
+    }
+
+    //! Append one histogram family member in exposition format
+    //@ param out The exposition text
+    //@ param name The metric name
+    //@ param operation The operation label value
+    //@ param histogram The histogram
+    static void RenderHistogram(std::string &out, const char *name, const char *operation, const FTPHistogram &histogram)
+    {
+        std::string label = "operation=\"" + FTPUtilities::EscapePrometheusLabel(operation) + "\"";
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < histogram.Bounds().size(); ++i)
+        {
+            cumulative += histogram.Counts()[i];
+            out += std::string(name) + "_bucket{" + label + ",le=\"" + FormatNumber(histogram.Bounds()[i]) + "\"} " +
+                   std::to_string(cumulative) + "\n";
+        }
+        out += std::string(name) + "_bucket{" + label + ",le=\"+Inf\"} " + std::to_string(histogram.Count()) + "\n";
+        out += std::string(name) + "_sum{" + label + "} " + FormatNumber(histogram.Sum()) + "\n";
+        out += std::string(name) + "_count{" + label + "} " + std::to_string(histogram.Count()) + "\n";
+    }
+
+    //! Render the current aggregates in Prometheus text exposition format
+    //@ return The exposition text
+    std::string FTPPrometheusMetricsSink::Render() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return RenderLocked();
+    }
+
+    //! Render the aggregates (called with the mutex held)
+    //@ return The exposition text
+    std::string FTPPrometheusMetricsSink::RenderLocked() const
+    {
+        struct HistogramFamily
+        {
+            const char *name;
+            const char *help;
+            FTPHistogram Aggregate::*member;
+        };
+        static const HistogramFamily families[] = {
+            {"ftp_operation_duration_seconds", "Wall-clock duration of FTP operations.", &Aggregate::duration},
+            {"ftp_setup_seconds", "TCP connect time (connect) or PASV plus data connect time (transfers).", &Aggregate::setup},
+            {"ftp_first_byte_seconds", "Time from sending the command to the first reply or data byte.", &Aggregate::firstByte},
+            {"ftp_throughput_bytes_per_second", "Throughput of successful data transfers.", &Aggregate::throughput},
+        };
+
+        std::string out;
+
+        for (const auto &family : families)
+        {
+            out += std::string("# HELP ") + family.name + " " + family.help + "\n";
+            out += std::string("# TYPE ") + family.name + " histogram\n";
+            for (size_t i = 0; i < kMetricsOperationCount; ++i)
+            {
+                RenderHistogram(out, family.name, MetricsOperationName(static_cast<MetricsOperation>(i)),
+                                m_aggregates[i].*family.member);
+            }
+        }
+
+        out += "# HELP ftp_operations_total Finished FTP operations by result.\n";
+        out += "# TYPE ftp_operations_total counter\n";
+        for (size_t i = 0; i < kMetricsOperationCount; ++i)
+        {
+            std::string operation = FTPUtilities::EscapePrometheusLabel(
+                MetricsOperationName(static_cast<MetricsOperation>(i)));
+            out += "ftp_operations_total{operation=\"" + operation + "\",result=\"success\"} " +
+                   std::to_string(m_aggregates[i].succeeded) + "\n";
+            out += "ftp_operations_total{operation=\"" + operation + "\",result=\"failure\"} " +
+                   std::to_string(m_aggregates[i].failed) + "\n";
+        }
+
+        out += "# HELP ftp_transferred_bytes_total Bytes moved over data connections.\n";
+        out += "# TYPE ftp_transferred_bytes_total counter\n";
+        for (size_t i = 0; i < kMetricsOperationCount; ++i)
+        {
+            out += "ftp_transferred_bytes_total{operation=\"" +
+                   FTPUtilities::EscapePrometheusLabel(MetricsOperationName(static_cast<MetricsOperation>(i))) + "\"} " +
+                   std::to_string(m_aggregates[i].bytes) + "\n";
+        }
+
+        out += "# HELP ftp_transfer_syscalls_total I/O system calls issued by the transfer loops.\n";
+        out += "# TYPE ftp_transfer_syscalls_total counter\n";
+        for (size_t i = 0; i < kMetricsOperationCount; ++i)
+        {
+            out += "ftp_transfer_syscalls_total{operation=\"" +
+                   FTPUtilities::EscapePrometheusLabel(MetricsOperationName(static_cast<MetricsOperation>(i))) + "\"} " +
+                   std::to_string(m_aggregates[i].syscalls) + "\n";
+        }
+        return out;
+    }
+
+    //! Rewrite the .prom file atomically (called with the mutex held)
+    void FTPPrometheusMetricsSink::WriteFile() const
+    {
+        std::string temporary = m_path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            return; //* Metrics must never fail the transfer they describe
+        }
+
+        std::string text = RenderLocked();
+
+        bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+        ok = fclose(file) == 0 && ok;
+
+        std::error_code error;
+        if (ok)
+        {
+            std::filesystem::rename(temporary, m_path, error);
+        }
+        if (!ok || error)
+        {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+
+}
@@ -0,0 +1,204 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPMetrics.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:46:34 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPMETRICS_H
+#define FTPMETRICS_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Kind of instrumented client operation
+    enum class MetricsOperation
+    {
+        Connect,
+        Authenticate,
+        List,
+        Download,
+        Upload
+    };
+
+    //! Number of MetricsOperation values
+    static constexpr size_t kMetricsOperationCount = 5;
+
+    //! Measurements of one finished operation
+    struct OperationMetrics
+    {
+        MetricsOperation operation = MetricsOperation::Connect; //* What was measured
+        std::string host;               //* Server as "host:port"
+        std::string path;               //* Remote path, empty for connect and authenticate
+        bool success = false;           //* False if the operation threw
+        double seconds = 0.0;           //* Total wall-clock duration
+        double setupSeconds = -1.0;     //* TCP connect (Connect) or PASV + data connect (transfers), -1 if n/a
+        double firstByteSeconds = -1.0; //* Greeting (Connect), first data byte (List, Download) or
+                                        //* go-ahead reply (Upload) after the command, -1 if n/a
+        double transferSeconds = 0.0;   //* Time spent in the data transfer loop
+        uint64_t bytes = 0;             //* Bytes moved over the data connection
+        uint64_t syscalls = 0;          //* I/O system calls issued by the transfer loop
+
+        //! Get the throughput of the data transfer loop
+        //! @return The throughput in bytes per second
+        double BytesPerSecond() const
+        {
+            return transferSeconds > 0.0 ? static_cast<double>(bytes) / transferSeconds : 0.0;
+        }
+    };
+
+    //! Get the lower-case name of an operation ("connect", "download", ...)
+    //! @param operation The operation
+    //! @return The name used by the sinks
+    const char *MetricsOperationName(MetricsOperation operation);
+
+    //! Histogram with fixed upper bucket bounds plus an overflow bucket
+    class FTPHistogram
+    {
+    public:
+        //! Constructor
+        //! @param bounds The inclusive upper bounds of the buckets, ascending
+        explicit FTPHistogram(std::vector<double> bounds = LatencyBounds());
+
+        //! Record one value
+        //! @param value The observed value
+        void Observe(double value);
+
+        //! Get the bucket bounds
+        const std::vector<double> &Bounds() const
+        {
+            return m_bounds;
+        }
+
+        //! Get the per-bucket counts; the last entry counts values above every bound
+        const std::vector<uint64_t> &Counts() const
+        {
+            return m_counts;
+        }
+
+        //! Get the number of observed values
+        uint64_t Count() const
+        {
+            return m_count;
+        }
+
+        //! Get the sum of the observed values
+        double Sum() const
+        {
+            return m_sum;
+        }
+
+        //! Default bounds for durations, 1 ms to 60 s
+        static std::vector<double> LatencyBounds();
+
+        //! Default bounds for throughput, 64 KiB/s to 1 GiB/s
+        static std::vector<double> ThroughputBounds();
+
+    private:
+        std::vector<double> m_bounds;   //* Bucket upper bounds
+        std::vector<uint64_t> m_counts; //* Counts per bucket plus overflow
+        uint64_t m_count = 0;           //* Observed values
+        double m_sum = 0.0;             //* Sum of observed values
+    };
+
+    //! Receives the measurements of every instrumented operation
+    //! Record may be called from several sessions at once.
+    class FTPMetricsSink
+    {
+    public:
+        virtual ~FTPMetricsSink() = default;
+
+        //! Record one finished operation
+        //! @param metrics The measurements
+        virtual void Record(const OperationMetrics &metrics) = 0;
+    };
+
+    //! Sink that forwards every measurement to a callback
+    class FTPCallbackMetricsSink : public FTPMetricsSink
+    {
+    public:
+        using Callback = std::function<void(const OperationMetrics &metrics)>;
+
+        //! Constructor
+        //! @param callback Called for each operation, serialized by the sink
+        explicit FTPCallbackMetricsSink(Callback callback);
+
+        void Record(const OperationMetrics &metrics) override;
+
+    private:
+        Callback m_callback; //* User callback
+        std::mutex m_mutex;  //* Serializes callback invocations
+    };
+
+    //! Sink that appends one JSON object per operation to a file
+    class FTPJsonLinesMetricsSink : public FTPMetricsSink
+    {
+    public:
+        //! Constructor; opens the file for appending
+        //! @param path The JSON lines file
+        explicit FTPJsonLinesMetricsSink(const std::string &path);
+        ~FTPJsonLinesMetricsSink() override;
+
+        //! Prevent copy construction and assignment
+        FTPJsonLinesMetricsSink(const FTPJsonLinesMetricsSink &) = delete;
+        FTPJsonLinesMetricsSink &operator=(const FTPJsonLinesMetricsSink &) = delete;
+
+        void Record(const OperationMetrics &metrics) override;
+
+        //! Format one measurement as a single-line JSON object (without newline)
+        //! @param metrics The measurements
+        //! @return The JSON text
+        static std::string Format(const OperationMetrics &metrics);
+
+    private:
+        FILE *m_file;       //* Output file
+        std::mutex m_mutex; //* Serializes writes
+    };
+
+    //! Sink that aggregates histograms and counters in Prometheus text format
+    //! With a path, the exposition is rewritten atomically after every operation,
+    //! ready for the node_exporter textfile collector.
+    class FTPPrometheusMetricsSink : public FTPMetricsSink
+    {
+    public:
+        //! Constructor
+        //! @param path The .prom file to keep up to date, or empty to only aggregate
+        explicit FTPPrometheusMetricsSink(std::string path = "");
+
+        void Record(const OperationMetrics &metrics) override;
+
+        //! Render the current aggregates in Prometheus text exposition format
+        //! @return The exposition text
+        std::string Render() const;
+
+    private:
+        struct Aggregate
+        {
+            FTPHistogram duration;                                     //* Total duration
+            FTPHistogram setup;                                        //* Connect / data setup time
+            FTPHistogram firstByte;                                    //* Time to first byte
+            FTPHistogram throughput{FTPHistogram::ThroughputBounds()}; //* Data throughput
+            uint64_t succeeded = 0;                                    //* Successful operations
+            uint64_t failed = 0;                                       //* Failed operations
+            uint64_t bytes = 0;                                        //* Bytes transferred
+            uint64_t syscalls = 0;                                     //* Transfer loop syscalls
+        };
+
+        std::string RenderLocked() const; //* Render with the mutex held
+        void WriteFile() const;           //* Rewrite the .prom file with the mutex held
+
+        std::string m_path;                                         //* Output file, empty for none
+        std::array<Aggregate, kMetricsOperationCount> m_aggregates; //* Aggregates per operation
+        mutable std::mutex m_mutex;                                 //* Guards the aggregates and the file
+    };
+
+}
+
+#endif
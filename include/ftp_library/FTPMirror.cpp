@@ -0,0 +1,413 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPMirror.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:37:30 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPMirror.h>
+
+namespace ftp_library
+{
+
+    //! A directory to walk or a file to transfer
+    struct FTPMirror::Task
+    {
+        bool listing = false; //* True to walk a directory, false to transfer a file
+        TransferJob job;      //* Paths on both sides; direction selects the side to walk
+        int64_t mtime = -1;   //* Remote modification time of a file, -1 if unknown
+    };
+
+    //! Work shared by the mirror's workers
+    struct FTPMirror::WorkQueue
+    {
+        std::deque<Task> listings;        //* Directories waiting to be walked
+        std::deque<Task> transfers;       //* Files waiting to be transferred
+        size_t outstanding = 0;           //* Queued plus running tasks
+        std::mutex mutex;                 //* Guards the queues and outstanding
+        std::condition_variable ready;    //* Signalled on new work or completion
+    };
+
+    //! Number of MDTM queries per batch when LIST times are too coarse; files are offered as each batch returns
+    static constexpr size_t kMdtmBatch = 128;
+
+    //! Append a name to a remote path
+    static std::string JoinRemote(const std::string &directory, std::string_view name)
+    {
+        std::string path = directory;
+        if (path.empty() || path.back() != '/')
+        {
+            path += '/';
+        }
+        path.append(name.data(), name.size());
+        return path;
+    }
+
+    //! Check that a listed name is a single path component
+    //! Names come from the server; "..", an absolute path or a separator would place the
+    //! local copy outside the mirror root.
+    //@ param name The name from the listing
+    //@ return True if the name can be joined onto both the remote and the local directory
+    static bool IsSafeName(std::string_view name)
+    {
+        return !name.empty() && name != "." && name != ".." && name.find_first_of("/\\") == std::string_view::npos;
+    }
+
+    //! Constructor
+    //@ param pool The session pool to run listings and transfers on
+    //@ param workers The number of worker threads (0 = one per pooled session)
+    FTPMirror::FTPMirror(FTPSessionPool &pool, size_t workers)
+        : m_pool(pool), m_workerCount(workers > 0 ? workers : pool.Size()), m_queue(std::make_unique<WorkQueue>()),
+          m_useMlsd(true), m_index(nullptr), m_skipped(0)
+    {
+    }
+
+    //! Destructor
+    FTPMirror::~FTPMirror() = default;
+
+    //! Download a remote directory tree
+    //@ param remoteDir The remote directory to mirror
+    //@ param localDir The local directory to write into
+    //@ return Aggregate statistics for the run
+    TransferQueueStats FTPMirror::MirrorDirectory(const std::string &remoteDir, const std::string &localDir)
+    {
+        std::filesystem::create_directories(localDir);
+
+        Task root;
+        root.listing = true;
+        root.job = {TransferDirection::Download, FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir), localDir, 0};
+        return Run(std::move(root));
+    }
+
+    //! Upload a local directory tree
+    //@ param localDir The local directory to mirror
+    //@ param remoteDir The remote directory to write into
+    //@ return Aggregate statistics for the run
+    TransferQueueStats FTPMirror::MirrorToRemote(const std::string &localDir, const std::string &remoteDir)
+    {
+        std::string remoteRoot = FTPUtilities::Trim(remoteDir.empty() ? "/" : remoteDir);
+        try
+        {
+            auto session = m_pool.Acquire();
+            session->MakeDirectory(remoteRoot);
+        }
+        catch (const FTPException &)
+        {
+            //* Usually "already exists"; a real problem surfaces on the first STOR
+        }
+
+        Task root;
+        root.listing = true;
+        root.job = {TransferDirection::Upload, remoteRoot, localDir, 0};
+        return Run(std::move(root));
+    }
+
+    //! Run the queue from one root listing
+    //@ param root The listing task for the top directory
+    //@ return Aggregate statistics for the run
+    TransferQueueStats FTPMirror::Run(Task root)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        m_results.clear();
+        m_skipped = 0;
+        Push(std::move(root));
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < m_workerCount; ++i)
+        {
+            workers.emplace_back(&FTPMirror::WorkerLoop, this);
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        TransferQueueStats stats;
+        for (const auto &result : m_results)
+        {
+            if (result.success)
+            {
+                ++stats.completed;
+                stats.bytes += result.bytes;
+            }
+            else
+            {
+                ++stats.failed;
+            }
+        }
+        stats.skipped = m_skipped;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Queue a task
+    //@ param task The task to queue
+    void FTPMirror::Push(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queue->mutex);
+            ++m_queue->outstanding;
+            (task.listing ? m_queue->listings : m_queue->transfers).push_back(std::move(task));
+        }
+        m_queue->ready.notify_one();
+    }
+
+    //! Wait for the next task
+    //@ param task Receives the next task
+    //@ return False once every task has finished and nothing is queued
+    bool FTPMirror::Pop(Task &task)
+    {
+        WorkQueue &work = *m_queue;
+        std::unique_lock<std::mutex> lock(work.mutex);
+        work.ready.wait(lock, [&work]()
+                        { return !work.listings.empty() || !work.transfers.empty() || work.outstanding == 0; });
+
+        //* Walk directories first so the transfer queue never runs dry early
+        std::deque<Task> &queue = !work.listings.empty() ? work.listings : work.transfers;
+        if (queue.empty())
+        {
+            return false;
+        }
+        task = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+
+    //! Worker thread body: hold one pooled session and drain the queue
+    void FTPMirror::WorkerLoop()
+    {
+        std::unique_ptr<FTPSessionPool::Lease> session;
+        Task task;
+
+        while (Pop(task))
+        {
+            TransferResult result;
+            auto start = std::chrono::steady_clock::now();
+
+            try
+            {
+                if (!session)
+                {
+                    session = std::make_unique<FTPSessionPool::Lease>(m_pool.Acquire());
+                }
+
+                FTPClient &client = **session;
+                if (task.listing)
+                {
+                    if (task.job.direction == TransferDirection::Download)
+                    {
+                        ListRemote(client, task.job);
+                    }
+                    else
+                    {
+                        ListLocal(client, task.job);
+                    }
+                }
+                else if (task.job.direction == TransferDirection::Download)
+                {
+                    client.DownloadFile(task.job.remotePath, task.job.localPath);
+                    if (m_index && task.mtime >= 0)
+                    {
+                        m_index->Update(task.job.remotePath, {task.job.size, task.mtime, {}});
+                    }
+                }
+                else
+                {
+                    client.UploadFile(task.job.localPath, task.job.remotePath);
+                }
+
+                result.success = true;
+                if (!task.listing)
+                {
+                    result.bytes = client.GetLastTransferStats().bytes;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                result.error = e.what();
+                if (session)
+                {
+                    //* The control connection may be out of sync, get a fresh session
+                    session->Invalidate();
+                    session.reset();
+                }
+            }
+
+            //* Successful listings are bookkeeping only; failed ones are reported like transfers
+            if (!task.listing || !result.success)
+            {
+                result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                result.job = std::move(task.job);
+                Record(std::move(result));
+            }
+
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(m_queue->mutex);
+                finished = --m_queue->outstanding == 0;
+            }
+            if (finished)
+            {
+                m_queue->ready.notify_all();
+            }
+        }
+    }
+
+    //! Walk one remote directory, queueing its subdirectories and files
+    //@ param client The session to list on
+    //@ param directory The directory to walk
+    void FTPMirror::ListRemote(FTPClient &client, const TransferJob &directory)
+    {
+        size_t seen = 0;
+        bool useMlsd = m_useMlsd;
+        std::vector<Task> untimed;
+        auto onEntry = [this, &directory, &seen, &useMlsd, &untimed](const DirEntry &entry)
+        {
+            ++seen;
+            if (!IsSafeName(entry.name))
+            {
+                return; //* Never leaves the mirror root, whatever the server lists
+            }
+            Task task;
+            task.job.direction = TransferDirection::Download;
+            task.job.remotePath = JoinRemote(directory.remotePath, entry.name);
+            task.job.localPath = (std::filesystem::path(directory.localPath) / std::string(entry.name)).string();
+            task.job.size = entry.size;
+            task.mtime = entry.mtime;
+
+            if (entry.type == EntryType::Directory)
+            {
+                std::filesystem::create_directories(task.job.localPath);
+                task.listing = true;
+            }
+            else if (entry.type != EntryType::File)
+            {
+                return; //* Links and special files are not followed
+            }
+            else if (m_index && !useMlsd)
+            {
+                //* LIST times have minute (or day) resolution; ask MDTM once the listing is done
+                untimed.push_back(std::move(task));
+                return;
+            }
+            Offer(std::move(task));
+        };
+
+        FTPListingParser parser(useMlsd ? FTPListingParser::Format::MLSD : FTPListingParser::Format::Unix);
+        parser.SetEntryCallback(onEntry);
+        try
+        {
+            client.ListDirectory(directory.remotePath, parser);
+        }
+        catch (const FTPException &)
+        {
+            if (!useMlsd || seen > 0)
+            {
+                throw;
+            }
+
+            //* Server without MLSD support: fall back to LIST for the rest of the run
+            useMlsd = false;
+            FTPListingParser fallback(FTPListingParser::Format::Unix);
+            fallback.SetEntryCallback(onEntry);
+            client.ListDirectory(directory.remotePath, fallback);
+            m_useMlsd = false;
+        }
+
+        for (size_t first = 0; first < untimed.size(); first += kMdtmBatch)
+        {
+            size_t last = std::min(first + kMdtmBatch, untimed.size());
+            std::vector<MetadataQuery> queries;
+            for (size_t i = first; i < last; ++i)
+            {
+                queries.push_back({MetadataCommand::ModificationTime, untimed[i].job.remotePath});
+            }
+
+            auto results = client.QueryMetadata(queries);
+            for (size_t i = first; i < last; ++i)
+            {
+                untimed[i].mtime = results[i - first].mtime;
+                Offer(std::move(untimed[i]));
+            }
+        }
+    }
+
+    //! Queue a remote file unless the sync index shows the local copy is current
+    //@ param task The download task
+    void FTPMirror::Offer(Task task)
+    {
+        if (m_index && task.mtime >= 0)
+        {
+            std::error_code error;
+            uint64_t localSize = std::filesystem::file_size(task.job.localPath, error);
+            if (!error && localSize == task.job.size &&
+                !m_index->IsChanged(task.job.remotePath, {task.job.size, task.mtime, {}}))
+            {
+                ++m_skipped;
+                return;
+            }
+        }
+        Push(std::move(task));
+    }
+
+    //! Walk one local directory, creating remote subdirectories and queueing files
+    //@ param client The session used to create remote directories
+    //@ param directory The directory to walk
+    void FTPMirror::ListLocal(FTPClient &client, const TransferJob &directory)
+    {
+        for (const auto &item : std::filesystem::directory_iterator(directory.localPath))
+        {
+            Task task;
+            task.job.direction = TransferDirection::Upload;
+            task.job.localPath = item.path().string();
+            task.job.remotePath = JoinRemote(directory.remotePath, item.path().filename().string());
+
+            std::error_code error;
+            if (item.is_symlink(error))
+            {
+                continue; //* Links are not followed: they can loop or lead out of the mirrored tree
+            }
+            if (item.is_directory(error))
+            {
+                try
+                {
+                    client.MakeDirectory(task.job.remotePath);
+                }
+                catch (const FTPException &)
+                {
+                    //* Usually "already exists"; a real problem surfaces on the first STOR
+                }
+                task.listing = true;
+            }
+            else if (item.is_regular_file(error))
+            {
+                task.job.size = item.file_size(error);
+            }
+            else
+            {
+                continue;
+            }
+            Push(std::move(task));
+        }
+    }
+
+    //! Store a result and report progress
+    //@ param result The finished transfer or failed listing
+    void FTPMirror::Record(TransferResult result)
+    {
+        if (m_progress)
+        {
+            m_progress(result);
+        }
+
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.push_back(std::move(result));
+    }
+
+}
@@ -0,0 +1,104 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPMirror.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:23:47 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPMIRROR_H
+#define FTPMIRROR_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    class FTPClient;
+    class FTPSessionPool;
+    class FTPSyncIndex;
+    struct TransferJob;
+    struct TransferResult;
+    struct TransferQueueStats;
+
+    //! Recursive directory mirror running on pooled sessions
+    //! Directory listings and file transfers share one work queue: every listing
+    //! queues its subdirectories and files as soon as it is parsed, so transfers
+    //! start while the rest of the tree is still being walked. Listings are
+    //! served before transfers to keep the queue fed.
+    class FTPMirror
+    {
+    public:
+        //! Constructor
+        //! @param pool The session pool to run listings and transfers on
+        //! @param workers The number of worker threads (0 = one per pooled session)
+        explicit FTPMirror(FTPSessionPool &pool, size_t workers = 0);
+        ~FTPMirror();
+
+        //! Download a remote directory tree
+        //! @param remoteDir The remote directory to mirror
+        //! @param localDir The local directory to write into (created if missing)
+        //! @return Aggregate statistics for the run
+        TransferQueueStats MirrorDirectory(const std::string &remoteDir, const std::string &localDir);
+
+        //! Upload a local directory tree
+        //! @param localDir The local directory to mirror
+        //! @param remoteDir The remote directory to write into (created if missing)
+        //! @return Aggregate statistics for the run
+        TransferQueueStats MirrorToRemote(const std::string &localDir, const std::string &remoteDir);
+
+        //! Make downloads incremental
+        //! Files whose size and modification time (from MLSD, or MDTM when only LIST
+        //! is available) match the index, and whose local copy has the same size,
+        //! are skipped. Successful downloads are recorded in the index; saving it
+        //! is left to the caller.
+        //! @param index The index to consult and update, or nullptr for full mirrors
+        void SetSyncIndex(FTPSyncIndex *index)
+        {
+            m_index = index;
+        }
+
+        //! Set a callback invoked (from worker threads) after each file transfer or failed listing
+        //! @param callback The callback to invoke
+        void SetProgressCallback(std::function<void(const TransferResult &)> callback)
+        {
+            m_progress = std::move(callback);
+        }
+
+        //! Get the results of the last run, in completion order
+        const std::vector<TransferResult> &Results() const
+        {
+            return m_results;
+        }
+
+    private:
+        struct Task;
+        struct WorkQueue;
+
+        TransferQueueStats Run(Task root);        //* Run the queue from one root listing
+        void Push(Task task);                     //* Queue a task
+        void Offer(Task task);                    //* Queue a download unless the index says it is current
+        bool Pop(Task &task);                     //* Wait for the next task, false when all work is done
+        void WorkerLoop();                        //* Worker thread body
+        void ListRemote(FTPClient &client, const TransferJob &directory); //* Walk one remote directory
+        void ListLocal(FTPClient &client, const TransferJob &directory);  //* Walk one local directory
+        void Record(TransferResult result);       //* Store a result and report progress
+
+        FTPSessionPool &m_pool;                                  //* Sessions to run on
+        size_t m_workerCount;                                    //* Number of worker threads
+        std::unique_ptr<WorkQueue> m_queue;                      //* Shared listing and transfer queue
+        std::atomic<bool> m_useMlsd;                             //* Cleared once the server rejects MLSD
+        FTPSyncIndex *m_index;                                   //* Optional incremental sync index
+        std::atomic<size_t> m_skipped;                           //* Files skipped as up to date
+        std::vector<TransferResult> m_results;                   //* Results of the last run
+        std::mutex m_resultsMutex;                               //* Guards m_results
+        std::function<void(const TransferResult &)> m_progress; //* Per-job completion callback
+    };
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPRateLimiter.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:05:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPRateLimiter.h>
+
+namespace ftp_library
+{
+
+    //! Largest syscall a throttled transfer makes while every limit is off,
+    //! so a limit set in the middle of a transfer takes effect quickly
+    static constexpr size_t kUnlimitedChunk = 4 * 1024 * 1024;
+
+    //! Convert a byte count at a rate to a duration
+    //@ param bytes The number of bytes
+    //@ param bytesPerSecond The rate (non-zero)
+    //@ return The time the bytes take at the rate
+    static FTPRateLimiter::Clock::duration DurationFor(uint64_t bytes, uint64_t bytesPerSecond)
+    {
+        return std::chrono::duration_cast<FTPRateLimiter::Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(bytes) / static_cast<double>(bytesPerSecond)));
+    }
+
+    //! Constructor
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    //@ param burst Bytes that may pass at once after an idle period, 0 for one quantum
+    FTPRateLimiter::FTPRateLimiter(uint64_t bytesPerSecond, uint64_t burst)
+        : m_rate(bytesPerSecond), m_burst(burst), m_tat(Clock::now())
+    {
+    }
+
+    //! Change the rate
+    //@ param bytesPerSecond The new rate, 0 for unlimited
+    void FTPRateLimiter::SetRate(uint64_t bytesPerSecond)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        if (m_rate > 0 && bytesPerSecond > 0 && m_tat > now)
+        {
+            //* Bytes already reserved are repaid at the new rate
+            auto backlog = std::chrono::duration<double>(m_tat - now) * static_cast<double>(m_rate) /
+                           static_cast<double>(bytesPerSecond);
+            m_tat = now + std::chrono::duration_cast<Clock::duration>(backlog);
+        }
+        else
+        {
+            m_tat = now;
+        }
+        m_rate = bytesPerSecond;
+    }
+
+    //! Get the rate
+    //@ return The rate in bytes per second, 0 if unlimited
+    uint64_t FTPRateLimiter::Rate() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rate;
+    }
+
+    //! Get the bytes a transfer should move per syscall under this limiter
+    size_t FTPRateLimiter::Quantum() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return QuantumFor(m_rate);
+    }
+
+    //! Get the quantum for a rate: 20 ms worth, between 4 KiB and 256 KiB
+    //! The cap matches the default transfer buffer, so splice, sendfile and
+    //! buffered loops move equal chunks and share a limiter evenly
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    //@ return The quantum in bytes, 0 if unlimited
+    size_t FTPRateLimiter::QuantumFor(uint64_t bytesPerSecond)
+    {
+        if (bytesPerSecond == 0)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(std::clamp<uint64_t>(bytesPerSecond / 50, 4 * 1024, 256 * 1024));
+    }
+
+    //! Reserve bandwidth for bytes that were or are about to be moved
+    //@ param bytes The number of bytes
+    //@ return When the bytes fit the rate
+    FTPRateLimiter::Clock::time_point FTPRateLimiter::Reserve(uint64_t bytes)
+    {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_rate == 0)
+        {
+            return now;
+        }
+
+        //* Idle time only builds up credit to the burst size
+        if (m_tat < now)
+        {
+            m_tat = now;
+        }
+        m_tat += DurationFor(bytes, m_rate);
+
+        auto due = m_tat - DurationFor(m_burst > 0 ? m_burst : QuantumFor(m_rate), m_rate);
+        return due > now ? due : now;
+    }
+
+    //! Reserve bandwidth and sleep until it is available
+    //@ param bytes The number of bytes
+    void FTPRateLimiter::Acquire(uint64_t bytes)
+    {
+        std::this_thread::sleep_until(Reserve(bytes));
+    }
+
+    //! Add a limiter
+    //@ param limiter The limiter, ignored if null
+    void FTPThrottle::Add(std::shared_ptr<FTPRateLimiter> limiter)
+    {
+        if (limiter)
+        {
+            m_limiters.push_back(std::move(limiter));
+        }
+    }
+
+    //! Bound the size of the next syscall
+    //@ param wanted The size the loop would use unthrottled
+    //@ return The size to use
+    size_t FTPThrottle::ChunkLimit(size_t wanted) const
+    {
+        size_t limit = kUnlimitedChunk;
+        for (const auto &limiter : m_limiters)
+        {
+            size_t quantum = limiter->Quantum();
+            if (quantum > 0)
+            {
+                limit = std::min(limit, quantum);
+            }
+        }
+        return std::max<size_t>(1, std::min(wanted, limit));
+    }
+
+    //! Pay for moved bytes
+    //@ param bytes The number of bytes moved
+    void FTPThrottle::Consume(uint64_t bytes)
+    {
+        FTPRateLimiter::Clock::time_point due{};
+        for (const auto &limiter : m_limiters)
+        {
+            due = std::max(due, limiter->Reserve(bytes));
+        }
+        if (due > FTPRateLimiter::Clock::now())
+        {
+            std::this_thread::sleep_until(due);
+        }
+    }
+
+    //! Constructor
+    FTPBandwidthLimits::FTPBandwidthLimits() : m_global(std::make_shared<FTPRateLimiter>())
+    {
+    }
+
+    //! Limit the combined rate of every transfer
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    void FTPBandwidthLimits::SetGlobalRate(uint64_t bytesPerSecond)
+    {
+        m_global->SetRate(bytesPerSecond);
+    }
+
+    //! Limit the combined rate of the transfers to one host
+    //@ param host The host name as passed to Connect
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    void FTPBandwidthLimits::SetHostRate(const std::string &host, uint64_t bytesPerSecond)
+    {
+        HostLimiter(host)->SetRate(bytesPerSecond);
+    }
+
+    //! Get the limiter of a host, creating an unlimited one on first use
+    //@ param host The host name as passed to Connect
+    //@ return The limiter
+    std::shared_ptr<FTPRateLimiter> FTPBandwidthLimits::HostLimiter(const std::string &host)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto &limiter = m_hosts[FTPUtilities::ToLowerCase(FTPUtilities::Trim(host))];
+        if (!limiter)
+        {
+            limiter = std::make_shared<FTPRateLimiter>();
+        }
+        return limiter;
+    }
+
+}
@@ -0,0 +1,129 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPRateLimiter.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:05:19 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPRATELIMITER_H
+#define FTPRATELIMITER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Token bucket bandwidth limiter, safe to share between transfers and threads
+    //! Each caller reserves the bytes it moves and sleeps until the bucket can
+    //! pay for them (GCRA). Reservations are served in arrival order, so
+    //! transfers that move equal chunks share the rate evenly. The rate can be
+    //! changed at any time; outstanding reservations are rescaled.
+    class FTPRateLimiter
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        //! Constructor
+        //! @param bytesPerSecond The rate, 0 for unlimited
+        //! @param burst Bytes that may pass at once after an idle period, 0 for one quantum
+        explicit FTPRateLimiter(uint64_t bytesPerSecond = 0, uint64_t burst = 0);
+
+        //! Change the rate
+        //! @param bytesPerSecond The new rate, 0 for unlimited
+        void SetRate(uint64_t bytesPerSecond);
+
+        //! Get the rate
+        //! @return The rate in bytes per second, 0 if unlimited
+        uint64_t Rate() const;
+
+        //! Get the bytes a transfer should move per syscall under this limiter
+        //! About 20 ms worth of the rate, between 4 KiB and 256 KiB; 0 when unlimited.
+        size_t Quantum() const;
+
+        //! Reserve bandwidth for bytes that were (or are about to be) moved
+        //! @param bytes The number of bytes
+        //! @return When the bytes fit the rate; the caller sleeps until then
+        Clock::time_point Reserve(uint64_t bytes);
+
+        //! Reserve bandwidth and sleep until it is available
+        //! @param bytes The number of bytes
+        void Acquire(uint64_t bytes);
+
+    private:
+        static size_t QuantumFor(uint64_t bytesPerSecond);
+
+        uint64_t m_rate;            //* Bytes per second, 0 for unlimited
+        uint64_t m_burst;           //* Burst allowance in bytes, 0 for one quantum
+        Clock::time_point m_tat;    //* Theoretical arrival time of the next byte
+        mutable std::mutex m_mutex; //* Guards the state
+    };
+
+    //! The limiters one transfer is subject to (per transfer, per host, global)
+    class FTPThrottle
+    {
+    public:
+        //! Add a limiter; null pointers are ignored
+        //! @param limiter The limiter
+        void Add(std::shared_ptr<FTPRateLimiter> limiter);
+
+        //! Check whether no limiter was added
+        bool Empty() const
+        {
+            return m_limiters.empty();
+        }
+
+        //! Bound the size of the next syscall so limits react quickly
+        //! @param wanted The size the loop would use unthrottled
+        //! @return The size to use
+        size_t ChunkLimit(size_t wanted) const;
+
+        //! Pay for moved bytes, sleeping as long as the strictest limiter requires
+        //! @param bytes The number of bytes moved
+        void Consume(uint64_t bytes);
+
+    private:
+        std::vector<std::shared_ptr<FTPRateLimiter>> m_limiters; //* Limiters charged for every chunk
+    };
+
+    //! Global and per-host bandwidth limits shared by many clients
+    //! Attach one instance to every client (or session pool) that should
+    //! share the limits; changes apply to running transfers.
+    class FTPBandwidthLimits
+    {
+    public:
+        FTPBandwidthLimits();
+
+        //! Limit the combined rate of every transfer
+        //! @param bytesPerSecond The rate, 0 for unlimited
+        void SetGlobalRate(uint64_t bytesPerSecond);
+
+        //! Limit the combined rate of the transfers to one host
+        //! @param host The host name as passed to Connect
+        //! @param bytesPerSecond The rate, 0 for unlimited
+        void SetHostRate(const std::string &host, uint64_t bytesPerSecond);
+
+        //! Get the global limiter
+        std::shared_ptr<FTPRateLimiter> GlobalLimiter() const
+        {
+            return m_global;
+        }
+
+        //! Get the limiter of a host, creating an unlimited one on first use
+        //! @param host The host name as passed to Connect
+        //! @return The limiter
+        std::shared_ptr<FTPRateLimiter> HostLimiter(const std::string &host);
+
+    private:
+        std::shared_ptr<FTPRateLimiter> m_global;                                //* Limit for all transfers
+        std::unordered_map<std::string, std::shared_ptr<FTPRateLimiter>> m_hosts; //* Limits by host
+        std::mutex m_mutex;                                                      //* Guards m_hosts
+    };
+
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPReplyReader.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:19:37 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPReplyReader.h>
+
+namespace ftp_library
+{
+
+    //! Minimum free space requested before each recv
+    static constexpr size_t kReadChunk = 4096;
+
+    //! Check whether a line starts with a three digit reply code
+    static bool HasReplyCode(const char *line, size_t length)
+    {
+        return length >= 3 &&
+               std::isdigit(static_cast<unsigned char>(line[0])) &&
+               std::isdigit(static_cast<unsigned char>(line[1])) &&
+               std::isdigit(static_cast<unsigned char>(line[2]));
+    }
+
+    //! Constructor
+    //@ param initialCapacity The initial size of the receive buffer in bytes
+    FTPReplyReader::FTPReplyReader(size_t initialCapacity)
+        : m_buffer(initialCapacity), m_head(0), m_tail(0), m_scan(0), m_multiline(false), m_code{}
+    {
+    }
+
+    //! Discard all buffered bytes and framing state
+    void FTPReplyReader::Reset()
+    {
+        m_head = m_tail = m_scan = 0;
+        m_multiline = false;
+    }
+
+    //! Append raw bytes received from the control connection
+    //@ param data The received bytes
+    //@ param size The number of bytes
+    void FTPReplyReader::Feed(const char *data, size_t size)
+    {
+        Reserve(size);
+        std::memcpy(m_buffer.data() + m_tail, data, size);
+        m_tail += size;
+    }
+
+    //! Try to frame one complete reply from the buffered bytes
+    //@ param reply Receives the reply text (without the final CRLF)
+    //@ return True if a complete reply was available, false otherwise
+    bool FTPReplyReader::TryPopReply(std::string &reply)
+    {
+        const char *base = m_buffer.data();
+
+        while (m_scan < m_tail)
+        {
+            const void *newline = std::memchr(base + m_scan, '\n', m_tail - m_scan);
+            if (!newline)
+            {
+                return false;
+            }
+
+            size_t lineEnd = static_cast<const char *>(newline) - base;
+            const char *line = base + m_scan;
+            size_t length = lineEnd - m_scan;
+            if (length > 0 && line[length - 1] == '\r')
+            {
+                --length;
+            }
+
+            bool complete = false;
+            if (!m_multiline)
+            {
+                //* "ddd-" opens a multi-line reply, anything else is a single line
+                if (HasReplyCode(line, length) && length > 3 && line[3] == '-')
+                {
+                    m_multiline = true;
+                    std::memcpy(m_code, line, sizeof(m_code));
+                }
+                else
+                {
+                    complete = true;
+                }
+            }
+            else if (length >= 3 && std::memcmp(line, m_code, sizeof(m_code)) == 0 &&
+                     (length == 3 || line[3] == ' '))
+            {
+                //* "ddd " with the same code closes a multi-line reply
+                complete = true;
+            }
+
+            m_scan = lineEnd + 1;
+
+            if (complete)
+            {
+                size_t end = m_scan;
+                while (end > m_head && (base[end - 1] == '\n' || base[end - 1] == '\r'))
+                {
+                    --end;
+                }
+                reply.assign(base + m_head, end - m_head);
+
+                m_head = m_scan;
+                m_multiline = false;
+                if (m_head == m_tail)
+                {
+                    m_head = m_tail = m_scan = 0;
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! Read from the socket until one complete reply is framed
+    //@ param socket The control socket to read from
+    //@ return The reply text (without the final CRLF)
+    std::string FTPReplyReader::ReadReply(int socket)
+    {
+        std::string reply;
+        ReadReply(socket, reply);
+        return reply;
+    }
+
+    //! Read from the socket until one complete reply is framed, reusing the caller's buffer
+    //@ param socket The control socket to read from
+    //@ param reply Receives the reply text (without the final CRLF)
+    void FTPReplyReader::ReadReply(int socket, std::string &reply)
+    {
+        while (!TryPopReply(reply))
+        {
+            Reserve(kReadChunk);
+            ssize_t bytesRead = recv(socket, m_buffer.data() + m_tail, m_buffer.size() - m_tail, 0);
+            if (bytesRead < 0)
+            {
+                throw FTPException("Failed to receive response.");
+            }
+            if (bytesRead == 0)
+            {
+                throw FTPException("Connection closed by server.");
+            }
+            m_tail += bytesRead;
+        }
+    }
+
+    //! Make room for at least minFree bytes after the tail
+    //@ param minFree The number of free bytes required
+    void FTPReplyReader::Reserve(size_t minFree)
+    {
+        if (m_buffer.size() - m_tail >= minFree)
+        {
+            return;
+        }
+
+        //* Slide the unread bytes to the front before growing
+        if (m_head > 0)
+        {
+            std::memmove(m_buffer.data(), m_buffer.data() + m_head, m_tail - m_head);
+            m_tail -= m_head;
+            m_scan -= m_head;
+            m_head = 0;
+        }
+
+        if (m_buffer.size() - m_tail < minFree)
+        {
+            m_buffer.resize(std::max(m_buffer.size() * 2, m_tail + minFree));
+        }
+    }
+
+}
@@ -0,0 +1,74 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPReplyReader.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:19:37 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPREPLYREADER_H
+#define FTPREPLYREADER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Buffered reader that frames RFC 959 replies from the control connection
+    //! Bytes that arrive past the end of one reply stay buffered for the next,
+    //! so coalesced and split TCP segments are both handled.
+    class FTPReplyReader
+    {
+    public:
+        //! Constructor
+        //! @param initialCapacity The initial size of the receive buffer in bytes
+        explicit FTPReplyReader(size_t initialCapacity = 4096);
+
+        //! Discard all buffered bytes and framing state
+        void Reset();
+
+        //! Append raw bytes received from the control connection
+        //! @param data The received bytes
+        //! @param size The number of bytes
+        void Feed(const char *data, size_t size);
+
+        //! Try to frame one complete reply from the buffered bytes
+        //! @param reply Receives the reply text (without the final CRLF)
+        //! @return True if a complete reply was available, false otherwise
+        bool TryPopReply(std::string &reply);
+
+        //! Read from the socket until one complete reply is framed
+        //! @param socket The control socket to read from
+        //! @return The reply text (without the final CRLF)
+        std::string ReadReply(int socket);
+
+        //! Read from the socket until one complete reply is framed, reusing the caller's buffer
+        //! @param socket The control socket to read from
+        //! @param reply Receives the reply text (without the final CRLF)
+        void ReadReply(int socket, std::string &reply);
+
+        //! Get the number of buffered bytes not yet returned as a reply
+        size_t Buffered() const
+        {
+            return m_tail - m_head;
+        }
+
+    private:
+        //! Make room for at least minFree bytes after the tail
+        void Reserve(size_t minFree);
+
+        std::vector<char> m_buffer; //* Receive buffer
+        size_t m_head;              //* Start of the reply being framed
+        size_t m_tail;              //* End of the buffered bytes
+        size_t m_scan;              //* Start of the next unscanned line
+        bool m_multiline;           //* True while inside a "ddd-" reply
+        char m_code[3];             //* Code of the current multi-line reply
+    };
+
+}
+
+#endif
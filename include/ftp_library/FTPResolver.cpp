@@ -0,0 +1,404 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPResolver.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:57:26 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPResolver.h>
+
+namespace ftp_library
+{
+
+    //! Format the address for logs and traces
+    //@ return "1.2.3.4:21" or "[::1]:21"
+    std::string ResolvedAddress::ToString() const
+    {
+        char text[INET6_ADDRSTRLEN] = {};
+        if (Family() == AF_INET6)
+        {
+            const auto *ipv6 = reinterpret_cast<const sockaddr_in6 *>(&address);
+            inet_ntop(AF_INET6, &ipv6->sin6_addr, text, sizeof(text));
+            return "[" + std::string(text) + "]:" + std::to_string(ntohs(ipv6->sin6_port));
+        }
+        const auto *ipv4 = reinterpret_cast<const sockaddr_in *>(&address);
+        inet_ntop(AF_INET, &ipv4->sin_addr, text, sizeof(text));
+        return std::string(text) + ":" + std::to_string(ntohs(ipv4->sin_port));
+    }
+
+    //! Check whether two addresses name the same host, ignoring the port
+    //@ param other The address to compare with
+    //@ return True if the families and IP addresses match
+    bool ResolvedAddress::SameHost(const ResolvedAddress &other) const
+    {
+        if (Family() != other.Family())
+        {
+            return false;
+        }
+        if (Family() == AF_INET6)
+        {
+            return std::memcmp(&reinterpret_cast<const sockaddr_in6 &>(address).sin6_addr,
+                               &reinterpret_cast<const sockaddr_in6 &>(other.address).sin6_addr,
+                               sizeof(in6_addr)) == 0;
+        }
+        return reinterpret_cast<const sockaddr_in &>(address).sin_addr.s_addr ==
+               reinterpret_cast<const sockaddr_in &>(other.address).sin_addr.s_addr;
+    }
+
+    //! Constructor
+    //@ param ttl How long a lookup is served without refreshing
+    //@ param staleWindow How long after the TTL a lookup may still be served while it is refreshed
+    FTPResolver::FTPResolver(std::chrono::seconds ttl, std::chrono::seconds staleWindow)
+        : m_ttl(ttl), m_staleWindow(staleWindow), m_lookup(&FTPResolver::SystemLookup)
+    {
+    }
+
+    //! Destructor; waits for lookups still in flight, since they write back into the cache
+    FTPResolver::~FTPResolver()
+    {
+        Clear();
+    }
+
+    //! Get the process-wide resolver
+    //@ return The shared instance
+    std::shared_ptr<FTPResolver> FTPResolver::Shared()
+    {
+        static std::shared_ptr<FTPResolver> resolver = std::make_shared<FTPResolver>();
+        return resolver;
+    }
+
+    //! Resolve with getaddrinfo, IPv4 and IPv6
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    //@ return The addresses in the order getaddrinfo returned them
+    FTPResolver::Addresses FTPResolver::SystemLookup(const std::string &host, uint16_t port)
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        addrinfo *result = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr)
+        {
+            throw FTPException("Failed to resolve server address.");
+        }
+
+        Addresses addresses;
+        for (addrinfo *info = result; info != nullptr; info = info->ai_next)
+        {
+            if ((info->ai_family != AF_INET && info->ai_family != AF_INET6) ||
+                info->ai_addrlen > sizeof(sockaddr_storage))
+            {
+                continue;
+            }
+            ResolvedAddress address;
+            std::memcpy(&address.address, info->ai_addr, info->ai_addrlen);
+            address.length = static_cast<socklen_t>(info->ai_addrlen);
+            addresses.push_back(address);
+        }
+        freeaddrinfo(result);
+
+        if (addresses.empty())
+        {
+            throw FTPException("Failed to resolve server address.");
+        }
+        return addresses;
+    }
+
+    //! Replace the lookup function
+    //@ param lookup The lookup to use
+    void FTPResolver::SetLookup(Lookup lookup)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lookup = std::move(lookup);
+    }
+
+    //! Resolve a host through the cache
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    //@ return At least one address
+    FTPResolver::Addresses FTPResolver::Resolve(const std::string &host, uint16_t port)
+    {
+        return ResolveAsync(host, port).get();
+    }
+
+    //! Resolve a host through the cache without waiting for a lookup
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    //@ return A future holding at least one address, or the lookup's FTPException
+    std::shared_future<FTPResolver::Addresses> FTPResolver::ResolveAsync(const std::string &host, uint16_t port)
+    {
+        std::string key = FTPUtilities::ToLowerCase(host) + ":" + std::to_string(port);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry &entry = m_entries[key];
+        if (entry.pending.valid() && entry.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            //* A finished lookup has already stored its result (or failed); only the handle is left
+            entry.pending = {};
+        }
+
+        if (!entry.addresses.empty())
+        {
+            auto age = std::chrono::steady_clock::now() - entry.stored;
+            if (age < m_ttl + m_staleWindow)
+            {
+                if (age >= m_ttl && !entry.pending.valid())
+                {
+                    StartLookup(entry, key, host, port); //* Stale: served while one lookup refreshes it
+                }
+                std::promise<Addresses> cached;
+                cached.set_value(entry.addresses);
+                return cached.get_future().share();
+            }
+        }
+
+        //* A miss waits, but on the lookup already in flight if another thread started one
+        if (!entry.pending.valid())
+        {
+            StartLookup(entry, key, host, port);
+        }
+        return entry.pending;
+    }
+
+    //! Start a lookup that stores its result in the cache when it completes
+    //@ param entry The entry to attach the lookup to (m_mutex held)
+    //@ param key The cache key of the entry
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    void FTPResolver::StartLookup(Entry &entry, const std::string &key, const std::string &host, uint16_t port)
+    {
+        Lookup lookup = m_lookup;
+        entry.pending = std::async(std::launch::async, [this, key, host, port, lookup]()
+                                   {
+                                       Addresses addresses = lookup(host, port);
+                                       if (addresses.empty())
+                                       {
+                                           throw FTPException("Failed to resolve server address.");
+                                       }
+                                       std::lock_guard<std::mutex> lock(m_mutex);
+                                       Entry &stored = m_entries[key];
+                                       stored.addresses = addresses;
+                                       stored.stored = std::chrono::steady_clock::now();
+                                       return addresses; })
+                            .share();
+    }
+
+    //! Move the address that won a connection race to the front for the next connect
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    //@ param address The address that connected
+    void FTPResolver::Promote(const std::string &host, uint16_t port, const ResolvedAddress &address)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(FTPUtilities::ToLowerCase(host) + ":" + std::to_string(port));
+        if (it == m_entries.end())
+        {
+            return;
+        }
+        Addresses &addresses = it->second.addresses;
+        auto match = std::find_if(addresses.begin(), addresses.end(), [&address](const ResolvedAddress &candidate)
+                                  { return candidate.length == address.length &&
+                                           std::memcmp(&candidate.address, &address.address, address.length) == 0; });
+        if (match != addresses.end())
+        {
+            std::rotate(addresses.begin(), match, match + 1);
+        }
+    }
+
+    //! Drop a host
+    //@ param host The hostname or IP address
+    //@ param port The port number
+    void FTPResolver::Invalidate(const std::string &host, uint16_t port)
+    {
+        //* Released after the lock: the last handle to a lookup joins its thread, which needs the lock
+        std::shared_future<Addresses> pending;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(FTPUtilities::ToLowerCase(host) + ":" + std::to_string(port));
+        if (it != m_entries.end())
+        {
+            pending = std::move(it->second.pending);
+            m_entries.erase(it);
+        }
+    }
+
+    //! Drop every host
+    void FTPResolver::Clear()
+    {
+        std::vector<std::shared_future<Addresses>> pending;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &[key, entry] : m_entries)
+        {
+            if (entry.pending.valid())
+            {
+                pending.push_back(std::move(entry.pending));
+            }
+        }
+        m_entries.clear();
+    }
+
+    //! Order addresses for racing: alternate families, starting with the first one returned
+    //@ param addresses The addresses as resolved
+    //@ return The interleaved addresses
+    FTPResolver::Addresses FTPResolver::Interleave(const Addresses &addresses)
+    {
+        if (addresses.empty())
+        {
+            return {};
+        }
+        Addresses preferred, other;
+        for (const auto &address : addresses)
+        {
+            (address.Family() == addresses.front().Family() ? preferred : other).push_back(address);
+        }
+
+        Addresses ordered;
+        ordered.reserve(addresses.size());
+        for (size_t i = 0; i < preferred.size() || i < other.size(); ++i)
+        {
+            if (i < preferred.size())
+            {
+                ordered.push_back(preferred[i]);
+            }
+            if (i < other.size())
+            {
+                ordered.push_back(other[i]);
+            }
+        }
+        return ordered;
+    }
+
+    //! Connect to the first address that answers
+    //@ param addresses The addresses to try, in order
+    //@ param attemptDelay Head start of each attempt over the next
+    //@ param timeout Overall limit for the connect
+    //@ param prepare Called on each new socket before connect
+    //@ param winner Receives the index of the address that connected, if not null
+    //@ return The connected socket, or -1
+    int FTPResolver::ConnectFirst(const Addresses &addresses, std::chrono::milliseconds attemptDelay,
+                                  std::chrono::milliseconds timeout, const std::function<void(int socket)> &prepare,
+                                  size_t *winner)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto deadline = Clock::now() + timeout;
+        auto nextStart = Clock::now();
+        std::vector<pollfd> attempts;
+        std::vector<size_t> indices;
+        size_t next = 0;
+        int connected = -1;
+
+        auto drop = [&](size_t slot)
+        {
+            closesocket(attempts[slot].fd);
+            attempts.erase(attempts.begin() + slot);
+            indices.erase(indices.begin() + slot);
+        };
+
+        while (connected < 0)
+        {
+            auto now = Clock::now();
+            if (now >= deadline)
+            {
+                break;
+            }
+
+            //* Start the next attempt when its head start is over, or right away if nothing is pending
+            if (next < addresses.size() && (now >= nextStart || attempts.empty()))
+            {
+                const ResolvedAddress &address = addresses[next];
+                int fd = static_cast<int>(socket(address.Family(), SOCK_STREAM, IPPROTO_TCP));
+                if (fd < 0)
+                {
+                    ++next;
+                    continue;
+                }
+                if (prepare)
+                {
+                    prepare(fd);
+                }
+                FTPEventLoop::SetNonBlocking(fd);
+                if (::connect(fd, reinterpret_cast<const sockaddr *>(&address.address), address.length) == 0)
+                {
+                    connected = fd;
+                    if (winner)
+                    {
+                        *winner = next;
+                    }
+                    break;
+                }
+                if (!FTPEventLoop::WouldBlock())
+                {
+                    closesocket(fd);
+                    ++next;
+                    continue;
+                }
+                attempts.push_back({static_cast<decltype(pollfd::fd)>(fd), POLLOUT, 0});
+                indices.push_back(next);
+                ++next;
+                nextStart = now + attemptDelay;
+                continue;
+            }
+
+            if (attempts.empty())
+            {
+                break;
+            }
+
+            auto wakeAt = next < addresses.size() ? std::min(nextStart, deadline) : deadline;
+            int waitMs = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count() + 1);
+#if defined(_WIN32) || defined(_WIN64)
+            int ready = WSAPoll(attempts.data(), static_cast<ULONG>(attempts.size()), waitMs);
+#else
+            int ready = poll(attempts.data(), attempts.size(), waitMs);
+#endif
+            if (ready <= 0)
+            {
+                continue;
+            }
+
+            for (size_t slot = 0; slot < attempts.size();)
+            {
+                if (attempts[slot].revents == 0)
+                {
+                    ++slot;
+                    continue;
+                }
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(static_cast<int>(attempts[slot].fd), SOL_SOCKET, SO_ERROR,
+                           reinterpret_cast<char *>(&error), &length);
+                if (error == 0 && (attempts[slot].revents & POLLOUT))
+                {
+                    connected = static_cast<int>(attempts[slot].fd);
+                    if (winner)
+                    {
+                        *winner = indices[slot];
+                    }
+                    attempts.erase(attempts.begin() + slot);
+                    indices.erase(indices.begin() + slot);
+                    break;
+                }
+                //* A failed attempt hands its turn to the next address at once
+                drop(slot);
+                nextStart = Clock::now();
+            }
+        }
+
+        while (!attempts.empty())
+        {
+            drop(0);
+        }
+        if (connected >= 0)
+        {
+            FTPEventLoop::SetBlocking(connected);
+        }
+        return connected;
+    }
+
+}
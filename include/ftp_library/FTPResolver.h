@@ -0,0 +1,143 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPResolver.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:57:26 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPRESOLVER_H
+#define FTPRESOLVER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! One resolved IPv4 or IPv6 socket address
+    struct ResolvedAddress
+    {
+        sockaddr_storage address{}; //* The address, including the port
+        socklen_t length = 0;       //* Number of valid bytes in address
+
+        //! Get the address family (AF_INET or AF_INET6)
+        int Family() const
+        {
+            return address.ss_family;
+        }
+
+        //! Format the address for logs and traces
+        //! @return "1.2.3.4:21" or "[::1]:21"
+        std::string ToString() const;
+
+        //! Check whether two addresses name the same host, ignoring the port
+        //! @param other The address to compare with
+        bool SameHost(const ResolvedAddress &other) const;
+    };
+
+    //! Caching host name resolver with happy-eyeballs connection racing
+    //! A lookup younger than the TTL is served from memory. After that it stays
+    //! usable for the stale window while one background lookup refreshes it, so
+    //! a slow resolver only delays the very first connect to a host. Concurrent
+    //! misses for the same host share one lookup. Safe to share between clients;
+    //! Shared() is the process-wide instance every FTPClient uses by default.
+    class FTPResolver
+    {
+    public:
+        using Addresses = std::vector<ResolvedAddress>;
+
+        //! Performs the actual lookup; throws FTPException on failure
+        using Lookup = std::function<Addresses(const std::string &host, uint16_t port)>;
+
+        //! Constructor
+        //! @param ttl How long a lookup is served without refreshing
+        //! @param staleWindow How long after the TTL a lookup may still be served while it is refreshed
+        explicit FTPResolver(std::chrono::seconds ttl = std::chrono::seconds(60),
+                             std::chrono::seconds staleWindow = std::chrono::seconds(600));
+        ~FTPResolver();
+
+        FTPResolver(const FTPResolver &) = delete;
+        FTPResolver &operator=(const FTPResolver &) = delete;
+
+        //! Get the process-wide resolver
+        static std::shared_ptr<FTPResolver> Shared();
+
+        //! Resolve with getaddrinfo, IPv4 and IPv6
+        //! @param host The hostname or IP address
+        //! @param port The port number
+        //! @return The addresses in the order getaddrinfo returned them
+        static Addresses SystemLookup(const std::string &host, uint16_t port);
+
+        //! Replace the lookup function (tests, custom DNS); SystemLookup by default
+        //! @param lookup The lookup to use
+        void SetLookup(Lookup lookup);
+
+        //! Resolve a host through the cache
+        //! @param host The hostname or IP address
+        //! @param port The port number
+        //! @return At least one address; throws FTPException if the host cannot be resolved
+        Addresses Resolve(const std::string &host, uint16_t port);
+
+        //! Resolve a host through the cache without waiting for a lookup
+        //! @param host The hostname or IP address
+        //! @param port The port number
+        //! @return A future that is ready at once when the cache can answer, otherwise the lookup in flight
+        std::shared_future<Addresses> ResolveAsync(const std::string &host, uint16_t port);
+
+        //! Move the address that won a connection race to the front for the next connect
+        //! @param host The hostname or IP address
+        //! @param port The port number
+        //! @param address The address that connected
+        void Promote(const std::string &host, uint16_t port, const ResolvedAddress &address);
+
+        //! Drop a host, e.g. after none of its addresses accepted a connection
+        //! @param host The hostname or IP address
+        //! @param port The port number
+        void Invalidate(const std::string &host, uint16_t port);
+
+        //! Drop every host
+        void Clear();
+
+        //! Order addresses for racing: alternate families, starting with the first one returned
+        //! @param addresses The addresses as resolved
+        //! @return The interleaved addresses
+        static Addresses Interleave(const Addresses &addresses);
+
+        //! Connect to the first address that answers (RFC 8305 happy eyeballs)
+        //! Attempts start one after another, attemptDelay apart or as soon as the
+        //! previous one fails, and race each other; the first to complete wins and
+        //! the rest are closed. The winning socket is returned in blocking mode.
+        //! @param addresses The addresses to try, in order
+        //! @param attemptDelay Head start of each attempt over the next
+        //! @param timeout Overall limit for the connect
+        //! @param prepare Called on each new socket before connect, e.g. to set options
+        //! @param winner Receives the index of the address that connected, if not null
+        //! @return The connected socket, or -1 if every attempt failed or timed out
+        static int ConnectFirst(const Addresses &addresses, std::chrono::milliseconds attemptDelay,
+                                std::chrono::milliseconds timeout, const std::function<void(int socket)> &prepare,
+                                size_t *winner = nullptr);
+
+    private:
+        struct Entry
+        {
+            Addresses addresses;                          //* Last successful lookup, empty if none
+            std::chrono::steady_clock::time_point stored; //* When addresses was stored
+            std::shared_future<Addresses> pending;        //* Lookup in flight, or finished and not yet reaped
+        };
+
+        void StartLookup(Entry &entry, const std::string &key, const std::string &host, uint16_t port);
+
+        std::chrono::seconds m_ttl;                      //* Time a lookup is served without refreshing
+        std::chrono::seconds m_staleWindow;              //* Extra time a stale lookup may be served
+        Lookup m_lookup;                                 //* The lookup function
+        std::unordered_map<std::string, Entry> m_entries; //* Keyed by lowercase "host:port"
+        std::mutex m_mutex;                              //* Guards all members
+    };
+
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:44:18 
+ * Last Modified: Sat October 17th 2026 20:19:37 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -37,16 +37,15 @@ namespace ftp_library
     //! Extract the response code
     // @param response The response string
     // @return The response code as an integer
-    int FTPResponseParser::ExtractCode(const std::string &response)
+    int FTPResponseParser::ExtractCode(std::string_view response)
     {
         if (response.size() < 3)
         {
             throw FTPResponseException("Response is too short to extract code.");
         }
 
-        int code = 0;
-        std::istringstream codeStream(response.substr(0, 3));
-        if (!(codeStream >> code))
+        int code = ParseCode(response);
+        if (code < 0)
         {
             throw FTPResponseException("Failed to parse response code.");
         }
@@ -57,30 +56,21 @@ namespace ftp_library
     //! Extract the response message
     // @param response The response string
     // @return The response message as a string
-    std::string FTPResponseParser::ExtractMessage(const std::string &response)
+    std::string FTPResponseParser::ExtractMessage(std::string_view response)
     {
         if (response.size() <= 3)
         {
             return "";
         }
-        return response.substr(3);
+        return std::string(response.substr(3));
     }
 
-    //! Check if the response code matches the expected code
-    // @param response The server's response
-    // @param expectedCode The expected response code
-    // @return True if the response code matches, false otherwise
-    bool FTPResponseParser::IsExpectedCode(const std::string &response, int expectedCode)
+    //! Get the text after the reply code without copying it
+    // @param response The response
+    // @return A view of the trimmed message
+    std::string_view FTPResponseParser::MessageView(std::string_view response) noexcept
     {
-        try
-        {
-            int code = ExtractCode(response);
-            return code == expectedCode;
-        }
-        catch (const FTPResponseException &e)
-        {
-            return false;
-        }
+        return FTPUtilities::TrimView(response.size() > 3 ? response.substr(3) : std::string_view());
     }
 
 }
@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:43:24 
+ * Last Modified: Sat October 17th 2026 20:19:37 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -25,10 +25,67 @@ namespace ftp_library
         explicit FTPResponseException(const std::string &message) : std::runtime_error(message) {}
     };
 
+    //! Set of reply codes, built at compile time from a brace list
+    //! A fixed bitmask over 0-639, so ValidateResponse(reply, {226, 250})
+    //! neither allocates nor searches.
+    class ReplyCodeSet
+    {
+    public:
+        constexpr ReplyCodeSet(std::initializer_list<int> codes) : m_bits{}
+        {
+            for (int code : codes)
+            {
+                if (code >= 0 && code < kLimit)
+                {
+                    m_bits[code / 64] |= uint64_t(1) << (code % 64);
+                }
+            }
+        }
+
+        //! Check whether a code is in the set
+        //! @param code The reply code
+        //! @return True if the set contains the code
+        constexpr bool Contains(int code) const
+        {
+            return code >= 0 && code < kLimit && (m_bits[code / 64] >> (code % 64) & 1) != 0;
+        }
+
+    private:
+        static constexpr int kLimit = 640;
+        uint64_t m_bits[kLimit / 64]; //* One bit per code
+    };
+
     //! Parser for FTP responses
     class FTPResponseParser
     {
     public:
+        //! Parse the three digit reply code without allocating or throwing
+        //! @param response The response to parse
+        //! @return The code, or -1 if the response does not start with three digits
+        static int ParseCode(std::string_view response) noexcept
+        {
+            if (response.size() < 3)
+            {
+                return -1;
+            }
+            int code = 0;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                unsigned digit = static_cast<unsigned char>(response[i]) - '0';
+                if (digit > 9)
+                {
+                    return -1;
+                }
+                code = code * 10 + static_cast<int>(digit);
+            }
+            return code;
+        }
+
+        //! Get the text after the reply code without copying it
+        //! @param response The response
+        //! @return A view of the trimmed message, valid as long as the response
+        static std::string_view MessageView(std::string_view response) noexcept;
+
         //! Parse an FTP response into code and message
         //! @param response The response to parse
         //! @return A pair containing the response code and message
@@ -37,18 +94,21 @@ namespace ftp_library
         //! Extract the response code
         //! @param response The response to extract the code from
         //! @return The response code as an integer
-        static int ExtractCode(const std::string &response);
+        static int ExtractCode(std::string_view response);
 
         //! Extract the response message
         //! @param response The response to extract the message from
         //! @return The response message as a string
-        static std::string ExtractMessage(const std::string &response);
+        static std::string ExtractMessage(std::string_view response);
 
         //! Check if a response code matches the expected code
         //! @param response The server's response
         //! @param expectedCode The expected response code
         //! @return True if the response code matches, false otherwise
-        static bool IsExpectedCode(const std::string &response, int expectedCode);
+        static bool IsExpectedCode(std::string_view response, int expectedCode)
+        {
+            return ParseCode(response) == expectedCode;
+        }
     };
 
 }
@@ -0,0 +1,402 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPSessionPool.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:57:26 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPSessionPool.h>
+
+namespace ftp_library
+{
+
+    //! Lease constructor
+    //@ param pool The owning pool
+    //@ param client The leased session
+    FTPSessionPool::Lease::Lease(FTPSessionPool *pool, std::unique_ptr<FTPClient> client)
+        : m_pool(pool), m_client(std::move(client)), m_healthy(true)
+    {
+    }
+
+    //! Lease destructor; returns the session to the pool
+    FTPSessionPool::Lease::~Lease()
+    {
+        Release();
+    }
+
+    //! Lease move constructor
+    FTPSessionPool::Lease::Lease(Lease &&other) noexcept
+        : m_pool(other.m_pool), m_client(std::move(other.m_client)), m_healthy(other.m_healthy)
+    {
+        other.m_pool = nullptr;
+    }
+
+    //! Lease move assignment
+    FTPSessionPool::Lease &FTPSessionPool::Lease::operator=(Lease &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            m_pool = other.m_pool;
+            m_client = std::move(other.m_client);
+            m_healthy = other.m_healthy;
+            other.m_pool = nullptr;
+        }
+        return *this;
+    }
+
+    //! Hand the session back to the owning pool
+    void FTPSessionPool::Lease::Release()
+    {
+        if (m_pool)
+        {
+            m_pool->Release(std::move(m_client), m_healthy);
+            m_pool = nullptr;
+        }
+    }
+
+    //! Constructor; connects and authenticates all sessions up front
+    //@ param host The hostname or IP address of the server
+    //@ param port The port number to connect to
+    //@ param username The username to authenticate with
+    //@ param password The password to authenticate with
+    //@ param size The number of sessions to keep open
+    FTPSessionPool::FTPSessionPool(const std::string &host, uint16_t port, const std::string &username,
+                                   const std::string &password, size_t size)
+        : m_host(FTPUtilities::Trim(host)), m_port(port), m_username(username), m_password(password),
+          m_size(size > 0 ? size : 1), m_leased(0), m_healthCheckInterval(std::chrono::seconds(30)),
+          m_shutdown(false), m_transferRate(0), m_compressionLevel(0), m_transferPipelining(false),
+          m_verifyActivePeer(true)
+    {
+        //* Warm up in parallel so N handshakes cost one round of latency, not N
+        std::vector<std::unique_ptr<FTPClient>> sessions(m_size);
+        std::vector<std::exception_ptr> errors(m_size);
+        std::vector<std::thread> warmers;
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            warmers.emplace_back([this, i, &sessions, &errors]()
+                                 {
+                                     try
+                                     {
+                                         sessions[i] = CreateSession();
+                                     }
+                                     catch (...)
+                                     {
+                                         errors[i] = std::current_exception();
+                                     } });
+        }
+        for (auto &warmer : warmers)
+        {
+            warmer.join();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto &session : sessions)
+        {
+            if (session)
+            {
+                m_idle.push_back({std::move(session), now});
+            }
+        }
+
+        //* Only fail if no session could be opened at all; the rest are retried lazily
+        if (m_idle.empty())
+        {
+            std::rethrow_exception(errors[0]);
+        }
+
+        m_keepAlive = std::thread(&FTPSessionPool::KeepAliveLoop, this);
+    }
+
+    //! Destructor
+    FTPSessionPool::~FTPSessionPool()
+    {
+        Shutdown();
+    }
+
+    //! Take a session from the pool, waiting until one is free
+    //@ return A lease on a connected and authenticated session
+    FTPSessionPool::Lease FTPSessionPool::Acquire()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_available.wait(lock, [this]()
+                         { return m_shutdown || !m_idle.empty() || m_idle.size() + m_leased < m_size; });
+
+        if (m_shutdown)
+        {
+            throw FTPException("Session pool has been shut down.");
+        }
+
+        ++m_leased;
+        if (m_idle.empty())
+        {
+            //* A slot is free but has no session: open one outside the lock
+            lock.unlock();
+            try
+            {
+                return Lease(this, CreateSession());
+            }
+            catch (...)
+            {
+                Release(nullptr, false);
+                throw;
+            }
+        }
+
+        //* Most recently used first keeps the hottest sessions busy
+        IdleSession idle = std::move(m_idle.back());
+        m_idle.pop_back();
+        std::shared_ptr<FTPMetricsSink> sink = m_metricsSink;
+        std::shared_ptr<FTPTracer> tracer = m_tracer;
+        std::shared_ptr<FTPBandwidthLimits> limits = m_bandwidthLimits;
+        uint64_t transferRate = m_transferRate;
+        std::shared_ptr<const SocketOptions> socketOptions = m_socketOptions;
+        int compressionLevel = m_compressionLevel;
+        bool transferPipelining = m_transferPipelining;
+        std::shared_ptr<FTPListenerPool> listeners = m_listeners;
+        bool verifyActivePeer = m_verifyActivePeer;
+        lock.unlock();
+        idle.client->SetMetricsSink(std::move(sink));
+        idle.client->SetTracer(std::move(tracer));
+        idle.client->SetBandwidthLimits(std::move(limits));
+        idle.client->SetTransferRateLimit(transferRate);
+        idle.client->SetCompressionLevel(compressionLevel);
+        idle.client->SetTransferPipelining(transferPipelining);
+        idle.client->SetActiveMode(std::move(listeners), verifyActivePeer);
+        if (socketOptions)
+        {
+            idle.client->SetSocketOptions(*socketOptions);
+        }
+
+        if (std::chrono::steady_clock::now() - idle.lastUsed >= m_healthCheckInterval && !CheckSession(*idle.client))
+        {
+            try
+            {
+                idle.client = CreateSession();
+            }
+            catch (...)
+            {
+                Release(nullptr, false);
+                throw;
+            }
+        }
+
+        return Lease(this, std::move(idle.client));
+    }
+
+    //! Send NOOP on every idle session that has not been used recently
+    void FTPSessionPool::HealthCheck()
+    {
+        std::vector<IdleSession> stale;
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto it = m_idle.begin(); it != m_idle.end();)
+            {
+                if (now - it->lastUsed >= m_healthCheckInterval)
+                {
+                    stale.push_back(std::move(*it));
+                    it = m_idle.erase(it);
+                    ++m_leased;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        for (auto &idle : stale)
+        {
+            bool healthy = CheckSession(*idle.client);
+            Release(std::move(idle.client), healthy);
+        }
+    }
+
+    //! Set how long a session may sit idle before it is checked with NOOP
+    //@ param interval The idle interval
+    void FTPSessionPool::SetHealthCheckInterval(std::chrono::milliseconds interval)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_healthCheckInterval = interval;
+        m_wake.notify_all();
+    }
+
+    //! Report the operations of every session to a metrics sink from their next lease on
+    //@ param sink The sink, or nullptr to stop reporting
+    void FTPSessionPool::SetMetricsSink(std::shared_ptr<FTPMetricsSink> sink)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_metricsSink = std::move(sink);
+    }
+
+    //! Record the spans of every session in a tracer from their next lease on
+    //@ param tracer The tracer, or nullptr to stop tracing
+    void FTPSessionPool::SetTracer(std::shared_ptr<FTPTracer> tracer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tracer = std::move(tracer);
+    }
+
+    //! Make every session obey shared global and per-host limits from their next lease on
+    //@ param limits The limits, or nullptr to remove them
+    void FTPSessionPool::SetBandwidthLimits(std::shared_ptr<FTPBandwidthLimits> limits)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bandwidthLimits = std::move(limits);
+    }
+
+    //! Limit each transfer of every session from their next lease on
+    //@ param bytesPerSecond The rate, 0 for unlimited
+    void FTPSessionPool::SetTransferRateLimit(uint64_t bytesPerSecond)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_transferRate = bytesPerSecond;
+    }
+
+    //! Set the TCP options of every session from their next lease on
+    //@ param options The options to use
+    void FTPSessionPool::SetSocketOptions(const SocketOptions &options)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_socketOptions = std::make_shared<const SocketOptions>(options);
+    }
+
+    //! Set the MODE Z compression level of every session from their next lease on
+    //@ param level The zlib level 1-9, or 0 to turn compression off
+    void FTPSessionPool::SetCompressionLevel(int level)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_compressionLevel = level;
+    }
+
+    //! Pipeline the data connection setup of every session from their next lease on
+    //@ param enabled True to send the transfer command right behind EPSV
+    void FTPSessionPool::SetTransferPipelining(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_transferPipelining = enabled;
+    }
+
+    //! Use active mode data connections for every session from their next lease on
+    //@ param listeners The listener pool the sessions share, or nullptr for passive mode
+    //@ param verifyPeer Accept data connections from the control connection's peer only
+    void FTPSessionPool::SetActiveMode(std::shared_ptr<FTPListenerPool> listeners, bool verifyPeer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listeners = std::move(listeners);
+        m_verifyActivePeer = verifyPeer;
+    }
+
+    //! Get the number of idle sessions ready to be leased
+    size_t FTPSessionPool::IdleCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_idle.size();
+    }
+
+    //! Close all idle sessions and stop the keepalive thread
+    void FTPSessionPool::Shutdown()
+    {
+        std::deque<IdleSession> idle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+            idle.swap(m_idle);
+        }
+        m_wake.notify_all();
+        m_available.notify_all();
+
+        if (m_keepAlive.joinable())
+        {
+            m_keepAlive.join();
+        }
+        //* Idle sessions send QUIT as they are destroyed here
+    }
+
+    //! Connect and authenticate a new session
+    //@ return The new session
+    std::unique_ptr<FTPClient> FTPSessionPool::CreateSession() const
+    {
+        auto client = std::make_unique<FTPClient>();
+        client->SetVerbose(false);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            client->SetMetricsSink(m_metricsSink);
+            client->SetTracer(m_tracer);
+            client->SetBandwidthLimits(m_bandwidthLimits);
+            client->SetTransferRateLimit(m_transferRate);
+            client->SetCompressionLevel(m_compressionLevel);
+            client->SetTransferPipelining(m_transferPipelining);
+            client->SetActiveMode(m_listeners, m_verifyActivePeer);
+            if (m_socketOptions)
+            {
+                client->SetSocketOptions(*m_socketOptions);
+            }
+        }
+        client->Connect(m_host, m_port);
+        client->Authenticate(m_username, m_password);
+        return client;
+    }
+
+    //! Return a session to the pool
+    //@ param client The session, or null if the slot should just be freed
+    //@ param healthy False if the session must be discarded
+    void FTPSessionPool::Release(std::unique_ptr<FTPClient> client, bool healthy)
+    {
+        std::unique_ptr<FTPClient> discard;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_leased;
+            if (client && healthy && client->IsConnected() && !m_shutdown)
+            {
+                m_idle.push_back({std::move(client), std::chrono::steady_clock::now()});
+            }
+            else
+            {
+                discard = std::move(client);
+            }
+        }
+        m_available.notify_one();
+        //* Broken sessions are closed outside the lock
+    }
+
+    //! Send NOOP to check a session
+    //@ param client The session to check
+    //@ return False if the session is dead
+    bool FTPSessionPool::CheckSession(FTPClient &client) const
+    {
+        try
+        {
+            client.Noop();
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+    }
+
+    //! Background thread that keeps idle sessions from timing out
+    void FTPSessionPool::KeepAliveLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_shutdown)
+        {
+            m_wake.wait_for(lock, m_healthCheckInterval);
+            if (m_shutdown)
+            {
+                break;
+            }
+            lock.unlock();
+            HealthCheck();
+            lock.lock();
+        }
+    }
+
+}
@@ -0,0 +1,184 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPSessionPool.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 22:57:26 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPSESSIONPOOL_H
+#define FTPSESSIONPOOL_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    class FTPClient;
+    class FTPMetricsSink;
+    class FTPTracer;
+    class FTPBandwidthLimits;
+    struct SocketOptions;
+    class FTPListenerPool;
+
+    //! Pool of connected and authenticated sessions to a single host
+    //! Sessions are handed out to worker threads through RAII leases and
+    //! returned automatically. Idle sessions are kept alive with NOOP and
+    //! replaced when the server drops them.
+    class FTPSessionPool
+    {
+    public:
+        //! Exclusive handle to a pooled session, returned to the pool on destruction
+        class Lease
+        {
+        public:
+            Lease(FTPSessionPool *pool, std::unique_ptr<FTPClient> client);
+            ~Lease();
+
+            //! Prevent copy construction and assignment
+            Lease(const Lease &) = delete;
+            Lease &operator=(const Lease &) = delete;
+
+            //! Move constructor and move assignment
+            Lease(Lease &&other) noexcept;
+            Lease &operator=(Lease &&other) noexcept;
+
+            FTPClient *operator->() const
+            {
+                return m_client.get();
+            }
+
+            FTPClient &operator*() const
+            {
+                return *m_client;
+            }
+
+            //! Mark the session as broken so the pool reconnects instead of reusing it
+            void Invalidate()
+            {
+                m_healthy = false;
+            }
+
+        private:
+            void Release();
+
+            FTPSessionPool *m_pool;             //* Owning pool
+            std::unique_ptr<FTPClient> m_client; //* Leased session
+            bool m_healthy;                     //* False if the session must not be reused
+        };
+
+        //! Constructor; connects and authenticates all sessions up front
+        //! @param host The hostname or IP address of the server
+        //! @param port The port number to connect to
+        //! @param username The username to authenticate with
+        //! @param password The password to authenticate with
+        //! @param size The number of sessions to keep open
+        FTPSessionPool(const std::string &host, uint16_t port, const std::string &username,
+                       const std::string &password, size_t size);
+        ~FTPSessionPool();
+
+        //! Prevent copy construction and assignment
+        FTPSessionPool(const FTPSessionPool &) = delete;
+        FTPSessionPool &operator=(const FTPSessionPool &) = delete;
+
+        //! Take a session from the pool, waiting until one is free
+        //! Sessions idle for longer than the health-check interval are checked with NOOP first
+        //! @return A lease on a connected and authenticated session
+        Lease Acquire();
+
+        //! Send NOOP on every idle session that has not been used recently
+        //! Sessions that fail are dropped and reopened on the next Acquire
+        void HealthCheck();
+
+        //! Set how long a session may sit idle before it is checked with NOOP
+        //! @param interval The idle interval (default 30 seconds)
+        void SetHealthCheckInterval(std::chrono::milliseconds interval);
+
+        //! Report the operations of every session to a metrics sink from their next lease on
+        //! @param sink The sink, or nullptr to stop reporting
+        void SetMetricsSink(std::shared_ptr<FTPMetricsSink> sink);
+
+        //! Record the spans of every session in a tracer from their next lease on
+        //! @param tracer The tracer, or nullptr to stop tracing
+        void SetTracer(std::shared_ptr<FTPTracer> tracer);
+
+        //! Make every session obey shared global and per-host limits from their next lease on
+        //! @param limits The limits, or nullptr to remove them
+        void SetBandwidthLimits(std::shared_ptr<FTPBandwidthLimits> limits);
+
+        //! Limit each transfer of every session from their next lease on
+        //! @param bytesPerSecond The rate, 0 for unlimited
+        void SetTransferRateLimit(uint64_t bytesPerSecond);
+
+        //! Set the TCP options of every session from their next lease on
+        //! @param options The options to use
+        void SetSocketOptions(const SocketOptions &options);
+
+        //! Set the MODE Z compression level of every session from their next lease on
+        //! @param level The zlib level 1-9, or 0 to turn compression off
+        void SetCompressionLevel(int level);
+
+        //! Pipeline the data connection setup of every session from their next lease on
+        //! @param enabled True to send the transfer command right behind EPSV
+        void SetTransferPipelining(bool enabled);
+
+        //! Use active mode data connections for every session from their next lease on
+        //! @param listeners The listener pool the sessions share, or nullptr for passive mode
+        //! @param verifyPeer Accept data connections from the control connection's peer only
+        void SetActiveMode(std::shared_ptr<FTPListenerPool> listeners, bool verifyPeer = true);
+
+        //! Get the maximum number of sessions
+        size_t Size() const
+        {
+            return m_size;
+        }
+
+        //! Get the number of idle sessions ready to be leased
+        size_t IdleCount() const;
+
+        //! Close all idle sessions and stop the keepalive thread
+        void Shutdown();
+
+    private:
+        struct IdleSession
+        {
+            std::unique_ptr<FTPClient> client;             //* Connected and authenticated session
+            std::chrono::steady_clock::time_point lastUsed; //* When the session was last returned
+        };
+
+        std::unique_ptr<FTPClient> CreateSession() const;                  //* Connect and authenticate a new session
+        void Release(std::unique_ptr<FTPClient> client, bool healthy);     //* Return a session to the pool
+        bool CheckSession(FTPClient &client) const;                        //* Send NOOP, false if the session is dead
+        void KeepAliveLoop();                                              //* Background health-check thread
+
+        std::string m_host;                            //* Server host
+        uint16_t m_port;                               //* Server port
+        std::string m_username;                        //* Username for new sessions
+        std::string m_password;                        //* Password for new sessions
+        size_t m_size;                                 //* Maximum number of sessions
+        size_t m_leased;                               //* Sessions currently leased or being opened
+        std::chrono::milliseconds m_healthCheckInterval; //* Idle time before a NOOP check
+        std::deque<IdleSession> m_idle;                //* Sessions ready to be leased
+        mutable std::mutex m_mutex;                    //* Guards the pool state
+        std::condition_variable m_available;           //* Signalled when a session is returned
+        std::condition_variable m_wake;                //* Wakes the keepalive thread
+        bool m_shutdown;                               //* True once Shutdown() has been called
+        std::shared_ptr<FTPMetricsSink> m_metricsSink; //* Sink handed to leased sessions
+        std::shared_ptr<FTPTracer> m_tracer;           //* Tracer handed to leased sessions
+        std::shared_ptr<FTPBandwidthLimits> m_bandwidthLimits; //* Limits handed to leased sessions
+        uint64_t m_transferRate;                       //* Per-transfer limit of leased sessions, 0 for none
+        std::shared_ptr<const SocketOptions> m_socketOptions; //* TCP options of leased sessions, null for defaults
+        int m_compressionLevel;                        //* MODE Z level of leased sessions, 0 for none
+        bool m_transferPipelining;                     //* Pipelined data connection setup for leased sessions
+        std::shared_ptr<FTPListenerPool> m_listeners;  //* Active mode listeners for leased sessions, null for passive
+        bool m_verifyActivePeer;                       //* Active mode peer check of leased sessions
+        std::thread m_keepAlive;                       //* Background health-check thread
+    };
+
+}
+
+#endif
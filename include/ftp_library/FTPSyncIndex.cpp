@@ -0,0 +1,164 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPSyncIndex.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:23:47 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPSyncIndex.h>
+
+namespace ftp_library
+{
+
+    //! First line of every index file
+    static const char *const kIndexHeader = "# ftp-sync-index v1";
+
+    //! Load an index file, replacing the current contents
+    //@ param path The index file
+    void FTPSyncIndex::Load(const std::string &path)
+    {
+        std::unordered_map<std::string, RemoteFileInfo> files;
+
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file)
+        {
+            std::string line;
+            char buffer[4096];
+            while (fgets(buffer, sizeof(buffer), file))
+            {
+                line += buffer;
+                if (line.empty() || line.back() != '\n')
+                {
+                    continue; //* Long line, keep reading
+                }
+                line.pop_back();
+
+                //* size, mtime and hash come first so the path may contain tabs
+                size_t first = line.find('\t');
+                size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+                size_t third = second == std::string::npos ? second : line.find('\t', second + 1);
+                if (line[0] != '#' && third != std::string::npos && third + 1 < line.size())
+                {
+                    RemoteFileInfo info;
+                    char *end = nullptr;
+                    info.size = std::strtoull(line.c_str(), &end, 10);
+                    bool valid = end == line.c_str() + first;
+                    info.mtime = std::strtoll(line.c_str() + first + 1, &end, 10);
+                    valid = valid && end == line.c_str() + second;
+                    info.hash = line.substr(second + 1, third - second - 1);
+                    if (valid)
+                    {
+                        files[line.substr(third + 1)] = std::move(info);
+                    }
+                }
+                line.clear();
+            }
+            fclose(file);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files = std::move(files);
+    }
+
+    //! Write the index atomically
+    //@ param path The index file
+    void FTPSyncIndex::Save(const std::string &path) const
+    {
+        std::string temporary = path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            throw FTPException("Failed to open sync index for writing: " + temporary);
+        }
+
+        bool ok = fprintf(file, "%s\n", kIndexHeader) > 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto &[remotePath, info] : m_files)
+            {
+                if (remotePath.find('\n') != std::string::npos)
+                {
+                    continue; //* Cannot be represented in a line based file
+                }
+                ok = ok && fprintf(file, "%llu\t%lld\t%s\t%s\n", static_cast<unsigned long long>(info.size),
+                                   static_cast<long long>(info.mtime), info.hash.c_str(), remotePath.c_str()) > 0;
+            }
+        }
+        ok = fclose(file) == 0 && ok;
+
+        std::error_code error;
+        if (ok)
+        {
+            std::filesystem::rename(temporary, path, error);
+        }
+        if (!ok || error)
+        {
+            std::filesystem::remove(temporary, error);
+            throw FTPException("Failed to write sync index: " + path);
+        }
+    }
+
+    //! Check whether a file must be transferred again
+    //@ param remotePath The path on the server
+    //@ param fresh The metadata just read from the server
+    //@ return True if the file is unknown or its size, mtime or hash changed
+    bool FTPSyncIndex::IsChanged(const std::string &remotePath, const RemoteFileInfo &fresh) const
+    {
+        RemoteFileInfo recorded;
+        if (!Find(remotePath, recorded))
+        {
+            return true;
+        }
+
+        //* Only compare what both sides know; the size is always known
+        return recorded.size != fresh.size ||
+               (fresh.mtime >= 0 && recorded.mtime != fresh.mtime) ||
+               (!fresh.hash.empty() && recorded.hash != fresh.hash);
+    }
+
+    //! Look up a recorded file
+    //@ param remotePath The path on the server
+    //@ param info Receives the recorded metadata
+    //@ return True if the file is recorded
+    bool FTPSyncIndex::Find(const std::string &remotePath, RemoteFileInfo &info) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_files.find(remotePath);
+        if (it == m_files.end())
+        {
+            return false;
+        }
+        info = it->second;
+        return true;
+    }
+
+    //! Record a file after a successful transfer
+    //@ param remotePath The path on the server
+    //@ param info The metadata the transfer was based on
+    void FTPSyncIndex::Update(const std::string &remotePath, const RemoteFileInfo &info)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files[remotePath] = info;
+    }
+
+    //! Forget a file
+    //@ param remotePath The path on the server
+    void FTPSyncIndex::Erase(const std::string &remotePath)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files.erase(remotePath);
+    }
+
+    //! Get the number of recorded files
+    size_t FTPSyncIndex::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_files.size();
+    }
+
+}
@@ -0,0 +1,77 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPSyncIndex.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:23:47 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPSYNCINDEX_H
+#define FTPSYNCINDEX_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Remote metadata recorded for one synced file
+    struct RemoteFileInfo
+    {
+        uint64_t size = 0;  //* Size in bytes
+        int64_t mtime = -1; //* Modification time in UTC seconds, -1 if unknown
+        std::string hash;   //* Optional content hash (e.g. from HASH/XCRC), empty if unknown
+    };
+
+    //! Persistent index of remote path -> size, mtime and hash
+    //! A mirror consults the index to skip files whose fresh MLSD/MDTM/SIZE data
+    //! still matches what was transferred last time. The index is a plain text
+    //! file with one "size<TAB>mtime<TAB>hash<TAB>path" line per file and is
+    //! safe to use from several worker threads.
+    class FTPSyncIndex
+    {
+    public:
+        //! Load an index file, replacing the current contents
+        //! A missing file yields an empty index; malformed lines are skipped.
+        //! @param path The index file
+        void Load(const std::string &path);
+
+        //! Write the index atomically (temporary file plus rename)
+        //! @param path The index file
+        void Save(const std::string &path) const;
+
+        //! Check whether a file must be transferred again
+        //! @param remotePath The path on the server
+        //! @param fresh The metadata just read from the server
+        //! @return True if the file is unknown or its size, mtime or hash changed
+        bool IsChanged(const std::string &remotePath, const RemoteFileInfo &fresh) const;
+
+        //! Look up a recorded file
+        //! @param remotePath The path on the server
+        //! @param info Receives the recorded metadata
+        //! @return True if the file is recorded
+        bool Find(const std::string &remotePath, RemoteFileInfo &info) const;
+
+        //! Record a file after a successful transfer
+        //! @param remotePath The path on the server
+        //! @param info The metadata the transfer was based on
+        void Update(const std::string &remotePath, const RemoteFileInfo &info);
+
+        //! Forget a file
+        //! @param remotePath The path on the server
+        void Erase(const std::string &remotePath);
+
+        //! Get the number of recorded files
+        size_t Size() const;
+
+    private:
+        std::unordered_map<std::string, RemoteFileInfo> m_files; //* Recorded files by remote path
+        mutable std::mutex m_mutex;                              //* Guards m_files
+    };
+
+}
+
+#endif
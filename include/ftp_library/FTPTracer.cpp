@@ -0,0 +1,179 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTracer.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:55:57 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPTracer.h>
+
+namespace ftp_library
+{
+
+    //! Get a small, stable id for the calling thread (trace viewers sort tracks by it)
+    //@ return The thread id, starting at 1
+    static uint32_t CurrentThreadId()
+    {
+        static std::atomic<uint32_t> nextId{1};
+        thread_local uint32_t id = nextId.fetch_add(1);
+        return id;
+    }
+
+    //! Format nanoseconds as the fractional microseconds Chrome traces use
+    //@ param nanoseconds The time in nanoseconds
+    //@ return The formatted number of microseconds
+    static std::string FormatMicroseconds(int64_t nanoseconds)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(nanoseconds / 1000),
+                      static_cast<long long>(nanoseconds % 1000));
+        return buffer;
+    }
+
+    //! Constructor
+    //@ param maxEvents Spans kept before further spans are dropped
+    FTPTracer::FTPTracer(size_t maxEvents) : m_epoch(Clock::now()), m_maxEvents(maxEvents)
+    {
+    }
+
+    //! Record a finished span
+    //@ param category The span category
+    //@ param name The span name
+    //@ param start When the span began
+    //@ param end When the span ended
+    //@ param args Comma-separated JSON members for the args object
+    void FTPTracer::AddSpan(const char *category, std::string name, Clock::time_point start, Clock::time_point end,
+                            std::string args)
+    {
+        Event event;
+        event.category = category;
+        event.name = std::move(name);
+        event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_epoch).count();
+        event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        event.thread = CurrentThreadId();
+        event.args = std::move(args);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_events.size() >= m_maxEvents)
+        {
+            ++m_dropped;
+            return;
+        }
+        m_events.push_back(std::move(event));
+    }
+
+    //! Get the number of recorded spans
+    size_t FTPTracer::Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_events.size();
+    }
+
+    //! Get the number of spans dropped because the tracer was full
+    uint64_t FTPTracer::Dropped() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+    //! Drop every recorded span
+    void FTPTracer::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_events.clear();
+        m_dropped = 0;
+    }
+
+    //! Render the recorded spans in Chrome trace event JSON format
+    //@ return The JSON document
+    std::string FTPTracer::ToChromeJson() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        json.reserve(json.size() + m_events.size() * 160);
+        bool first = true;
+        for (const auto &event : m_events)
+        {
+            json += first ? "\n" : ",\n";
+            first = false;
+            json += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.thread);
+            json += ",\"cat\":\"" + std::string(event.category) + "\"";
+            json += ",\"name\":\"" + FTPUtilities::EscapeJson(event.name) + "\"";
+            json += ",\"ts\":" + FormatMicroseconds(event.start);
+            json += ",\"dur\":" + FormatMicroseconds(event.duration);
+            if (!event.args.empty())
+            {
+                json += ",\"args\":{" + event.args + "}";
+            }
+            json += "}";
+        }
+        json += "\n],\"otherData\":{\"dropped_events\":" + std::to_string(m_dropped) + "}}\n";
+        return json;
+    }
+
+    //! Write the Chrome trace JSON atomically
+    //@ param path The trace file
+    void FTPTracer::WriteChromeTrace(const std::string &path) const
+    {
+        std::string temporary = path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            throw FTPException("Failed to open trace file for writing: " + temporary, -1);
+        }
+
+        std::string json = ToChromeJson();
+        bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+        ok = fclose(file) == 0 && ok;
+
+        std::error_code error;
+        if (ok)
+        {
+            std::filesystem::rename(temporary, path, error);
+        }
+        if (!ok || error)
+        {
+            std::filesystem::remove(temporary, error);
+            throw FTPException("Failed to write trace file: " + path, -1);
+        }
+    }
+
+    //! Attach a string argument
+    //@ param key The argument name
+    //@ param value The value
+    void FTPTraceSpan::Arg(const char *key, const std::string &value)
+    {
+        if (!m_tracer)
+        {
+            return;
+        }
+        if (!m_args.empty())
+        {
+            m_args += ',';
+        }
+        m_args += std::string("\"") + key + "\":\"" + FTPUtilities::EscapeJson(value) + "\"";
+    }
+
+    //! Attach a numeric argument
+    //@ param key The argument name
+    //@ param value The value
+    void FTPTraceSpan::Arg(const char *key, int64_t value)
+    {
+        if (!m_tracer)
+        {
+            return;
+        }
+        if (!m_args.empty())
+        {
+            m_args += ',';
+        }
+        m_args += std::string("\"") + key + "\":" + std::to_string(value);
+    }
+
+}
@@ -0,0 +1,152 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTracer.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 19:55:57 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPTRACER_H
+#define FTPTRACER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    //! Collects timed spans and exports them as a Chrome trace
+    //! Clients attached with SetTracer record one span per control command,
+    //! reply wait, data connection setup, transfer loop and operation. The
+    //! result loads in chrome://tracing and ui.perfetto.dev, one track per
+    //! thread. A tracer may be shared by any number of clients and threads.
+    class FTPTracer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        //! Constructor
+        //! @param maxEvents Spans kept before further spans are dropped (and counted)
+        explicit FTPTracer(size_t maxEvents = 1000000);
+
+        //! Record a finished span
+        //! @param category The span category ("operation", "control", "data", "transfer")
+        //! @param name The span name
+        //! @param start When the span began
+        //! @param end When the span ended
+        //! @param args Comma-separated JSON members for the "args" object, may be empty
+        void AddSpan(const char *category, std::string name, Clock::time_point start, Clock::time_point end,
+                     std::string args = "");
+
+        //! Get the number of recorded spans
+        size_t Size() const;
+
+        //! Get the number of spans dropped because the tracer was full
+        uint64_t Dropped() const;
+
+        //! Drop every recorded span
+        void Clear();
+
+        //! Render the recorded spans in Chrome trace event JSON format
+        //! @return The JSON document
+        std::string ToChromeJson() const;
+
+        //! Write the Chrome trace JSON atomically (temporary file plus rename)
+        //! Throws FTPException if the file cannot be written
+        //! @param path The trace file, conventionally ending in .json
+        void WriteChromeTrace(const std::string &path) const;
+
+    private:
+        struct Event
+        {
+            const char *category; //* Static category string
+            std::string name;     //* Span name
+            int64_t start;        //* Start in ns since the tracer was created
+            int64_t duration;     //* Duration in ns
+            uint32_t thread;      //* Small per-thread id
+            std::string args;     //* JSON members of the args object
+        };
+
+        Clock::time_point m_epoch;   //* Time zero of the trace
+        size_t m_maxEvents;          //* Capacity
+        std::vector<Event> m_events; //* Recorded spans
+        uint64_t m_dropped = 0;      //* Spans over capacity
+        mutable std::mutex m_mutex;  //* Guards the events
+    };
+
+    //! Times a scope and records it as a span when the scope ends
+    //! Without a tracer the span stores a null pointer and does nothing else:
+    //! no clock reads, no allocations.
+    class FTPTraceSpan
+    {
+    public:
+        //! Constructor
+        //! @param tracer The tracer, or nullptr to disable the span
+        //! @param category The span category (a string literal)
+        //! @param name The span name (a string literal)
+        FTPTraceSpan(FTPTracer *tracer, const char *category, const char *name)
+            : m_tracer(tracer), m_category(category), m_literalName(name)
+        {
+            if (m_tracer)
+            {
+                m_start = FTPTracer::Clock::now();
+            }
+        }
+
+        ~FTPTraceSpan()
+        {
+            End();
+        }
+
+        FTPTraceSpan(const FTPTraceSpan &) = delete;
+        FTPTraceSpan &operator=(const FTPTraceSpan &) = delete;
+
+        //! Check whether the span is recorded; guard argument formatting with it
+        bool Active() const
+        {
+            return m_tracer != nullptr;
+        }
+
+        //! Record the span now instead of at the end of the scope
+        void End()
+        {
+            if (m_tracer)
+            {
+                m_tracer->AddSpan(m_category, m_name.empty() ? std::string(m_literalName) : std::move(m_name),
+                                  m_start, FTPTracer::Clock::now(), std::move(m_args));
+                m_tracer = nullptr;
+            }
+        }
+
+        //! Replace the span name
+        //! @param name The new name
+        void SetName(std::string name)
+        {
+            m_name = std::move(name);
+        }
+
+        //! Attach a string argument
+        //! @param key The argument name (a JSON-safe literal)
+        //! @param value The value, escaped as needed
+        void Arg(const char *key, const std::string &value);
+
+        //! Attach a numeric argument
+        //! @param key The argument name (a JSON-safe literal)
+        //! @param value The value
+        void Arg(const char *key, int64_t value);
+
+    private:
+        FTPTracer *m_tracer;                     //* Tracer to record into, or null
+        const char *m_category;                  //* Span category
+        const char *m_literalName;               //* Span name unless replaced
+        std::string m_name;                      //* Replacement name
+        std::string m_args;                      //* JSON members of the args object
+        FTPTracer::Clock::time_point m_start{};  //* When the span began
+    };
+
+}
+
+#endif
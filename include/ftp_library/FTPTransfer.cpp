@@ -0,0 +1,541 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTransfer.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 21:30:58 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPTransfer.h>
+
+namespace ftp_library
+{
+
+    //! Flags for send(): avoid SIGPIPE when the server drops the data connection
+#if defined(MSG_NOSIGNAL)
+    static constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    static constexpr int kSendFlags = 0;
+#endif
+
+#if defined(__linux__)
+    //! Blocks SIGPIPE on the calling thread while it lives; sendfile(2) cannot take MSG_NOSIGNAL
+    //! A SIGPIPE raised meanwhile is consumed before the old mask is restored, so a dropped
+    //! connection surfaces as EPIPE only. A SIGPIPE already pending beforehand is left alone.
+    class SigPipeBlock
+    {
+    public:
+        SigPipeBlock()
+        {
+            sigemptyset(&m_set);
+            sigaddset(&m_set, SIGPIPE);
+            sigset_t pending;
+            sigpending(&pending);
+            m_wasPending = sigismember(&pending, SIGPIPE) == 1;
+            sigset_t previous;
+            pthread_sigmask(SIG_BLOCK, &m_set, &previous);
+            m_wasBlocked = sigismember(&previous, SIGPIPE) == 1;
+        }
+
+        ~SigPipeBlock()
+        {
+            if (!m_wasPending)
+            {
+                timespec immediately = {0, 0};
+                while (sigtimedwait(&m_set, nullptr, &immediately) == SIGPIPE)
+                {
+                }
+            }
+            if (!m_wasBlocked)
+            {
+                pthread_sigmask(SIG_UNBLOCK, &m_set, nullptr);
+            }
+        }
+
+        SigPipeBlock(const SigPipeBlock &) = delete;
+        SigPipeBlock &operator=(const SigPipeBlock &) = delete;
+
+    private:
+        sigset_t m_set;    //* Just SIGPIPE
+        bool m_wasPending; //* A SIGPIPE was pending before, not ours to consume
+        bool m_wasBlocked; //* SIGPIPE was already blocked; leave it that way
+    };
+#endif
+
+    //! Copy everything from a data socket into a file until the peer closes
+    //@ param socket The connected data socket
+    //@ param file The local file opened for writing
+    //@ param bufferSize The size of the fallback buffer in bytes
+    //@ param zeroCopy Allow the splice fast path
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ return Statistics for the transfer
+    TransferStats FTPTransfer::ReceiveToFile(int socket, FILE *file, size_t bufferSize, bool zeroCopy,
+                                             FTPThrottle *throttle)
+    {
+        TransferStats stats;
+        auto start = std::chrono::steady_clock::now();
+
+        if (!zeroCopy || !SpliceToFile(socket, fileno(file), stats, start, throttle))
+        {
+            CopyToFile(socket, file, bufferSize, stats, start, throttle);
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Send the whole contents of a file over a data socket
+    //@ param socket The connected data socket
+    //@ param file The local file opened for reading
+    //@ param bufferSize The size of the fallback buffer in bytes
+    //@ param zeroCopy Allow the sendfile and mmap fast paths
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ return Statistics for the transfer
+    TransferStats FTPTransfer::SendFromFile(int socket, FILE *file, size_t bufferSize, bool zeroCopy,
+                                            FTPThrottle *throttle)
+    {
+        TransferStats stats;
+        auto start = std::chrono::steady_clock::now();
+
+        if (!zeroCopy || (!SendFileZeroCopy(socket, fileno(file), stats, throttle) &&
+                          !SendFileMapped(socket, fileno(file), stats, throttle)))
+        {
+            CopyFromFile(socket, file, bufferSize, stats, throttle);
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Hand everything from a data socket to a sink until the peer closes
+    //@ param socket The connected data socket
+    //@ param sink Receives each chunk as it arrives
+    //@ param bufferSize The size of the receive buffer in bytes
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ param inflate The connection carries MODE Z data; the sink gets it decompressed
+    //@ return Statistics for the transfer
+    TransferStats FTPTransfer::ReceiveToSink(int socket, const std::function<void(const char *, size_t)> &sink,
+                                             size_t bufferSize, FTPThrottle *throttle, bool inflate)
+    {
+        TransferStats stats;
+        auto start = std::chrono::steady_clock::now();
+
+        if (inflate)
+        {
+            FTPInflater inflater;
+            CopyToSink(
+                socket, [&](const char *data, size_t size)
+                { inflater.Write(data, size, sink); },
+                bufferSize, stats, start, throttle);
+        }
+        else
+        {
+            CopyToSink(socket, sink, bufferSize, stats, start, throttle);
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Send everything a source produces over a data socket
+    //@ param socket The connected data socket
+    //@ param source Fills the send buffer until it returns 0
+    //@ param bufferSize The size of the send buffer in bytes
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ param deflateLevel Compress for MODE Z at this zlib level, 0 to send as is
+    //@ return Statistics for the transfer
+    TransferStats FTPTransfer::SendFromSource(int socket, const std::function<size_t(char *, size_t)> &source,
+                                              size_t bufferSize, FTPThrottle *throttle, int deflateLevel)
+    {
+        TransferStats stats;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<char> buffer(bufferSize > 0 ? bufferSize : kDefaultBufferSize);
+        std::unique_ptr<FTPDeflater> deflater;
+        if (deflateLevel > 0)
+        {
+            deflater = std::make_unique<FTPDeflater>(deflateLevel);
+        }
+        const FTPDeflater::Output send = [&](const char *data, size_t size)
+        { SendAll(socket, data, size, stats, throttle); };
+        size_t produced;
+
+        while ((produced = source(buffer.data(), buffer.size())) > 0)
+        {
+            if (produced > buffer.size())
+            {
+                throw FTPException("Data source overran its buffer.", -1);
+            }
+            if (deflater)
+            {
+                deflater->Write(buffer.data(), produced, send);
+            }
+            else
+            {
+                send(buffer.data(), produced);
+            }
+        }
+        if (deflater)
+        {
+            deflater->Finish(send);
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Send a buffer, retrying until every byte is written
+    //@ param socket The connected socket
+    //@ param data The bytes to send
+    //@ param size The number of bytes
+    //@ param stats Receives the bytes and syscall counts
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    void FTPTransfer::SendAll(int socket, const char *data, size_t size, TransferStats &stats, FTPThrottle *throttle)
+    {
+        while (size > 0)
+        {
+            size_t chunk = throttle ? throttle->ChunkLimit(size) : size;
+            ssize_t bytesSent = send(socket, data, static_cast<int>(chunk), kSendFlags);
+            ++stats.syscalls;
+            if (bytesSent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (bytesSent <= 0)
+            {
+                throw FTPException("Failed to send file data.");
+            }
+            data += bytesSent;
+            size -= bytesSent;
+            stats.bytes += bytesSent;
+            if (throttle)
+            {
+                throttle->Consume(bytesSent);
+            }
+        }
+    }
+
+    //! Format a throughput figure for display
+    //@ param bytesPerSecond The throughput in bytes per second
+    //@ return The formatted string
+    std::string FTPTransfer::FormatRate(double bytesPerSecond)
+    {
+        static const char *units[] = {"B/s", "KB/s", "MB/s", "GB/s"};
+        size_t unit = 0;
+        while (bytesPerSecond >= 1024.0 && unit < 3)
+        {
+            bytesPerSecond /= 1024.0;
+            ++unit;
+        }
+
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f %s", bytesPerSecond, units[unit]);
+        return buffer;
+    }
+
+    //! Move data from the socket to the file descriptor with splice(2)
+    //@ param socket The connected data socket
+    //@ param fd The local file descriptor
+    //@ param stats Receives the bytes, syscall counts and first byte delay
+    //@ param start When the transfer loop started
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ return False if splice is unavailable and nothing was consumed, true otherwise
+    bool FTPTransfer::SpliceToFile(int socket, int fd, TransferStats &stats, std::chrono::steady_clock::time_point start,
+                                   FTPThrottle *throttle)
+    {
+#if defined(__linux__)
+        int pipeFds[2];
+        if (pipe(pipeFds) < 0)
+        {
+            return false;
+        }
+
+        //* Enlarge the pipe so each splice moves more than the default 64 KiB
+        fcntl(pipeFds[1], F_SETPIPE_SZ, 1024 * 1024);
+
+        const size_t chunk = 1024 * 1024;
+
+        while (true)
+        {
+            ssize_t received = splice(socket, nullptr, pipeFds[1], nullptr, throttle ? throttle->ChunkLimit(chunk) : chunk,
+                                      SPLICE_F_MOVE | SPLICE_F_MORE);
+            ++stats.syscalls;
+            if (received == 0)
+            {
+                break;
+            }
+            if (received < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                close(pipeFds[0]);
+                close(pipeFds[1]);
+                if (stats.bytes == 0 && (errno == EINVAL || errno == ENOSYS))
+                {
+                    //* Socket or file system does not support splice, use the buffered loop
+                    return false;
+                }
+                throw FTPException("Failed to receive file data.");
+            }
+            if (stats.firstByteSeconds < 0.0)
+            {
+                stats.firstByteSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            ssize_t pending = received;
+            while (pending > 0)
+            {
+                ssize_t written = splice(pipeFds[0], nullptr, fd, nullptr, pending, SPLICE_F_MOVE | SPLICE_F_MORE);
+                ++stats.syscalls;
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (written < 0 && errno == EINVAL && stats.bytes == 0)
+                {
+                    //* The file system rejects splice: flush what is in the pipe and fall back
+                    std::vector<char> drain(pending);
+                    bool drained = read(pipeFds[0], drain.data(), pending) == pending &&
+                                   write(fd, drain.data(), pending) == pending;
+                    stats.syscalls += 2;
+                    close(pipeFds[0]);
+                    close(pipeFds[1]);
+                    if (!drained)
+                    {
+                        throw FTPException("Failed to write local file.", -1);
+                    }
+                    stats.bytes += pending;
+                    return false;
+                }
+                if (written <= 0)
+                {
+                    close(pipeFds[0]);
+                    close(pipeFds[1]);
+                    throw FTPException("Failed to write local file.", -1);
+                }
+                pending -= written;
+            }
+            stats.bytes += received;
+            if (throttle)
+            {
+                throttle->Consume(received);
+            }
+        }
+
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        stats.zeroCopy = true;
+        return true;
+#else
+        (void)socket;
+        (void)fd;
+        (void)stats;
+        (void)start;
+        (void)throttle;
+        return false;
+#endif
+    }
+
+    //! Copy data from the socket to the file through a user space buffer
+    //@ param socket The connected data socket
+    //@ param file The local file opened for writing
+    //@ param bufferSize The size of the buffer in bytes
+    //@ param stats Receives the bytes, syscall counts and first byte delay
+    //@ param start When the transfer loop started
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    void FTPTransfer::CopyToFile(int socket, FILE *file, size_t bufferSize, TransferStats &stats,
+                                 std::chrono::steady_clock::time_point start, FTPThrottle *throttle)
+    {
+        CopyToSink(
+            socket,
+            [file](const char *data, size_t size)
+            {
+                if (fwrite(data, 1, size, file) != size)
+                {
+                    throw FTPException("Failed to write local file.", -1);
+                }
+            },
+            bufferSize, stats, start, throttle);
+    }
+
+    //! Copy from the socket into a sink through a user space buffer
+    //@ param socket The connected data socket
+    //@ param sink Receives each chunk as it arrives
+    //@ param bufferSize The size of the buffer in bytes
+    //@ param stats Receives the bytes and syscall counts
+    //@ param start When the transfer started, for the time to first byte
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    void FTPTransfer::CopyToSink(int socket, const std::function<void(const char *, size_t)> &sink, size_t bufferSize,
+                                 TransferStats &stats, std::chrono::steady_clock::time_point start, FTPThrottle *throttle)
+    {
+        std::vector<char> buffer(bufferSize > 0 ? bufferSize : kDefaultBufferSize);
+        ssize_t bytesRead;
+
+        while ((bytesRead = recv(socket, buffer.data(),
+                                 static_cast<int>(throttle ? throttle->ChunkLimit(buffer.size()) : buffer.size()),
+                                 0)) != 0)
+        {
+            ++stats.syscalls;
+            if (bytesRead < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw FTPException("Failed to receive file data.");
+            }
+            if (stats.firstByteSeconds < 0.0)
+            {
+                stats.firstByteSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            sink(buffer.data(), static_cast<size_t>(bytesRead));
+            stats.bytes += bytesRead;
+            if (throttle)
+            {
+                throttle->Consume(bytesRead);
+            }
+        }
+        ++stats.syscalls;
+    }
+
+    //! Send the file with sendfile(2), handling partial sends
+    //@ param socket The connected data socket
+    //@ param fd The local file descriptor
+    //@ param stats Receives the bytes and syscall counts
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ return False if sendfile is unavailable and nothing was sent, true otherwise
+    bool FTPTransfer::SendFileZeroCopy(int socket, int fd, TransferStats &stats, FTPThrottle *throttle)
+    {
+#if defined(__linux__)
+        struct stat info;
+        if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode))
+        {
+            return false;
+        }
+
+        SigPipeBlock sigPipeBlock;
+        off_t offset = 0;
+        while (offset < info.st_size)
+        {
+            size_t remaining = std::min<size_t>(static_cast<size_t>(info.st_size - offset), 1 << 30);
+            ssize_t bytesSent = sendfile(socket, fd, &offset, throttle ? throttle->ChunkLimit(remaining) : remaining);
+            ++stats.syscalls;
+            if (bytesSent < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                {
+                    continue;
+                }
+                if (offset == 0 && (errno == EINVAL || errno == ENOSYS))
+                {
+                    return false;
+                }
+                throw FTPException("Failed to send file data.");
+            }
+            if (bytesSent == 0)
+            {
+                //* File shrank underneath us, nothing more to send
+                break;
+            }
+            stats.bytes += bytesSent;
+            if (throttle)
+            {
+                throttle->Consume(bytesSent);
+            }
+        }
+
+        stats.zeroCopy = true;
+        return true;
+#else
+        (void)socket;
+        (void)fd;
+        (void)stats;
+        (void)throttle;
+        return false;
+#endif
+    }
+
+    //! Send the file from a read-only memory mapping
+    //@ param socket The connected data socket
+    //@ param fd The local file descriptor
+    //@ param stats Receives the bytes and syscall counts
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    //@ return False if the file cannot be mapped, true otherwise
+    bool FTPTransfer::SendFileMapped(int socket, int fd, TransferStats &stats, FTPThrottle *throttle)
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        struct stat info;
+        if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+        {
+            return false;
+        }
+
+        //* Map in windows so huge files do not exhaust the address space on 32-bit hosts
+        const off_t window = static_cast<off_t>(64) * 1024 * 1024;
+        for (off_t offset = 0; offset < info.st_size; offset += window)
+        {
+            size_t length = static_cast<size_t>(std::min(window, info.st_size - offset));
+            void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, offset);
+            ++stats.syscalls;
+            if (mapping == MAP_FAILED)
+            {
+                if (offset == 0)
+                {
+                    return false;
+                }
+                throw FTPException("Failed to map local file.", -1);
+            }
+            madvise(mapping, length, MADV_SEQUENTIAL);
+
+            try
+            {
+                SendAll(socket, static_cast<const char *>(mapping), length, stats, throttle);
+            }
+            catch (const FTPException &)
+            {
+                munmap(mapping, length);
+                throw;
+            }
+            munmap(mapping, length);
+        }
+
+        return true;
+#else
+        (void)socket;
+        (void)fd;
+        (void)stats;
+        (void)throttle;
+        return false;
+#endif
+    }
+
+    //! Send the file through a user space buffer
+    //@ param socket The connected data socket
+    //@ param file The local file opened for reading
+    //@ param bufferSize The size of the buffer in bytes
+    //@ param stats Receives the bytes and syscall counts
+    //@ param throttle Bandwidth limits to obey, or nullptr for none
+    void FTPTransfer::CopyFromFile(int socket, FILE *file, size_t bufferSize, TransferStats &stats,
+                                   FTPThrottle *throttle)
+    {
+        std::vector<char> buffer(bufferSize > 0 ? bufferSize : kDefaultBufferSize);
+        size_t bytesRead;
+
+        while ((bytesRead = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+        {
+            ++stats.syscalls;
+            SendAll(socket, buffer.data(), bytesRead, stats, throttle);
+        }
+
+        if (ferror(file))
+        {
+            throw FTPException("Failed to read local file.", -1);
+        }
+    }
+
+}
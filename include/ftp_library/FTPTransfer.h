@@ -0,0 +1,104 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTransfer.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 20:35:59 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPTRANSFER_H
+#define FTPTRANSFER_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    struct TransferStats;
+    class FTPThrottle;
+
+    //! Data channel copy loops shared by the transfer commands
+    class FTPTransfer
+    {
+    public:
+        //! Default size of the user space buffer used by the fallback loops
+        static constexpr size_t kDefaultBufferSize = 256 * 1024;
+
+        //! Copy everything from a data socket into a file until the peer closes
+        //! Uses splice(2) through a pipe on Linux and falls back to a large buffer elsewhere
+        //! @param socket The connected data socket
+        //! @param file The local file opened for writing
+        //! @param bufferSize The size of the fallback buffer in bytes
+        //! @param zeroCopy Allow the splice fast path
+        //! @param throttle Bandwidth limits to obey, or nullptr for none
+        //! @return Statistics for the transfer
+        static TransferStats ReceiveToFile(int socket, FILE *file, size_t bufferSize = kDefaultBufferSize,
+                                           bool zeroCopy = true, FTPThrottle *throttle = nullptr);
+
+        //! Send the whole contents of a file over a data socket
+        //! Uses sendfile(2) on Linux, then mmap, then a large buffer as fallbacks
+        //! @param socket The connected data socket
+        //! @param file The local file opened for reading
+        //! @param bufferSize The size of the fallback buffer in bytes
+        //! @param zeroCopy Allow the sendfile and mmap fast paths
+        //! @param throttle Bandwidth limits to obey, or nullptr for none
+        //! @return Statistics for the transfer
+        static TransferStats SendFromFile(int socket, FILE *file, size_t bufferSize = kDefaultBufferSize,
+                                          bool zeroCopy = true, FTPThrottle *throttle = nullptr);
+
+        //! Hand everything from a data socket to a sink until the peer closes
+        //! @param socket The connected data socket
+        //! @param sink Receives each chunk as it arrives
+        //! @param bufferSize The size of the receive buffer in bytes
+        //! @param throttle Bandwidth limits to obey, or nullptr for none
+        //! @param inflate The connection carries MODE Z data; the sink gets it decompressed
+        //! @return Statistics for the transfer; bytes counts what crossed the connection
+        static TransferStats ReceiveToSink(int socket, const std::function<void(const char *, size_t)> &sink,
+                                           size_t bufferSize = kDefaultBufferSize, FTPThrottle *throttle = nullptr,
+                                           bool inflate = false);
+
+        //! Send everything a source produces over a data socket
+        //! @param socket The connected data socket
+        //! @param source Fills the send buffer until it returns 0
+        //! @param bufferSize The size of the send buffer in bytes
+        //! @param throttle Bandwidth limits to obey, or nullptr for none
+        //! @param deflateLevel Compress for MODE Z at this zlib level, 0 to send as is
+        //! @return Statistics for the transfer; bytes counts what crossed the connection
+        static TransferStats SendFromSource(int socket, const std::function<size_t(char *, size_t)> &source,
+                                            size_t bufferSize = kDefaultBufferSize, FTPThrottle *throttle = nullptr,
+                                            int deflateLevel = 0);
+
+        //! Send a buffer, retrying until every byte is written
+        //! @param socket The connected socket
+        //! @param data The bytes to send
+        //! @param size The number of bytes
+        //! @param stats Receives the bytes and syscall counts
+        //! @param throttle Bandwidth limits to obey, or nullptr for none
+        static void SendAll(int socket, const char *data, size_t size, TransferStats &stats,
+                            FTPThrottle *throttle = nullptr);
+
+        //! Format a throughput figure for display (e.g. "112.4 MB/s")
+        //! @param bytesPerSecond The throughput in bytes per second
+        //! @return The formatted string
+        static std::string FormatRate(double bytesPerSecond);
+
+    private:
+        static bool SpliceToFile(int socket, int fd, TransferStats &stats, std::chrono::steady_clock::time_point start,
+                                 FTPThrottle *throttle);
+        static void CopyToFile(int socket, FILE *file, size_t bufferSize, TransferStats &stats,
+                               std::chrono::steady_clock::time_point start, FTPThrottle *throttle);
+        static void CopyToSink(int socket, const std::function<void(const char *, size_t)> &sink, size_t bufferSize,
+                               TransferStats &stats, std::chrono::steady_clock::time_point start, FTPThrottle *throttle);
+        static bool SendFileZeroCopy(int socket, int fd, TransferStats &stats, FTPThrottle *throttle);
+        static bool SendFileMapped(int socket, int fd, TransferStats &stats, FTPThrottle *throttle);
+        static void CopyFromFile(int socket, FILE *file, size_t bufferSize, TransferStats &stats,
+                                 FTPThrottle *throttle);
+    };
+
+}
+
+#endif
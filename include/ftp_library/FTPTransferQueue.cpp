@@ -0,0 +1,266 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTransferQueue.cpp
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 23:04:03 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#include <ftp_library/FTPTransferQueue.h>
+
+namespace ftp_library
+{
+
+    //! Constructor
+    //@ param pool The session pool to run transfers on
+    //@ param workers The number of worker threads (0 = one per pooled session)
+    FTPTransferQueue::FTPTransferQueue(FTPSessionPool &pool, size_t workers)
+        : m_pool(pool), m_workerCount(workers > 0 ? workers : pool.Size())
+    {
+    }
+
+    //! Queue a download
+    //@ param remoteFilePath The path to the file on the server
+    //@ param localFilePath The path to save the file locally
+    //@ param size The file size if already known (0 = query with SIZE)
+    void FTPTransferQueue::AddDownload(const std::string &remoteFilePath, const std::string &localFilePath,
+                                       uint64_t size)
+    {
+        Add({TransferDirection::Download, remoteFilePath, localFilePath, size});
+    }
+
+    //! Queue an upload
+    //@ param localFilePath The path to the file to upload
+    //@ param remoteFilePath The path to save the file on the server
+    void FTPTransferQueue::AddUpload(const std::string &localFilePath, const std::string &remoteFilePath)
+    {
+        Add({TransferDirection::Upload, remoteFilePath, localFilePath, 0});
+    }
+
+    //! Queue a job
+    //@ param job The job to queue
+    void FTPTransferQueue::Add(const TransferJob &job)
+    {
+        m_pending.push_back(job);
+    }
+
+    //! Run every queued job and wait for all of them to finish
+    //@ return Aggregate statistics for the run
+    TransferQueueStats FTPTransferQueue::Run()
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        ResolveSizes();
+
+        //* Largest first so the long transfers start early and do not form the tail
+        std::stable_sort(m_pending.begin(), m_pending.end(), [](const TransferJob &a, const TransferJob &b)
+                         { return a.size > b.size; });
+
+        m_queues.clear();
+        for (size_t i = 0; i < m_workerCount; ++i)
+        {
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < m_pending.size(); ++i)
+        {
+            m_queues[i % m_workerCount]->jobs.push_back(std::move(m_pending[i]));
+        }
+        m_pending.clear();
+        m_results.clear();
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < m_workerCount; ++i)
+        {
+            workers.emplace_back(&FTPTransferQueue::WorkerLoop, this, i);
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        TransferQueueStats stats;
+        for (const auto &result : m_results)
+        {
+            if (result.success)
+            {
+                ++stats.completed;
+                stats.bytes += result.bytes;
+            }
+            else
+            {
+                ++stats.failed;
+            }
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    //! Fill in missing job sizes from the local file system and pipelined SIZE queries
+    void FTPTransferQueue::ResolveSizes()
+    {
+        std::vector<TransferJob *> unknown;
+        for (auto &job : m_pending)
+        {
+            if (job.size > 0)
+            {
+                continue;
+            }
+            if (job.direction == TransferDirection::Upload)
+            {
+                std::error_code error;
+                auto size = std::filesystem::file_size(job.localPath, error);
+                job.size = error ? 0 : size;
+            }
+            else
+            {
+                unknown.push_back(&job);
+            }
+        }
+
+        if (unknown.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            std::vector<MetadataQuery> queries;
+            queries.reserve(unknown.size());
+            for (const auto *job : unknown)
+            {
+                queries.push_back({MetadataCommand::Size, job->remotePath});
+            }
+
+            auto session = m_pool.Acquire();
+            std::vector<MetadataResult> results;
+            try
+            {
+                results = session->QueryMetadata(queries);
+            }
+            catch (...)
+            {
+                //* Replies to the rest of the batch may still be queued on the control connection
+                session.Invalidate();
+                throw;
+            }
+            for (size_t i = 0; i < unknown.size(); ++i)
+            {
+                if (results[i].Ok())
+                {
+                    unknown[i]->size = results[i].size;
+                }
+            }
+        }
+        catch (const std::exception &)
+        {
+            //* Sizes only affect ordering, unknown files just run last
+        }
+    }
+
+    //! Pop the next job from the worker's own deque, or steal one
+    //@ param worker The index of the calling worker
+    //@ param job Receives the next job
+    //@ return False when there is no work left anywhere
+    bool FTPTransferQueue::NextJob(size_t worker, TransferJob &job)
+    {
+        {
+            WorkerQueue &own = *m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty())
+            {
+                job = std::move(own.jobs.front());
+                own.jobs.pop_front();
+                return true;
+            }
+        }
+
+        //* Steal from the back (smallest jobs) of the other workers, starting with the next one
+        for (size_t i = 1; i < m_queues.size(); ++i)
+        {
+            WorkerQueue &victim = *m_queues[(worker + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty())
+            {
+                job = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! Worker thread body: hold one pooled session and drain the queues
+    //@ param worker The index of this worker
+    void FTPTransferQueue::WorkerLoop(size_t worker)
+    {
+        std::unique_ptr<FTPSessionPool::Lease> session;
+        TransferJob job;
+
+        while (NextJob(worker, job))
+        {
+            TransferResult result;
+            auto start = std::chrono::steady_clock::now();
+
+            try
+            {
+                if (!session)
+                {
+                    session = std::make_unique<FTPSessionPool::Lease>(m_pool.Acquire());
+                }
+
+                FTPClient &client = **session;
+                if (job.direction == TransferDirection::Download)
+                {
+                    client.DownloadFile(job.remotePath, job.localPath);
+                }
+                else
+                {
+                    client.UploadFile(job.localPath, job.remotePath);
+                }
+                result.success = true;
+                result.bytes = client.GetLastTransferStats().bytes;
+            }
+            catch (const std::exception &e)
+            {
+                result.error = e.what();
+                if (session)
+                {
+                    //* The control connection may be out of sync, get a fresh session
+                    session->Invalidate();
+                    session.reset();
+                }
+            }
+
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.job = std::move(job);
+
+            if (m_progress)
+            {
+                //* An exception must not leave the worker thread, where it would terminate the process
+                try
+                {
+                    m_progress(result);
+                }
+                catch (const std::exception &e)
+                {
+                    result.success = false;
+                    result.error = std::string("Progress callback failed: ") + e.what();
+                }
+                catch (...)
+                {
+                    result.success = false;
+                    result.error = "Progress callback failed.";
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_resultsMutex);
+            m_results.push_back(std::move(result));
+        }
+    }
+
+}
@@ -0,0 +1,132 @@
+/*
+ * File: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library\FTPTransferQueue.h
+ * Project: c:\Users\tonyw\Desktop\ftp-client-cpp\include\ftp_library
+ * Created Date: Saturday October 17th 2026
+ * Author: Tony Wiedman
+ * -----
+ * Last Modified: Sat October 17th 2026 23:04:03 
+ * Modified By: Tony Wiedman
+ * -----
+ * Copyright (c) 2026 MolexWorks
+ */
+
+#ifndef FTPTRANSFERQUEUE_H
+#define FTPTRANSFERQUEUE_H
+
+#include <ftp_library/Framework.h>
+
+namespace ftp_library
+{
+
+    class FTPSessionPool;
+
+    //! Direction of a queued transfer
+    enum class TransferDirection
+    {
+        Download,
+        Upload
+    };
+
+    //! A single queued download or upload
+    struct TransferJob
+    {
+        TransferDirection direction = TransferDirection::Download; //* Download or upload
+        std::string remotePath;                                    //* Path on the server
+        std::string localPath;                                     //* Local file path
+        uint64_t size = 0;                                         //* File size in bytes (0 = look it up)
+    };
+
+    //! Outcome of a queued transfer
+    struct TransferResult
+    {
+        TransferJob job;     //* The job that ran
+        bool success = false; //* True if the transfer completed
+        std::string error;   //* Error message if the transfer failed
+        uint64_t bytes = 0;  //* Bytes moved over the data connection
+        double seconds = 0.0; //* Duration of the transfer
+    };
+
+    //! Aggregate statistics for a queue run
+    struct TransferQueueStats
+    {
+        size_t completed = 0; //* Jobs that succeeded
+        size_t failed = 0;    //* Jobs that failed
+        size_t skipped = 0;   //* Jobs skipped because they were already up to date
+        uint64_t bytes = 0;   //* Total bytes moved
+        double seconds = 0.0; //* Wall-clock duration of the run
+
+        //! Get the aggregate throughput of the run
+        //! @return The throughput in bytes per second
+        double BytesPerSecond() const
+        {
+            return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+        }
+    };
+
+    //! Batch transfer engine that spreads jobs across pooled sessions
+    //! Jobs are ordered largest first and dealt to per-worker deques; a worker
+    //! that runs dry steals from the back of another worker's deque.
+    class FTPTransferQueue
+    {
+    public:
+        //! Constructor
+        //! @param pool The session pool to run transfers on
+        //! @param workers The number of worker threads (0 = one per pooled session)
+        explicit FTPTransferQueue(FTPSessionPool &pool, size_t workers = 0);
+
+        //! Queue a download
+        //! @param remoteFilePath The path to the file on the server
+        //! @param localFilePath The path to save the file locally
+        //! @param size The file size if already known (0 = query with SIZE)
+        void AddDownload(const std::string &remoteFilePath, const std::string &localFilePath, uint64_t size = 0);
+
+        //! Queue an upload
+        //! @param localFilePath The path to the file to upload
+        //! @param remoteFilePath The path to save the file on the server
+        void AddUpload(const std::string &localFilePath, const std::string &remoteFilePath);
+
+        //! Queue a job
+        //! @param job The job to queue
+        void Add(const TransferJob &job);
+
+        //! Set a callback invoked (from worker threads) after each job finishes
+        //! If the callback throws, the job is recorded as failed with the exception's message.
+        //! @param callback The callback to invoke
+        void SetProgressCallback(std::function<void(const TransferResult &)> callback)
+        {
+            m_progress = std::move(callback);
+        }
+
+        //! Run every queued job and wait for all of them to finish
+        //! @return Aggregate statistics for the run
+        TransferQueueStats Run();
+
+        //! Get the results of the last run, in completion order
+        const std::vector<TransferResult> &Results() const
+        {
+            return m_results;
+        }
+
+    private:
+        struct WorkerQueue
+        {
+            std::deque<TransferJob> jobs; //* Jobs owned by this worker, largest first
+            std::mutex mutex;             //* Guards jobs
+        };
+
+        void ResolveSizes();                                               //* Fill in missing job sizes
+        bool NextJob(size_t worker, TransferJob &job);                     //* Pop own work or steal
+        void WorkerLoop(size_t worker);                                    //* Worker thread body
+
+        FTPSessionPool &m_pool;                                  //* Sessions to run on
+        size_t m_workerCount;                                    //* Number of worker threads
+        std::vector<TransferJob> m_pending;                      //* Jobs queued for the next run
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;      //* Per-worker deques
+        std::vector<TransferResult> m_results;                   //* Results of the last run
+        std::mutex m_resultsMutex;                               //* Guards m_results
+        std::function<void(const TransferResult &)> m_progress; //* Per-job completion callback
+    };
+
+}
+
+#endif
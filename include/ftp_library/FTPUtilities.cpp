@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:45:10 
+ * Last Modified: Sat October 17th 2026 23:14:09 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -30,6 +30,24 @@ namespace ftp_library
         return result;
     }
 
+    //! Trim whitespace without copying
+    // @param input The string to trim
+    // @return A view of the trimmed part of the input
+    std::string_view FTPUtilities::TrimView(std::string_view input)
+    {
+        size_t begin = 0;
+        size_t end = input.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(input[begin])))
+        {
+            ++begin;
+        }
+        while (end > begin && std::isspace(static_cast<unsigned char>(input[end - 1])))
+        {
+            --end;
+        }
+        return input.substr(begin, end - begin);
+    }
+
     //! Convert a string to lowercase
     // @param input The string to convert
     // @return The lowercase version of the input string
@@ -59,6 +77,64 @@ namespace ftp_library
         return input.size() >= suffix.size() && input.compare(input.size() - suffix.size(), suffix.size(), suffix) == 0;
     }
 
+    //! Escape a string for a JSON string literal
+    // @param input The raw string
+    // @return The escaped string, without quotes
+    std::string FTPUtilities::EscapeJson(const std::string &input)
+    {
+        std::string escaped;
+        escaped.reserve(input.size());
+        for (unsigned char c : input)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += static_cast<char>(c);
+            }
+            else if (c == '\n')
+            {
+                escaped += "\\n";
+            }
+            else if (c < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                escaped += buffer;
+            }
+            else
+            {
+                escaped += static_cast<char>(c);
+            }
+        }
+        return escaped;
+    }
+
+    //! Escape a string for a Prometheus label value
+    // @param input The raw string
+    // @return The escaped string, without quotes
+    std::string FTPUtilities::EscapePrometheusLabel(const std::string &input)
+    {
+        std::string escaped;
+        escaped.reserve(input.size());
+        for (char c : input)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (c == '\n')
+            {
+                escaped += "\\n";
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
     //! Convert a string to lowercase
     // @param input The string to convert
     // @return The lowercase version of the input string
@@ -85,6 +161,35 @@ namespace ftp_library
         return {ip, port};
     }
 
+    //! Parse the response from an EPSV command
+    // @param response The response to parse
+    // @return The port number
+    uint16_t FTPUtilities::ParseExtendedPassiveResponse(std::string_view response)
+    {
+        //* "(<d><d><d><port><d>)" where <d> is any printable delimiter, normally '|'
+        size_t start = response.find('(');
+        if (start == std::string_view::npos || start + 5 > response.size())
+        {
+            throw std::invalid_argument("Invalid extended passive mode response format.");
+        }
+        char delimiter = response[start + 1];
+        size_t portStart = start + 4;
+        size_t portEnd = response.find(delimiter, portStart);
+        if (delimiter < 33 || delimiter > 126 || response[start + 2] != delimiter || response[start + 3] != delimiter ||
+            portEnd == std::string_view::npos || portEnd + 1 >= response.size() || response[portEnd + 1] != ')')
+        {
+            throw std::invalid_argument("Invalid extended passive mode response format.");
+        }
+
+        unsigned port = 0;
+        auto [end, error] = std::from_chars(response.data() + portStart, response.data() + portEnd, port);
+        if (error != std::errc() || end != response.data() + portEnd || port == 0 || port > 65535)
+        {
+            throw std::invalid_argument("Invalid extended passive mode port.");
+        }
+        return static_cast<uint16_t>(port);
+    }
+
     //! Convert a string to lowercase
     // @param input The string to convert
     // @return The lowercase version of the input string
@@ -4,7 +4,7 @@
  * Created Date: Thursday January 23rd 2025
  * Author: Tony Wiedman
  * -----
- * Last Modified: Tue April 29th 2025 6:45:10 
+ * Last Modified: Sat October 17th 2026 23:14:09 
  * Modified By: Tony Wiedman
  * -----
  * Copyright (c) 2025 MolexWorks
@@ -32,6 +32,11 @@ namespace ftp_library
         //! @return The trimmed string
         static std::string Trim(const std::string &input);
 
+        //! Trim whitespace without copying
+        //! @param input The string to trim
+        //! @return A view of the trimmed part of the input
+        static std::string_view TrimView(std::string_view input);
+
         //! Convert a string to lowercase
         //! @param input The string to convert
         //! @return The lowercase string
@@ -49,10 +54,26 @@ namespace ftp_library
         //! @return True if the string ends with the suffix, false otherwise
         static bool EndsWith(const std::string &input, const std::string &suffix);
 
+        //! Escape a string for a JSON string literal
+        //! @param input The raw string
+        //! @return The escaped string, without quotes
+        static std::string EscapeJson(const std::string &input);
+
+        //! Escape a string for a Prometheus label value
+        //! The exposition format knows only \\, \" and \n; other bytes stay as they are.
+        //! @param input The raw string
+        //! @return The escaped string, without quotes
+        static std::string EscapePrometheusLabel(const std::string &input);
+
         //! Parse the response from a PASV command
         //! @param response The response to parse
         //! @return A tuple containing the IP address and port number
         static std::tuple<std::string, uint16_t> ParsePassiveModeResponse(const std::string &response);
+
+        //! Parse the response from an EPSV command (RFC 2428), e.g. "229 Entering Extended Passive Mode (|||6446|)"
+        //! @param response The response to parse
+        //! @return The port number; the host is the one the control connection is connected to
+        static uint16_t ParseExtendedPassiveResponse(std::string_view response);
     };
 }
 
@@ -4,6 +4,22 @@
 #include <ftp_library/FTPClient.h>
 #include <ftp_library/FTPResponseParser.h>
 #include <ftp_library/FTPUtilities.h>
+#include <ftp_library/FTPReplyReader.h>
+#include <ftp_library/FTPTransfer.h>
+#include <ftp_library/FTPSessionPool.h>
+#include <ftp_library/FTPTransferQueue.h>
+#include <ftp_library/FTPEventLoop.h>
+#include <ftp_library/FTPAsyncClient.h>
+#include <ftp_library/FTPListingParser.h>
+#include <ftp_library/FTPMirror.h>
+#include <ftp_library/FTPSyncIndex.h>
+#include <ftp_library/FTPListingCache.h>
+#include <ftp_library/FTPMetrics.h>
+#include <ftp_library/FTPTracer.h>
+#include <ftp_library/FTPRateLimiter.h>
+#include <ftp_library/FTPCompression.h>
+#include <ftp_library/FTPResolver.h>
+#include <ftp_library/FTPListenerPool.h>
 
 //
 // Standard library headers
@@ -20,6 +36,28 @@
 #include <locale>
 #include <sstream>
 #include <utility>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <future>
+#include <type_traits>
+#include <optional>
+#include <string_view>
+#include <charconv>
+#include <ctime>
+#include <array>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
 #include <objbase.h>
 #include <ole2.h> 
 
@@ -34,8 +72,21 @@ typedef SSIZE_T ssize_t;
 // #include <windows.h>
 #else
 #include <arpa/inet.h>
+#include <netdb.h>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #endif
@@ -0,0 +1,217 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include "../bench/FTPBenchServer.h"
+
+using namespace ftp_library;
+
+//! Runs an event loop on its own thread for the length of a test
+class LoopThread
+{
+public:
+    LoopThread() : m_thread([this]()
+                            { m_loop.Run(); })
+    {
+    }
+
+    ~LoopThread()
+    {
+        m_loop.Stop();
+        m_thread.join();
+    }
+
+    FTPEventLoop &Loop()
+    {
+        return m_loop;
+    }
+
+private:
+    FTPEventLoop m_loop;
+    std::thread m_thread;
+};
+
+//! Check that a local file holds the served pattern
+static bool MatchesPattern(const std::string &path, uint64_t size)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+    uint64_t offset = 0;
+    bool matches = true;
+    for (int c; (c = fgetc(file)) != EOF; ++offset)
+    {
+        matches = matches && static_cast<unsigned char>(c) == FTPBenchServer::PatternByte(offset);
+    }
+    fclose(file);
+    return matches && offset == size;
+}
+
+//! Test that posted tasks run on the loop and socket readiness reaches the handler
+TEST(FTPEventLoopTest, PostAndWatch)
+{
+    FTPEventLoop loop;
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    FTPEventLoop::SetNonBlocking(fds[0]);
+
+    std::string received;
+    loop.Watch(fds[0], FTPEventLoop::kRead, [&](uint32_t events)
+               {
+                   char buffer[64];
+                   ssize_t n = recv(fds[0], buffer, sizeof(buffer), 0);
+                   if ((events & FTPEventLoop::kRead) && n > 0)
+                   {
+                       received.append(buffer, n);
+                   } });
+    ASSERT_EQ(loop.WatchCount(), 1u);
+
+    bool posted = false;
+    std::thread poster([&loop, &posted]()
+                       { loop.Post([&posted]()
+                                   { posted = true; }); });
+    poster.join();
+    ASSERT_EQ(send(fds[1], "abc", 3, 0), 3);
+
+    for (int i = 0; i < 10 && (!posted || received.size() < 3); ++i)
+    {
+        loop.RunOnce(100);
+    }
+    ASSERT_TRUE(posted);
+    ASSERT_EQ(received, "abc");
+
+    loop.Unwatch(fds[0]);
+    ASSERT_EQ(loop.WatchCount(), 0u);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+//! Test a full session: connect, list, download, upload and a failed transfer that leaves it usable
+TEST(FTPAsyncClientTest, Session)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 20;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 300000);
+    server.Start();
+
+    //* Downloads are saved under their remote name in the given directory
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_async_test";
+    std::filesystem::create_directories(directory);
+    std::string local = (directory / "data.bin").string();
+    {
+        LoopThread thread;
+        FTPAsyncClient client(thread.Loop());
+        client.Connect("127.0.0.1", server.Port()).get();
+        client.Authenticate("user", "pass").get();
+
+        std::vector<std::string> entries = client.ListDirectory("/").get();
+        ASSERT_EQ(entries.size(), 21u);
+        ASSERT_TRUE(std::any_of(entries.begin(), entries.end(), [](const std::string &line)
+                                { return line.size() > 8 && line.compare(line.size() - 8, 8, "data.bin") == 0; }));
+
+        TransferStats downloaded = client.DownloadFile("data.bin", directory.string()).get();
+        ASSERT_EQ(downloaded.bytes, 300000u);
+        ASSERT_TRUE(MatchesPattern(local, 300000));
+
+        TransferStats uploaded = client.UploadFile(local, "copy.bin").get();
+        ASSERT_EQ(uploaded.bytes, 300000u);
+
+        ASSERT_THROW(client.DownloadFile("missing.bin", directory.string()).get(), FTPException);
+        ASSERT_EQ(client.ListDirectory("/").get().size(), 22u);
+
+        //* The 221 arrives right before the server closes; it must complete the disconnect, not fail it
+        client.Disconnect().get();
+    }
+    std::filesystem::remove_all(directory);
+
+    FTPClient check;
+    check.SetVerbose(false);
+    check.Connect("127.0.0.1", server.Port());
+    check.Authenticate("user", "pass");
+    ASSERT_EQ(check.GetFileSize("copy.bin"), 300000u);
+    server.Stop();
+}
+
+//! Test that operations queued on several clients sharing one loop all complete
+TEST(FTPAsyncClientTest, SharedLoop)
+{
+    FTPBenchServer server;
+    server.AddFile("data.bin", 100000);
+    server.Start();
+
+    LoopThread thread;
+    std::vector<std::unique_ptr<FTPAsyncClient>> clients;
+    std::vector<std::future<TransferStats>> downloads;
+    for (int i = 0; i < 4; ++i)
+    {
+        clients.push_back(std::make_unique<FTPAsyncClient>(thread.Loop()));
+        clients.back()->Connect("127.0.0.1", server.Port());
+        clients.back()->Authenticate("user", "pass");
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / ("ftp_async_" + std::to_string(i));
+        std::filesystem::create_directories(directory);
+        downloads.push_back(clients.back()->DownloadFile("data.bin", directory.string()));
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(downloads[i].get().bytes, 100000u);
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / ("ftp_async_" + std::to_string(i));
+        ASSERT_TRUE(MatchesPattern((directory / "data.bin").string(), 100000));
+        std::filesystem::remove_all(directory);
+    }
+
+    //* Clients are destroyed on the loop thread, which owns their sockets
+    std::promise<void> destroyed;
+    thread.Loop().Post([&clients, &destroyed]()
+                       {
+                           clients.clear();
+                           destroyed.set_value(); });
+    destroyed.get_future().get();
+    server.Stop();
+}
+
+//! Test that a slow lookup runs off the loop and that a refused address falls back to the next one
+TEST(FTPAsyncClientTest, ResolveOffLoop)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 3;
+    FTPBenchServer server(options);
+    server.Start();
+
+    //* Nothing listens on [::1] at this port, so the IPv4 address has to take over
+    auto resolver = std::make_shared<FTPResolver>();
+    resolver->SetLookup([](const std::string &, uint16_t port)
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                            FTPResolver::Addresses addresses = FTPResolver::SystemLookup("::1", port);
+                            FTPResolver::Addresses ipv4 = FTPResolver::SystemLookup("127.0.0.1", port);
+                            addresses.insert(addresses.end(), ipv4.begin(), ipv4.end());
+                            return addresses; });
+
+    LoopThread thread;
+    FTPAsyncClient client(thread.Loop());
+    client.SetResolver(resolver);
+    std::future<void> connected = client.Connect("ftp.test", server.Port());
+
+    //* The loop keeps running tasks while the lookup is in flight
+    auto posted = std::chrono::steady_clock::now();
+    std::promise<void> ran;
+    thread.Loop().Post([&ran]()
+                       { ran.set_value(); });
+    ran.get_future().get();
+    ASSERT_LT(std::chrono::steady_clock::now() - posted, std::chrono::milliseconds(200));
+    ASSERT_EQ(connected.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+
+    connected.get();
+    client.Authenticate("user", "pass").get();
+    ASSERT_EQ(client.ListDirectory("/").get().size(), 3u);
+    ASSERT_EQ(resolver->Resolve("ftp.test", server.Port()).front().Family(), AF_INET);
+    client.Disconnect().get();
+
+    //* A failed lookup fails the connect only
+    resolver->SetLookup([](const std::string &, uint16_t) -> FTPResolver::Addresses
+                        { throw FTPException("Failed to resolve server address."); });
+    ASSERT_THROW(client.Connect("missing.test", server.Port()).get(), FTPException);
+    ASSERT_THROW(client.ListDirectory("/").get(), FTPException);
+    server.Stop();
+}
@@ -0,0 +1,503 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include "../bench/FTPBenchServer.h"
+#include <fstream>
+#include <iterator>
+
+using namespace ftp_library;
+
+//! Log a quiet client into the bench server
+static void Login(FTPClient &client, const FTPBenchServer &server)
+{
+    client.SetVerbose(false);
+    client.Connect("127.0.0.1", server.Port());
+    client.Authenticate("user", "pass");
+}
+
+//! Check that received bytes hold the served pattern from an offset on
+static bool MatchesPattern(const std::vector<char> &data, uint64_t offset = 0)
+{
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (static_cast<unsigned char>(data[i]) != FTPBenchServer::PatternByte(offset + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Read a whole local file
+static std::vector<char> ReadLocal(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//! Test pipelined transfers, including servers that mark them with 125
+TEST(FTPClientLoopbackTest, PipelinedTransfers)
+{
+    for (int mark : {150, 125})
+    {
+        FTPBenchServerOptions options;
+        options.listingEntries = 10;
+        options.transferMark = mark;
+        FTPBenchServer server(options);
+        server.AddFile("data.bin", 200000);
+        server.Start();
+
+        FTPClient client;
+        Login(client, server);
+        client.SetTransferPipelining(true);
+
+        //* The first transfer confirms EPSV with a plain exchange; the rest are pipelined
+        ASSERT_EQ(client.ListDirectory("/").size(), 11u);
+        std::vector<char> received;
+        for (int i = 0; i < 2; ++i)
+        {
+            received.clear();
+            client.DownloadFile("data.bin", [&received](const char *data, size_t size)
+                                { received.insert(received.end(), data, data + size); });
+            ASSERT_EQ(received.size(), 200000u);
+            ASSERT_TRUE(MatchesPattern(received));
+        }
+
+        size_t offset = 0;
+        client.UploadFile([&received, &offset](char *buffer, size_t capacity)
+                          {
+                              size_t count = std::min(capacity, received.size() - offset);
+                              std::memcpy(buffer, received.data() + offset, count);
+                              offset += count;
+                              return count; },
+                          "copy.bin");
+        ASSERT_EQ(client.GetFileSize("copy.bin"), 200000u);
+        ASSERT_EQ(client.ListDirectory("/").size(), 12u);
+        server.Stop();
+    }
+}
+
+//! Test that a pipelined resume sends REST in the same write and continues from the checkpoint
+TEST(FTPClientLoopbackTest, PipelinedResume)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 300000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    client.SetTransferPipelining(true);
+    client.ListDirectory("/");
+
+    //* A partial download with its checkpoint, as left behind by a dropped connection
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_loopback_resume";
+    std::filesystem::create_directories(directory);
+    std::string local = (directory / "data.bin").string();
+    {
+        std::ofstream partial(local, std::ios::binary);
+        for (uint64_t i = 0; i < 100000; ++i)
+        {
+            partial.put(static_cast<char>(FTPBenchServer::PatternByte(i)));
+        }
+        std::ofstream checkpoint(local + ".ftpckpt", std::ios::binary);
+        checkpoint << "ftp-checkpoint v1\ndata.bin\n300000\n" << client.GetModificationTime("data.bin") << "\n100000\n";
+    }
+
+    client.DownloadFileResumable("data.bin", local);
+    ASSERT_EQ(client.GetLastTransferStats().bytes, 200000u);
+    std::vector<char> data = ReadLocal(local);
+    ASSERT_EQ(data.size(), 300000u);
+    ASSERT_TRUE(MatchesPattern(data));
+    ASSERT_FALSE(std::filesystem::exists(local + ".ftpckpt"));
+    std::filesystem::remove_all(directory);
+    server.Stop();
+}
+
+//! Test that a refused EPSV skips the replies of the command pipelined behind it
+TEST(FTPClientLoopbackTest, PipelinedEpsvRefused)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    options.passiveLimit = 1;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 100000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    client.SetTransferPipelining(true);
+    client.ListDirectory("/");
+
+    try
+    {
+        client.DownloadFile("data.bin", [](const char *, size_t) {});
+        FAIL() << "Expected the refused EPSV to fail the download";
+    }
+    catch (const FTPException &e)
+    {
+        ASSERT_EQ(e.Code(), 425);
+    }
+
+    //* The RETR reply was drained, so the next reply belongs to the next command
+    client.Noop();
+    ASSERT_EQ(client.GetFileSize("data.bin"), 100000u);
+    server.Stop();
+}
+
+//! Test that a refused REST drops the data connection and leaves the session in step
+TEST(FTPClientLoopbackTest, PipelinedRestRefused)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    options.restSupported = false;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 300000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    client.SetTransferPipelining(true);
+    client.ListDirectory("/");
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_loopback_norest";
+    std::filesystem::create_directories(directory);
+    std::string local = (directory / "data.bin").string();
+    {
+        std::ofstream partial(local, std::ios::binary);
+        partial << std::string(1000, 'x');
+        std::ofstream checkpoint(local + ".ftpckpt", std::ios::binary);
+        checkpoint << "ftp-checkpoint v1\ndata.bin\n300000\n" << client.GetModificationTime("data.bin") << "\n1000\n";
+    }
+
+    try
+    {
+        client.DownloadFileResumable("data.bin", local);
+        FAIL() << "Expected the refused REST to fail the download";
+    }
+    catch (const FTPException &e)
+    {
+        ASSERT_EQ(e.Code(), 502);
+    }
+
+    //* Nothing from the start of the file may have been appended at the offset
+    ASSERT_EQ(std::filesystem::file_size(local), 1000u);
+    client.Noop();
+    ASSERT_EQ(client.GetFileSize("data.bin"), 300000u);
+    std::filesystem::remove_all(directory);
+    server.Stop();
+}
+
+//! Test that a failed metadata query only affects its own result
+TEST(FTPClientLoopbackTest, QueryMetadata)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("a.bin", 1234);
+    server.AddFile("b.bin", 5678);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    std::vector<MetadataQuery> queries = {{MetadataCommand::Size, "a.bin"},
+                                          {MetadataCommand::ModificationTime, "a.bin"},
+                                          {MetadataCommand::Size, "missing.bin"},
+                                          {MetadataCommand::ModificationTime, "missing.bin"},
+                                          {MetadataCommand::Size, "b.bin"}};
+    std::vector<MetadataResult> results = client.QueryMetadata(queries);
+    ASSERT_EQ(results.size(), 5u);
+
+    ASSERT_TRUE(results[0].Ok());
+    ASSERT_EQ(results[0].size, 1234u);
+    ASSERT_TRUE(results[1].Ok());
+    ASSERT_EQ(results[1].mtime, 1767225600);
+    for (size_t i : {2, 3})
+    {
+        ASSERT_FALSE(results[i].Ok());
+        ASSERT_EQ(results[i].code, 550);
+        ASSERT_NE(results[i].message.find("missing.bin"), std::string::npos);
+    }
+    ASSERT_EQ(results[3].mtime, -1);
+    ASSERT_TRUE(results[4].Ok());
+    ASSERT_EQ(results[4].size, 5678u);
+
+    //* A batch larger than the pipeline window still comes back complete and in order
+    std::vector<MetadataQuery> many;
+    for (int i = 0; i < 600; ++i)
+    {
+        many.push_back({MetadataCommand::Size, i % 2 ? "a.bin" : "missing.bin"});
+    }
+    results = client.QueryMetadata(many);
+    ASSERT_EQ(results.size(), 600u);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_EQ(results[i].Ok(), i % 2 == 1);
+    }
+    client.Noop();
+    server.Stop();
+}
+
+//! Test streaming into a sink and from a source without local files
+TEST(FTPClientLoopbackTest, SinkAndSource)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 1000000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    std::vector<char> received;
+    client.DownloadFile("data.bin", [&received](const char *data, size_t size)
+                        { received.insert(received.end(), data, data + size); });
+    ASSERT_EQ(received.size(), 1000000u);
+    ASSERT_TRUE(MatchesPattern(received));
+    ASSERT_EQ(client.GetLastTransferStats().bytes, 1000000u);
+
+    //* Short reads from the source must not end the upload early
+    uint64_t produced = 0;
+    client.UploadFile([&produced](char *buffer, size_t capacity)
+                      {
+                          size_t count = static_cast<size_t>(std::min<uint64_t>({capacity, 777, 500000 - produced}));
+                          for (size_t i = 0; i < count; ++i)
+                          {
+                              buffer[i] = static_cast<char>(FTPBenchServer::PatternByte(produced + i));
+                          }
+                          produced += count;
+                          return count; },
+                      "copy.bin");
+    ASSERT_EQ(client.GetFileSize("copy.bin"), 500000u);
+    server.Stop();
+}
+
+//! Test that a sink or source that throws aborts the transfer and leaves the session usable
+TEST(FTPClientLoopbackTest, SinkAndSourceAbort)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 4000000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    size_t chunks = 0;
+    ASSERT_THROW(client.DownloadFile("data.bin", [&chunks](const char *, size_t)
+                                     {
+                                         if (++chunks == 2)
+                                         {
+                                             throw std::runtime_error("Sink full");
+                                         } }),
+                 std::runtime_error);
+    client.Noop();
+
+    ASSERT_THROW(client.UploadFile([](char *, size_t) -> size_t
+                                   { throw FTPException("Source unavailable", -1); },
+                                   "copy.bin"),
+                 FTPException);
+    client.Noop();
+
+    //* A transport-style failure from the sink is not a dropped connection either
+    ASSERT_THROW(client.DownloadFile("data.bin", [](const char *, size_t)
+                                     { throw FTPException("Sink lost its peer"); }),
+                 FTPException);
+    client.Noop();
+    ASSERT_EQ(client.GetFileSize("data.bin"), 4000000u);
+    server.Stop();
+}
+
+//! Test that every segment of a segmented download uses the client's socket options
+TEST(FTPClientLoopbackTest, SegmentedSocketOptions)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 4 * 1024 * 1024);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    auto tracer = std::make_shared<FTPTracer>();
+    client.SetTracer(tracer);
+    SocketOptions socketOptions;
+    socketOptions.receiveBufferSize = 256 * 1024;
+    client.SetSocketOptions(socketOptions);
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_loopback_segmented";
+    std::filesystem::create_directories(directory);
+    std::string local = (directory / "data.bin").string();
+    client.DownloadFileSegmented("data.bin", local, 4);
+    std::vector<char> data = ReadLocal(local);
+    ASSERT_EQ(data.size(), 4u * 1024 * 1024);
+    ASSERT_TRUE(MatchesPattern(data));
+
+    //* Each segment's data connection records the buffer it asked for
+    std::string json = tracer->ToChromeJson();
+    size_t tuned = 0;
+    for (size_t at = 0; (at = json.find("\"receiveBuffer\":262144", at)) != std::string::npos; ++at)
+    {
+        ++tuned;
+    }
+    ASSERT_EQ(tuned, 4u);
+    ASSERT_EQ(json.find("\"receiveBuffer\":0"), std::string::npos);
+    std::filesystem::remove_all(directory);
+    server.Stop();
+}
+
+//! Test that a local error in a resumable download fails at once instead of being retried
+TEST(FTPClientLoopbackTest, ResumableLocalError)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 1000);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    size_t commands = server.CommandCount();
+    std::string local = (std::filesystem::temp_directory_path() / "ftp_loopback_missing" / "data.bin").string();
+    try
+    {
+        client.DownloadFileResumable("data.bin", local);
+        FAIL() << "Expected the missing local directory to fail the download";
+    }
+    catch (const FTPException &e)
+    {
+        ASSERT_EQ(e.Code(), -1);
+    }
+
+    //* TYPE, SIZE and MDTM only: no reconnect and no second attempt
+    ASSERT_EQ(server.CommandCount() - commands, 3u);
+    client.Noop();
+    server.Stop();
+}
+
+//! Test that a local error in a segmented download is reported as local
+TEST(FTPClientLoopbackTest, SegmentedLocalError)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 4 * 1024 * 1024);
+    server.Start();
+
+    FTPClient client;
+    Login(client, server);
+    std::string local = (std::filesystem::temp_directory_path() / "ftp_loopback_missing" / "data.bin").string();
+    try
+    {
+        client.DownloadFileSegmented("data.bin", local, 4);
+        FAIL() << "Expected the missing local directory to fail the download";
+    }
+    catch (const FTPException &e)
+    {
+        ASSERT_EQ(e.Code(), -1);
+        ASSERT_FALSE(e.IsTransient());
+    }
+    server.Stop();
+}
+
+//! Connect to a port from 127.0.0.2 until it listens, then send a fake file
+static void StealPort(uint16_t port, size_t size)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        int fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.2", &address.sin_addr);
+        bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        address.sin_port = htons(port);
+        if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+        {
+            std::string fake(size, 'X');
+            send(fd, fake.data(), fake.size(), 0);
+            closesocket(fd);
+            return;
+        }
+        closesocket(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+//! Test that active mode refuses data connections from hosts other than the server
+TEST(FTPClientLoopbackTest, ActiveModeRefusesOtherHosts)
+{
+    //* The latency holds the server back after PORT, so the other host connects first
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    options.replyLatency = std::chrono::milliseconds(300);
+    FTPBenchServer server(options);
+    server.AddFile("data.bin", 1000);
+    server.Start();
+
+    uint16_t port;
+    {
+        FTPListenerPool probe;
+        ResolvedAddress local = FTPResolver::SystemLookup("127.0.0.1", 0).front();
+        ResolvedAddress announced;
+        int listener = probe.Acquire(local, announced);
+        port = ntohs(reinterpret_cast<const sockaddr_in &>(announced.address).sin_port);
+        probe.Release(listener, false);
+    }
+    auto listeners = std::make_shared<FTPListenerPool>(port, port, 0);
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_loopback_active";
+    std::filesystem::create_directories(directory);
+    std::string local = (directory / "data.bin").string();
+
+    FTPClient client;
+    Login(client, server);
+    client.SetActiveMode(listeners);
+    std::thread thief(StealPort, port, 1000);
+    client.DownloadFile("data.bin", local);
+    thief.join();
+    std::vector<char> data = ReadLocal(local);
+    ASSERT_EQ(data.size(), 1000u);
+    ASSERT_TRUE(MatchesPattern(data));
+
+    //* With the check off the first connection is taken, whoever made it
+    client.SetActiveMode(listeners, false);
+    thief = std::thread(StealPort, port, 1000);
+    client.DownloadFile("data.bin", local);
+    thief.join();
+    data = ReadLocal(local);
+    ASSERT_EQ(data.size(), 1000u);
+    ASSERT_FALSE(MatchesPattern(data));
+
+    std::filesystem::remove_all(directory);
+    server.Stop();
+}
+
+//! Test that a stale listing is refreshed by one caller while the others get the stale copy
+TEST(FTPClientLoopbackTest, StaleListingRefreshClaim)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 3;
+    FTPBenchServer server(options);
+    server.Start();
+
+    auto cache = std::make_shared<FTPListingCache>(std::chrono::seconds(0), std::chrono::seconds(300));
+    FTPClient client;
+    Login(client, server);
+    client.SetListingCache(cache);
+    ASSERT_EQ(client.ListDirectory("/").size(), 3u);
+    std::string key = "127.0.0.1:" + std::to_string(server.Port());
+
+    //* Another caller holds the refresh: no commands, the stale copy comes back
+    ASSERT_TRUE(cache->BeginRefresh(key, "/"));
+    size_t commands = server.CommandCount();
+    ASSERT_EQ(client.ListDirectory("/").size(), 3u);
+    ASSERT_EQ(server.CommandCount(), commands);
+
+    //* Once the claim is given up, the next caller refreshes it
+    cache->CancelRefresh(key, "/");
+    ASSERT_EQ(client.ListDirectory("/").size(), 3u);
+    ASSERT_GT(server.CommandCount(), commands);
+    server.Stop();
+}
@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Test for the exponential retry backoff
+TEST(FTPClientOptionsTest, RetryPolicyBackoff)
+{
+    RetryPolicy policy;
+    policy.initialDelay = std::chrono::milliseconds(100);
+    policy.maxDelay = std::chrono::milliseconds(1000);
+    policy.multiplier = 2.0;
+
+    ASSERT_EQ(policy.DelayAfter(1).count(), 100);
+    ASSERT_EQ(policy.DelayAfter(2).count(), 200);
+    ASSERT_EQ(policy.DelayAfter(4).count(), 800);
+    ASSERT_EQ(policy.DelayAfter(5).count(), 1000);
+    ASSERT_EQ(policy.DelayAfter(50).count(), 1000);
+}
+
+//! Test for classifying errors worth retrying
+TEST(FTPClientOptionsTest, TransientErrors)
+{
+    ASSERT_TRUE(FTPException("Connection closed by server.").IsTransient());
+    ASSERT_TRUE(FTPException("Unexpected response code: 421", 421).IsTransient());
+    ASSERT_FALSE(FTPException("Unexpected response code: 550", 550).IsTransient());
+    ASSERT_FALSE(FTPException("Failed to open local file", -1).IsTransient());
+}
+
+//! Test for sizing data buffers from the bandwidth-delay product
+TEST(FTPClientOptionsTest, SocketBufferSizing)
+{
+    SocketOptions options;
+    ASSERT_TRUE(options.controlNoDelay);
+    ASSERT_TRUE(options.keepAlive);
+    ASSERT_EQ(options.BufferSizeFor(0.0, 1e6), 0);
+    ASSERT_EQ(options.BufferSizeFor(0.05, 0.0), 0);
+
+    //* 50 ms at 10 MB/s is a 500 KB window, doubled for headroom
+    ASSERT_EQ(options.BufferSizeFor(0.05, 10e6), 1000000);
+    ASSERT_EQ(options.BufferSizeFor(0.0001, 1e6), options.minAutoBufferSize);
+    ASSERT_EQ(options.BufferSizeFor(0.3, 1e9), options.maxAutoBufferSize);
+
+    SocketOptions other = options;
+    ASSERT_TRUE(other == options);
+    other.keepAliveIdle = std::chrono::seconds(30);
+    ASSERT_TRUE(other != options);
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Build compressible test data
+static std::string MakePayload(size_t size)
+{
+    std::string payload(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+    {
+        payload[i] = static_cast<char>("-rw-r--r-- 1 ftp ftp entry.dat\r\n"[i % 33] + (i / 4096) % 3);
+    }
+    return payload;
+}
+
+//! Compress data in chunks of a given size
+static std::string Deflate(const std::string &input, size_t chunk, int level = 6)
+{
+    std::string output;
+    FTPDeflater deflater(level);
+    auto append = [&output](const char *data, size_t size)
+    { output.append(data, size); };
+    for (size_t offset = 0; offset < input.size(); offset += chunk)
+    {
+        deflater.Write(input.data() + offset, std::min(chunk, input.size() - offset), append);
+    }
+    deflater.Finish(append);
+    return output;
+}
+
+//! Decompress data fed in chunks of a given size
+static std::string Inflate(const std::string &input, size_t chunk)
+{
+    std::string output;
+    FTPInflater inflater;
+    for (size_t offset = 0; offset < input.size(); offset += chunk)
+    {
+        inflater.Write(input.data() + offset, std::min(chunk, input.size() - offset),
+                       [&output](const char *data, size_t size)
+                       { output.append(data, size); });
+    }
+    return output;
+}
+
+//! Test that data survives a round trip whatever the chunking
+TEST(FTPCompressionTest, RoundTrip)
+{
+    if (!FTPDeflater::Available())
+    {
+        GTEST_SKIP() << "built without zlib";
+    }
+
+    std::string payload = MakePayload(1000000);
+    std::string compressed = Deflate(payload, 65536);
+    ASSERT_LT(compressed.size(), payload.size() / 8);
+
+    ASSERT_EQ(Inflate(compressed, compressed.size()), payload);
+    ASSERT_EQ(Inflate(compressed, 1), payload);
+    ASSERT_EQ(Inflate(compressed, 1447), payload);
+    ASSERT_EQ(Inflate(Deflate(payload, 7, 1), 4096), payload);
+    ASSERT_EQ(Inflate(Deflate(std::string(), 1), 16), "");
+}
+
+//! Test that a restarted stream continues the same output
+TEST(FTPCompressionTest, ConcatenatedStreams)
+{
+    if (!FTPDeflater::Available())
+    {
+        GTEST_SKIP() << "built without zlib";
+    }
+
+    std::string first = MakePayload(5000);
+    std::string second = MakePayload(70000);
+    std::string compressed = Deflate(first, 4096) + Deflate(second, 4096);
+    ASSERT_EQ(Inflate(compressed, 3), first + second);
+}
+
+//! Test that data which is not a deflate stream is rejected
+TEST(FTPCompressionTest, CorruptData)
+{
+    if (!FTPDeflater::Available())
+    {
+        GTEST_SKIP() << "built without zlib";
+    }
+
+    ASSERT_THROW(Inflate(MakePayload(1000), 100), FTPException);
+}
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include <ftp_library/FTPCoroutine.h>
+
+#if defined(__cpp_impl_coroutine)
+
+static ftp_library::FTPTask<int> Add(int a, int b)
+{
+    co_return a + b;
+}
+
+static ftp_library::FTPTask<int> Sum(int count)
+{
+    int total = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        total += co_await Add(i, 1);
+    }
+    co_return total;
+}
+
+static ftp_library::FTPTask<> Throws()
+{
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+//! Test for chaining tasks and reporting completion through Spawn
+TEST(FTPCoroutineTest, ChainsTasks)
+{
+    int result = 0;
+    bool finished = false;
+    auto run = [&]() -> ftp_library::FTPTask<>
+    {
+        result = co_await Sum(10000);
+    };
+
+    ftp_library::Spawn(run(), [&](std::exception_ptr error)
+                       {
+                           ASSERT_FALSE(error);
+                           finished = true; });
+    ASSERT_TRUE(finished);
+    ASSERT_EQ(result, 50005000);
+}
+
+//! Test that exceptions propagate to the awaiting coroutine
+TEST(FTPCoroutineTest, PropagatesExceptions)
+{
+    std::exception_ptr reported;
+    ftp_library::Spawn(Throws(), [&](std::exception_ptr error)
+                       { reported = error; });
+    ASSERT_TRUE(reported);
+    ASSERT_THROW(std::rethrow_exception(reported), std::runtime_error);
+}
+
+//! Test for resuming a coroutine from an operation callback
+TEST(FTPCoroutineTest, ResumesFromCallback)
+{
+    ftp_library::FTPOperationAwaiter<int>::Callback pending;
+    int value = 0;
+    auto run = [&]() -> ftp_library::FTPTask<>
+    {
+        value = co_await ftp_library::FTPOperationAwaiter<int>([&](auto done)
+                                                              { pending = std::move(done); });
+    };
+
+    ftp_library::Spawn(run());
+    ASSERT_TRUE(pending);
+    ASSERT_EQ(value, 0);
+    pending(nullptr, 42);
+    ASSERT_EQ(value, 42);
+}
+
+#endif
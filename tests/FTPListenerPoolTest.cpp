@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Build an address from a numeric IP
+static ResolvedAddress MakeAddress(const std::string &ip)
+{
+    return FTPResolver::SystemLookup(ip, 0).front();
+}
+
+//! Find a free loopback port
+static uint16_t FreePort()
+{
+    int fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length);
+    closesocket(fd);
+    return ntohs(address.sin_port);
+}
+
+//! Test that listeners bind inside the range and fail cleanly once it is used up
+TEST(FTPListenerPoolTest, BindsInRange)
+{
+    uint16_t first = FreePort();
+    FTPListenerPool pool(first, first);
+    ResolvedAddress announced;
+    int listener = pool.Acquire(MakeAddress("127.0.0.1"), announced);
+    ASSERT_GE(listener, 0);
+    ASSERT_EQ(announced.ToString(), "127.0.0.1:" + std::to_string(first));
+
+    ResolvedAddress other;
+    ASSERT_THROW(pool.Acquire(MakeAddress("127.0.0.1"), other), FTPException);
+    pool.Release(listener);
+}
+
+//! Test that a released listener is handed out again and accepts connections
+TEST(FTPListenerPoolTest, ReusesReleasedListener)
+{
+    FTPListenerPool pool;
+    ResolvedAddress first;
+    int listener = pool.Acquire(MakeAddress("127.0.0.1"), first);
+    pool.Release(listener);
+    ASSERT_EQ(pool.IdleCount(), 1u);
+
+    //* A connection left behind must be dropped, not handed to the next transfer
+    int stale = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    ASSERT_EQ(connect(stale, reinterpret_cast<const sockaddr *>(&first.address), first.length), 0);
+
+    ResolvedAddress second;
+    ASSERT_EQ(pool.Acquire(MakeAddress("127.0.0.1"), second), listener);
+    ASSERT_EQ(second.ToString(), first.ToString());
+    ASSERT_EQ(pool.IdleCount(), 0u);
+    ASSERT_LT(accept(listener, nullptr, nullptr), 0);
+
+    pool.Release(listener, false);
+    ASSERT_EQ(pool.IdleCount(), 0u);
+    closesocket(stale);
+}
+
+//! Test that the advertised address replaces the local IPv4 address in what is announced
+TEST(FTPListenerPoolTest, AdvertisedAddress)
+{
+    FTPListenerPool pool;
+    ASSERT_THROW(pool.SetAdvertisedAddress("ftp.example.com"), std::invalid_argument);
+    pool.SetAdvertisedAddress("203.0.113.7");
+
+    ResolvedAddress announced;
+    int listener = pool.Acquire(MakeAddress("127.0.0.1"), announced);
+    ASSERT_EQ(announced.ToString().rfind("203.0.113.7:", 0), 0u);
+    pool.Release(listener);
+}
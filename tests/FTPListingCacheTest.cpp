@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using ftp_library::FTPListingCache;
+
+//! Test for a listing served fresh within the TTL
+TEST(FTPListingCacheTest, FreshWithinTtl)
+{
+    FTPListingCache cache(std::chrono::seconds(60), std::chrono::seconds(60));
+    std::vector<std::string> entries;
+
+    ASSERT_EQ(cache.Lookup("ftp.example.com:21", "/pub", entries), FTPListingCache::State::Miss);
+    cache.Store("ftp.example.com:21", "/pub", {"a.txt", "b.txt"});
+    ASSERT_EQ(cache.Lookup("ftp.example.com:21", "/pub/", entries), FTPListingCache::State::Fresh);
+    ASSERT_EQ(entries.size(), 2u);
+    ASSERT_EQ(cache.Lookup("ftp.example.com:2121", "/pub", entries), FTPListingCache::State::Miss);
+}
+
+//! Test for stale-while-revalidate after the TTL
+TEST(FTPListingCacheTest, StaleAfterTtl)
+{
+    FTPListingCache cache(std::chrono::seconds(0), std::chrono::seconds(60));
+    std::vector<std::string> entries;
+
+    cache.Store("host:21", "/pub", {"a.txt"});
+    ASSERT_EQ(cache.Lookup("host:21", "/pub", entries), FTPListingCache::State::Stale);
+    ASSERT_EQ(entries[0], "a.txt");
+    ASSERT_TRUE(cache.BeginRefresh("host:21", "/pub"));
+    ASSERT_FALSE(cache.BeginRefresh("host:21", "/pub"));
+    cache.CancelRefresh("host:21", "/pub");
+    ASSERT_TRUE(cache.BeginRefresh("host:21", "/pub"));
+
+    FTPListingCache expired(std::chrono::seconds(0), std::chrono::seconds(0));
+    expired.Store("host:21", "/pub", {"a.txt"});
+    ASSERT_EQ(expired.Lookup("host:21", "/pub", entries), FTPListingCache::State::Miss);
+}
+
+//! Test that an upload invalidates only its own directory
+TEST(FTPListingCacheTest, InvalidateParent)
+{
+    FTPListingCache cache;
+    std::vector<std::string> entries;
+
+    cache.Store("host:21", "/", {"pub"});
+    cache.Store("host:21", "/pub", {"a.txt"});
+    cache.InvalidateParent("host:21", "/pub/new.txt");
+    ASSERT_EQ(cache.Lookup("host:21", "/pub", entries), FTPListingCache::State::Miss);
+    ASSERT_EQ(cache.Lookup("host:21", "/", entries), FTPListingCache::State::Fresh);
+    cache.InvalidateParent("host:21", "/pub");
+    ASSERT_EQ(cache.Size(), 0u);
+}
+
+//! Test for resolving relative and dotted paths
+TEST(FTPListingCacheTest, ResolvePath)
+{
+    ASSERT_EQ(FTPListingCache::ResolvePath("/pub", "docs"), "/pub/docs");
+    ASSERT_EQ(FTPListingCache::ResolvePath("/pub", "/a//b/./c/"), "/a/b/c");
+    ASSERT_EQ(FTPListingCache::ResolvePath("/pub/docs", "../../.."), "/");
+    ASSERT_EQ(FTPListingCache::ParentDirectory("/pub/a.txt"), "/pub");
+    ASSERT_EQ(FTPListingCache::ParentDirectory("/a.txt"), "/");
+}
+
+//! Test for saving and loading the cache
+TEST(FTPListingCacheTest, SaveAndLoad)
+{
+    std::string path = "ftp_listing_cache_test.cache";
+    FTPListingCache cache;
+    cache.Store("host:21", "/pub", {"-rw-r--r-- 1 ftp ftp 12 Jan 01 00:00 a b.txt", ""});
+    cache.Save(path);
+
+    FTPListingCache loaded;
+    loaded.Load(path);
+    std::vector<std::string> entries;
+    ASSERT_EQ(loaded.Lookup("host:21", "/pub", entries), FTPListingCache::State::Fresh);
+    ASSERT_EQ(entries.size(), 2u);
+    ASSERT_EQ(entries[0], "-rw-r--r-- 1 ftp ftp 12 Jan 01 00:00 a b.txt");
+
+    std::remove(path.c_str());
+}
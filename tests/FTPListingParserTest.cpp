@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using ftp_library::DirEntry;
+using ftp_library::EntryType;
+using ftp_library::FTPListingParser;
+
+//! 2026-10-17 12:00:00 UTC
+static constexpr int64_t kNow = 1792238400;
+
+//! Test for parsing a Unix LIST line with a time stamp
+TEST(FTPListingParserTest, UnixFileWithTime)
+{
+    DirEntry entry;
+    ASSERT_TRUE(FTPListingParser::ParseLine("-rw-r--r--   1 user group  3000000 Oct 16 09:30 big file.bin\r",
+                                            entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_EQ(entry.name, "big file.bin");
+    ASSERT_EQ(entry.size, 3000000u);
+    ASSERT_EQ(entry.type, EntryType::File);
+    ASSERT_EQ(entry.perms, 0644);
+    ASSERT_EQ(entry.mtime, kNow - 86400 + (9 * 3600 + 30 * 60) - 12 * 3600);
+}
+
+//! Test for LIST dates in the future belonging to the previous year
+TEST(FTPListingParserTest, UnixDateRollsBackAYear)
+{
+    DirEntry entry;
+    ASSERT_TRUE(FTPListingParser::ParseLine("drwxr-xr-x 2 user group 4096 Dec 31 23:00 logs",
+                                            entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_EQ(entry.type, EntryType::Directory);
+    ASSERT_EQ(entry.mtime, 1767222000); //* 2025-12-31 23:00:00 UTC
+}
+
+//! Test for LIST lines with a year, a symlink and a missing group column
+TEST(FTPListingParserTest, UnixVariants)
+{
+    DirEntry entry;
+    ASSERT_TRUE(FTPListingParser::ParseLine("-rw-r--r-- 1 user group 10 Jan  1  2020 old.txt",
+                                            entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_EQ(entry.mtime, 1577836800);
+
+    ASSERT_TRUE(FTPListingParser::ParseLine("lrwxrwxrwx 1 user group 7 Jan 01 2020 latest -> v1.2.3",
+                                            entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_EQ(entry.type, EntryType::Link);
+    ASSERT_EQ(entry.name, "latest");
+
+    ASSERT_TRUE(FTPListingParser::ParseLine("-rw-r--r-- 1 ftp 42 Mar 05 2021 nogroup.txt",
+                                            entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_EQ(entry.size, 42u);
+    ASSERT_EQ(entry.name, "nogroup.txt");
+
+    ASSERT_FALSE(FTPListingParser::ParseLine("total 12", entry, FTPListingParser::Format::Unix, kNow));
+    ASSERT_FALSE(FTPListingParser::ParseLine("drwxr-xr-x 2 user group 4096 Jan 01 2020 ..",
+                                             entry, FTPListingParser::Format::Unix, kNow));
+}
+
+//! Test for parsing MLSD facts
+TEST(FTPListingParserTest, MlsdFacts)
+{
+    DirEntry entry;
+    ASSERT_TRUE(FTPListingParser::ParseLine("Type=file;Size=1024;Modify=20200101000000.123;UNIX.mode=0640; a b.txt",
+                                            entry, FTPListingParser::Format::Auto, kNow));
+    ASSERT_EQ(entry.name, "a b.txt");
+    ASSERT_EQ(entry.size, 1024u);
+    ASSERT_EQ(entry.type, EntryType::File);
+    ASSERT_EQ(entry.mtime, 1577836800);
+    ASSERT_EQ(entry.perms, 0640);
+
+    ASSERT_FALSE(FTPListingParser::ParseLine("type=cdir;modify=20200101000000; /pub",
+                                             entry, FTPListingParser::Format::MLSD, kNow));
+    ASSERT_FALSE(FTPListingParser::ParseLine("type=dir; ..", entry, FTPListingParser::Format::MLSD, kNow));
+    ASSERT_FALSE(FTPListingParser::ParseLine("type=dir; .", entry, FTPListingParser::Format::MLSD, kNow));
+}
+
+//! Test for lines split across chunks and a final unterminated line
+TEST(FTPListingParserTest, StreamsChunks)
+{
+    std::string listing;
+    for (int i = 0; i < 1000; ++i)
+    {
+        listing += "type=file;size=" + std::to_string(i) + "; file" + std::to_string(i) + "\r\n";
+    }
+    listing += "type=dir; last";
+
+    FTPListingParser parser(FTPListingParser::Format::MLSD);
+    for (size_t offset = 0; offset < listing.size(); offset += 7)
+    {
+        parser.Feed(listing.data() + offset, std::min<size_t>(7, listing.size() - offset));
+    }
+    parser.Finish();
+
+    const auto &entries = parser.Entries();
+    ASSERT_EQ(entries.size(), 1001u);
+    ASSERT_EQ(entries[0].name, "file0");
+    ASSERT_EQ(entries[999].name, "file999");
+    ASSERT_EQ(entries[999].size, 999u);
+    ASSERT_EQ(entries[1000].name, "last");
+    ASSERT_EQ(entries[1000].type, EntryType::Directory);
+}
+
+//! Test for streaming entries to a callback without storing them
+TEST(FTPListingParserTest, EntryCallback)
+{
+    FTPListingParser parser;
+    uint64_t total = 0;
+    parser.SetEntryCallback([&](const DirEntry &entry)
+                            { total += entry.size; });
+
+    std::string listing = "-rw-r--r-- 1 u g 5 Jan 01 2020 a\n-rw-r--r-- 1 u g 7 Jan 01 2020 b\n";
+    parser.Feed(listing.data(), listing.size());
+    ASSERT_EQ(total, 12u);
+    ASSERT_TRUE(parser.Entries().empty());
+}
+
+//! Test for parsing MDTM/MLSD time values
+TEST(FTPListingParserTest, ParseTimestamp)
+{
+    ASSERT_EQ(FTPListingParser::ParseTimestamp("20200101000000"), 1577836800);
+    ASSERT_EQ(FTPListingParser::ParseTimestamp("20261017120000.5"), kNow);
+    ASSERT_EQ(FTPListingParser::ParseTimestamp("2020"), -1);
+    ASSERT_EQ(FTPListingParser::ParseTimestamp("2020010100000x"), -1);
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Test for bucketing values into a histogram
+TEST(FTPMetricsTest, HistogramBuckets)
+{
+    FTPHistogram histogram({0.1, 1.0, 10.0});
+
+    histogram.Observe(0.05);
+    histogram.Observe(0.1);
+    histogram.Observe(5.0);
+    histogram.Observe(100.0);
+
+    ASSERT_EQ(histogram.Counts(), (std::vector<uint64_t>{2, 0, 1, 1}));
+    ASSERT_EQ(histogram.Count(), 4u);
+    ASSERT_DOUBLE_EQ(histogram.Sum(), 105.15);
+}
+
+//! Test for the JSON lines record format
+TEST(FTPMetricsTest, JsonLineFormat)
+{
+    OperationMetrics metrics;
+    metrics.operation = MetricsOperation::Download;
+    metrics.host = "ftp.example.com:21";
+    metrics.path = "/pub/\"quoted\".bin";
+    metrics.success = true;
+    metrics.seconds = 2.0;
+    metrics.setupSeconds = 0.25;
+    metrics.transferSeconds = 1.0;
+    metrics.bytes = 1000;
+
+    std::string json = FTPJsonLinesMetricsSink::Format(metrics);
+    ASSERT_NE(json.find("\"operation\":\"download\""), std::string::npos);
+    ASSERT_NE(json.find("\"path\":\"/pub/\\\"quoted\\\".bin\""), std::string::npos);
+    ASSERT_NE(json.find("\"setup_seconds\":0.25"), std::string::npos);
+    ASSERT_EQ(json.find("first_byte_seconds"), std::string::npos);
+    ASSERT_NE(json.find("\"bytes_per_second\":1000"), std::string::npos);
+    ASSERT_EQ(json.find('\n'), std::string::npos);
+}
+
+//! Test for the Prometheus exposition of recorded operations
+TEST(FTPMetricsTest, PrometheusRender)
+{
+    FTPPrometheusMetricsSink sink;
+    OperationMetrics metrics;
+    metrics.operation = MetricsOperation::Upload;
+    metrics.success = true;
+    metrics.seconds = 0.2;
+    metrics.bytes = 4096;
+    sink.Record(metrics);
+    metrics.success = false;
+    sink.Record(metrics);
+
+    std::string text = sink.Render();
+    ASSERT_NE(text.find("# TYPE ftp_operation_duration_seconds histogram"), std::string::npos);
+    ASSERT_NE(text.find("ftp_operation_duration_seconds_bucket{operation=\"upload\",le=\"0.25\"} 2"), std::string::npos);
+    ASSERT_NE(text.find("ftp_operation_duration_seconds_count{operation=\"upload\"} 2"), std::string::npos);
+    ASSERT_NE(text.find("ftp_operations_total{operation=\"upload\",result=\"failure\"} 1"), std::string::npos);
+    ASSERT_NE(text.find("ftp_transferred_bytes_total{operation=\"upload\"} 8192"), std::string::npos);
+}
+
+//! Test that the callback sink forwards every record
+TEST(FTPMetricsTest, CallbackSink)
+{
+    std::vector<MetricsOperation> seen;
+    FTPCallbackMetricsSink sink([&seen](const OperationMetrics &metrics)
+                                { seen.push_back(metrics.operation); });
+
+    OperationMetrics metrics;
+    metrics.operation = MetricsOperation::List;
+    sink.Record(metrics);
+
+    ASSERT_EQ(seen.size(), 1u);
+    ASSERT_EQ(seen[0], MetricsOperation::List);
+}
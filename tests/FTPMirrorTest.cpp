@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include "../bench/FTPBenchServer.h"
+#include <fstream>
+
+using namespace ftp_library;
+
+//! Test that an upload mirror skips local links instead of following them
+TEST(FTPMirrorTest, UploadSkipsLinks)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.Start();
+
+    std::filesystem::path base = std::filesystem::temp_directory_path() / "ftp_mirror_links";
+    std::filesystem::remove_all(base);
+    std::filesystem::path root = base / "root";
+    std::filesystem::create_directories(root / "sub");
+    std::ofstream(root / "a.txt") << "first";
+    std::ofstream(root / "sub" / "b.txt") << "second";
+    std::ofstream(base / "secret.txt") << "outside the mirror";
+
+    //* A cycle back to the root, and a file outside it
+    std::filesystem::create_directory_symlink(root, root / "sub" / "loop");
+    std::filesystem::create_symlink(base / "secret.txt", root / "secret.txt");
+
+    FTPSessionPool pool("127.0.0.1", server.Port(), "user", "pass", 2);
+    FTPMirror mirror(pool);
+    TransferQueueStats stats = mirror.MirrorToRemote(root.string(), "/upload");
+    ASSERT_EQ(stats.completed, 2u);
+    ASSERT_EQ(stats.failed, 0u);
+    for (const auto &result : mirror.Results())
+    {
+        ASSERT_EQ(result.job.localPath.find("loop"), std::string::npos);
+        ASSERT_EQ(result.job.localPath.find("secret"), std::string::npos);
+    }
+
+    std::filesystem::remove_all(base);
+    server.Stop();
+}
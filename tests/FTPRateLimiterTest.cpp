@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Seconds from now until a reservation is due
+static double SecondsUntil(FTPRateLimiter::Clock::time_point due)
+{
+    return std::chrono::duration<double>(due - FTPRateLimiter::Clock::now()).count();
+}
+
+//! Test that an unlimited limiter never delays
+TEST(FTPRateLimiterTest, Unlimited)
+{
+    FTPRateLimiter limiter;
+    ASSERT_EQ(limiter.Rate(), 0u);
+    ASSERT_EQ(limiter.Quantum(), 0u);
+    ASSERT_LE(SecondsUntil(limiter.Reserve(1ull << 40)), 0.0);
+}
+
+//! Test for reservations queuing up at the configured rate
+TEST(FTPRateLimiterTest, ReservationsFollowRate)
+{
+    FTPRateLimiter limiter(1000000, 100000);
+
+    //* The burst passes at once, the rest is spread at 1 MB/s
+    ASSERT_LE(SecondsUntil(limiter.Reserve(100000)), 0.0);
+    FTPRateLimiter::Clock::time_point due;
+    for (int i = 0; i < 10; ++i)
+    {
+        due = limiter.Reserve(100000);
+    }
+    ASSERT_NEAR(SecondsUntil(due), 1.0, 0.05);
+}
+
+//! Test that changing the rate rescales reservations already made
+TEST(FTPRateLimiterTest, RuntimeRateChange)
+{
+    FTPRateLimiter limiter(1000000, 1);
+    limiter.Reserve(2000000);
+    limiter.SetRate(4000000);
+    ASSERT_EQ(limiter.Rate(), 4000000u);
+    ASSERT_NEAR(SecondsUntil(limiter.Reserve(1)), 0.5, 0.05);
+
+    limiter.SetRate(0);
+    ASSERT_LE(SecondsUntil(limiter.Reserve(1ull << 30)), 0.0);
+}
+
+//! Test that the quantum is about 20 ms of the rate within its bounds
+TEST(FTPRateLimiterTest, Quantum)
+{
+    ASSERT_EQ(FTPRateLimiter(1000000).Quantum(), 20000u);
+    ASSERT_EQ(FTPRateLimiter(1000).Quantum(), 4096u);
+    ASSERT_EQ(FTPRateLimiter(1ull << 40).Quantum(), 256u * 1024u);
+}
+
+//! Test that a throttle takes the strictest limiter for chunk sizes and delays
+TEST(FTPRateLimiterTest, ThrottleChain)
+{
+    FTPThrottle empty;
+    ASSERT_TRUE(empty.Empty());
+
+    auto fast = std::make_shared<FTPRateLimiter>(10000000);
+    auto slow = std::make_shared<FTPRateLimiter>(1000000);
+    FTPThrottle throttle;
+    throttle.Add(fast);
+    throttle.Add(nullptr);
+    throttle.Add(slow);
+    ASSERT_FALSE(throttle.Empty());
+    ASSERT_EQ(throttle.ChunkLimit(1 << 20), 20000u);
+    ASSERT_EQ(throttle.ChunkLimit(100), 100u);
+
+    auto start = FTPRateLimiter::Clock::now();
+    for (int i = 0; i < 10; ++i)
+    {
+        throttle.Consume(20000);
+    }
+    double elapsed = std::chrono::duration<double>(FTPRateLimiter::Clock::now() - start).count();
+    ASSERT_GE(elapsed, 0.17);
+    ASSERT_LT(elapsed, 0.5);
+}
+
+//! Test that host limiters are shared by name
+TEST(FTPRateLimiterTest, BandwidthLimits)
+{
+    FTPBandwidthLimits limits;
+    limits.SetHostRate("FTP.Example.com ", 5000);
+    ASSERT_EQ(limits.HostLimiter("ftp.example.com")->Rate(), 5000u);
+    ASSERT_EQ(limits.HostLimiter("other.example.com")->Rate(), 0u);
+    ASSERT_EQ(limits.HostLimiter("ftp.example.com"), limits.HostLimiter("FTP.EXAMPLE.COM"));
+
+    limits.SetGlobalRate(7000);
+    ASSERT_EQ(limits.GlobalLimiter()->Rate(), 7000u);
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+//! Test for framing a single-line reply
+TEST(FTPReplyReaderTest, SingleLineReply)
+{
+    ftp_library::FTPReplyReader reader;
+    std::string reply;
+
+    reader.Feed("220 Ready\r\n", 11);
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "220 Ready");
+    ASSERT_FALSE(reader.TryPopReply(reply));
+}
+
+//! Test for framing a multi-line banner
+TEST(FTPReplyReaderTest, MultiLineReply)
+{
+    ftp_library::FTPReplyReader reader;
+    std::string reply;
+    std::string input = "220-Welcome\r\n220-Second line\r\n 220 not the end\r\n220 Ready\r\n";
+
+    reader.Feed(input.data(), input.size());
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "220-Welcome\r\n220-Second line\r\n 220 not the end\r\n220 Ready");
+    ASSERT_EQ(reader.Buffered(), 0u);
+}
+
+//! Test for a reply split across several segments
+TEST(FTPReplyReaderTest, SplitSegments)
+{
+    ftp_library::FTPReplyReader reader;
+    std::string reply;
+
+    reader.Feed("230-Hel", 7);
+    ASSERT_FALSE(reader.TryPopReply(reply));
+    reader.Feed("lo\r\n23", 6);
+    ASSERT_FALSE(reader.TryPopReply(reply));
+    reader.Feed("0 Logged in\r\n", 13);
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "230-Hello\r\n230 Logged in");
+}
+
+//! Test for two replies coalesced into one segment
+TEST(FTPReplyReaderTest, CoalescedReplies)
+{
+    ftp_library::FTPReplyReader reader;
+    std::string reply;
+    std::string input = "150 Opening data connection\r\n226 Transfer complete\r\n";
+
+    reader.Feed(input.data(), input.size());
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "150 Opening data connection");
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "226 Transfer complete");
+    ASSERT_FALSE(reader.TryPopReply(reply));
+}
+
+//! Test that buffered bytes survive growth of a small buffer
+TEST(FTPReplyReaderTest, GrowsBuffer)
+{
+    ftp_library::FTPReplyReader reader(8);
+    std::string reply;
+    std::string input = "200 First\r\n200 A much longer second reply\r\n";
+
+    reader.Feed(input.data(), input.size());
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "200 First");
+    ASSERT_TRUE(reader.TryPopReply(reply));
+    ASSERT_EQ(reply, "200 A much longer second reply");
+}
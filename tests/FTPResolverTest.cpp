@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Build an address from a numeric IP
+static ResolvedAddress MakeAddress(const std::string &ip, uint16_t port)
+{
+    return FTPResolver::SystemLookup(ip, port).front();
+}
+
+//! Open a listening socket on an ephemeral loopback port
+static int Listen(uint16_t &port)
+{
+    int fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    listen(fd, 4);
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length);
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+//! Test that lookups are cached for the TTL and dropped on Invalidate
+TEST(FTPResolverTest, CachesLookups)
+{
+    FTPResolver resolver(std::chrono::seconds(60));
+    std::atomic<int> lookups{0};
+    resolver.SetLookup([&lookups](const std::string &, uint16_t port)
+                       {
+                           ++lookups;
+                           return FTPResolver::Addresses{MakeAddress("127.0.0.1", port)};
+                       });
+
+    ASSERT_EQ(resolver.Resolve("ftp.example.com", 21).front().ToString(), "127.0.0.1:21");
+    ASSERT_EQ(resolver.Resolve("FTP.Example.com", 21).size(), 1u);
+    ASSERT_EQ(lookups, 1);
+    resolver.Resolve("ftp.example.com", 2121);
+    ASSERT_EQ(lookups, 2);
+
+    resolver.Invalidate("ftp.example.com", 21);
+    resolver.Resolve("ftp.example.com", 21);
+    ASSERT_EQ(lookups, 3);
+}
+
+//! Test that an expired lookup is served at once while a slow refresh runs
+TEST(FTPResolverTest, ServesStaleWhileRefreshing)
+{
+    FTPResolver resolver(std::chrono::seconds(0), std::chrono::seconds(60));
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> lookups{0};
+    resolver.SetLookup([&lookups, gate](const std::string &, uint16_t port)
+                       {
+                           if (++lookups > 1)
+                           {
+                               gate.wait();
+                           }
+                           return FTPResolver::Addresses{MakeAddress("127.0.0.1", port)};
+                       });
+
+    resolver.Resolve("ftp.example.com", 21);
+    ASSERT_EQ(resolver.Resolve("ftp.example.com", 21).size(), 1u);
+    ASSERT_EQ(resolver.Resolve("ftp.example.com", 21).size(), 1u);
+    release.set_value();
+    resolver.Clear();
+    ASSERT_EQ(lookups, 2);
+}
+
+//! Test that concurrent misses share one lookup and failures are not cached
+TEST(FTPResolverTest, CoalescesMisses)
+{
+    FTPResolver resolver;
+    std::atomic<int> lookups{0};
+    std::atomic<bool> fail{true};
+    resolver.SetLookup([&lookups, &fail](const std::string &, uint16_t port)
+                       {
+                           ++lookups;
+                           std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                           if (fail)
+                           {
+                               throw FTPException("Failed to resolve server address.");
+                           }
+                           return FTPResolver::Addresses{MakeAddress("127.0.0.1", port)};
+                       });
+
+    ASSERT_THROW(resolver.Resolve("ftp.example.com", 21), FTPException);
+    fail = false;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&resolver]()
+                             { resolver.Resolve("ftp.example.com", 21); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(lookups, 2);
+}
+
+//! Test that addresses alternate between families
+TEST(FTPResolverTest, Interleave)
+{
+    FTPResolver::Addresses addresses = {MakeAddress("::1", 1), MakeAddress("::2", 2), MakeAddress("::3", 3),
+                                        MakeAddress("10.0.0.1", 4), MakeAddress("10.0.0.2", 5)};
+    FTPResolver::Addresses ordered = FTPResolver::Interleave(addresses);
+    ASSERT_EQ(ordered.size(), 5u);
+    ASSERT_EQ(ordered[0].ToString(), "[::1]:1");
+    ASSERT_EQ(ordered[1].ToString(), "10.0.0.1:4");
+    ASSERT_EQ(ordered[2].ToString(), "[::2]:2");
+    ASSERT_EQ(ordered[3].ToString(), "10.0.0.2:5");
+    ASSERT_EQ(ordered[4].ToString(), "[::3]:3");
+}
+
+//! Test that a refused address falls through to the next one without waiting out the attempt delay
+TEST(FTPResolverTest, ConnectFirstSkipsDeadAddresses)
+{
+    uint16_t deadPort = 0;
+    closesocket(Listen(deadPort));
+    uint16_t port = 0;
+    int listener = Listen(port);
+
+    FTPResolver::Addresses addresses = {MakeAddress("127.0.0.1", deadPort), MakeAddress("127.0.0.1", port)};
+    int prepared = 0;
+    size_t winner = 99;
+    auto start = std::chrono::steady_clock::now();
+    int fd = FTPResolver::ConnectFirst(addresses, std::chrono::seconds(5), std::chrono::seconds(10),
+                                       [&prepared](int)
+                                       { ++prepared; },
+                                       &winner);
+    ASSERT_GE(fd, 0);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    ASSERT_EQ(winner, 1u);
+    ASSERT_EQ(prepared, 2);
+    closesocket(fd);
+
+    ASSERT_EQ(FTPResolver::ConnectFirst({addresses[0]}, std::chrono::milliseconds(10), std::chrono::seconds(10),
+                                        nullptr),
+              -1);
+    closesocket(listener);
+}
@@ -42,3 +42,33 @@ TEST(FTPResponseParserTest, IsExpectedCode)
     expectedCode = 200;
     ASSERT_FALSE(ftp_library::FTPResponseParser::IsExpectedCode(response, expectedCode));
 }
+
+//! Test for parsing reply codes without allocating
+TEST(FTPResponseParserTest, ParseCode)
+{
+    ASSERT_EQ(ftp_library::FTPResponseParser::ParseCode("213 1024"), 213);
+    ASSERT_EQ(ftp_library::FTPResponseParser::ParseCode("550"), 550);
+    ASSERT_EQ(ftp_library::FTPResponseParser::ParseCode("21"), -1);
+    ASSERT_EQ(ftp_library::FTPResponseParser::ParseCode("2x3 Oops"), -1);
+    ASSERT_EQ(ftp_library::FTPResponseParser::ParseCode("Invalid response"), -1);
+}
+
+//! Test for the compile-time set of expected reply codes
+TEST(FTPResponseParserTest, ReplyCodeSet)
+{
+    static constexpr ftp_library::ReplyCodeSet codes{125, 150, 226};
+    static_assert(codes.Contains(150) && !codes.Contains(200), "ReplyCodeSet must be usable at compile time");
+
+    ASSERT_TRUE(codes.Contains(125));
+    ASSERT_TRUE(codes.Contains(226));
+    ASSERT_FALSE(codes.Contains(-1));
+    ASSERT_FALSE(codes.Contains(999));
+}
+
+//! Test for viewing the reply text in place
+TEST(FTPResponseParserTest, MessageView)
+{
+    std::string response = "213  20240102030405 ";
+    ASSERT_EQ(ftp_library::FTPResponseParser::MessageView(response), "20240102030405");
+    ASSERT_TRUE(ftp_library::FTPResponseParser::MessageView("200").empty());
+}
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using ftp_library::FTPSyncIndex;
+using ftp_library::RemoteFileInfo;
+
+//! Test for change detection against recorded metadata
+TEST(FTPSyncIndexTest, DetectsChanges)
+{
+    FTPSyncIndex index;
+    ASSERT_TRUE(index.IsChanged("/a.bin", {10, 1000, {}}));
+
+    index.Update("/a.bin", {10, 1000, "abc"});
+    ASSERT_FALSE(index.IsChanged("/a.bin", {10, 1000, {}}));
+    ASSERT_FALSE(index.IsChanged("/a.bin", {10, 1000, "abc"}));
+    ASSERT_TRUE(index.IsChanged("/a.bin", {11, 1000, {}}));
+    ASSERT_TRUE(index.IsChanged("/a.bin", {10, 1001, {}}));
+    ASSERT_TRUE(index.IsChanged("/a.bin", {10, 1000, "def"}));
+
+    index.Erase("/a.bin");
+    ASSERT_TRUE(index.IsChanged("/a.bin", {10, 1000, {}}));
+}
+
+//! Test for saving and loading an index file
+TEST(FTPSyncIndexTest, SaveAndLoad)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "ftp_sync_index_test.idx").string();
+
+    FTPSyncIndex index;
+    index.Update("/data/one.bin", {123, 1577836800, {}});
+    index.Update("/data/name with\ttab.bin", {0, -1, "crc32:deadbeef"});
+    index.Save(path);
+
+    FTPSyncIndex loaded;
+    loaded.Load(path);
+    ASSERT_EQ(loaded.Size(), 2u);
+
+    RemoteFileInfo info;
+    ASSERT_TRUE(loaded.Find("/data/one.bin", info));
+    ASSERT_EQ(info.size, 123u);
+    ASSERT_EQ(info.mtime, 1577836800);
+    ASSERT_TRUE(loaded.Find("/data/name with\ttab.bin", info));
+    ASSERT_EQ(info.hash, "crc32:deadbeef");
+    ASSERT_EQ(info.mtime, -1);
+
+    std::filesystem::remove(path);
+}
+
+//! Test that a missing index file loads as empty
+TEST(FTPSyncIndexTest, MissingFile)
+{
+    FTPSyncIndex index;
+    index.Update("/x", {1, 1, {}});
+    index.Load((std::filesystem::temp_directory_path() / "ftp_sync_index_missing.idx").string());
+    ASSERT_EQ(index.Size(), 0u);
+}
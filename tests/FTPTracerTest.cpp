@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+
+using namespace ftp_library;
+
+//! Test that a span without a tracer records nothing
+TEST(FTPTracerTest, DisabledSpan)
+{
+    FTPTraceSpan span(nullptr, "control", "send");
+    ASSERT_FALSE(span.Active());
+    span.Arg("command", "NOOP");
+    span.End();
+}
+
+//! Test for recording spans with names and arguments
+TEST(FTPTracerTest, RecordsSpans)
+{
+    FTPTracer tracer;
+    {
+        FTPTraceSpan outer(&tracer, "operation", "download");
+        FTPTraceSpan inner(&tracer, "control", "send");
+        inner.SetName("RETR");
+        inner.Arg("command", "RETR \"a\".bin");
+        inner.Arg("bytes", 42);
+        inner.End();
+        inner.End();
+    }
+    ASSERT_EQ(tracer.Size(), 2u);
+
+    std::string json = tracer.ToChromeJson();
+    ASSERT_NE(json.find("\"traceEvents\":["), std::string::npos);
+    ASSERT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"RETR\""), std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"command\":\"RETR \\\"a\\\".bin\",\"bytes\":42}"), std::string::npos);
+    ASSERT_NE(json.find("\"cat\":\"operation\",\"name\":\"download\""), std::string::npos);
+}
+
+//! Test that spans over capacity are dropped and counted
+TEST(FTPTracerTest, Capacity)
+{
+    FTPTracer tracer(2);
+    auto now = FTPTracer::Clock::now();
+    for (int i = 0; i < 5; ++i)
+    {
+        tracer.AddSpan("control", "NOOP", now, now);
+    }
+    ASSERT_EQ(tracer.Size(), 2u);
+    ASSERT_EQ(tracer.Dropped(), 3u);
+    ASSERT_NE(tracer.ToChromeJson().find("\"dropped_events\":3"), std::string::npos);
+
+    tracer.Clear();
+    ASSERT_EQ(tracer.Size(), 0u);
+}
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include "../bench/FTPBenchServer.h"
+
+using namespace ftp_library;
+
+//! Test that a throwing progress callback fails its job instead of ending the process
+TEST(FTPTransferQueueTest, ThrowingProgressCallback)
+{
+    FTPBenchServerOptions options;
+    options.listingEntries = 0;
+    FTPBenchServer server(options);
+    server.AddFile("a.bin", 1000);
+    server.AddFile("b.bin", 2000);
+    server.AddFile("c.bin", 3000);
+    server.Start();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ftp_queue_callback";
+    std::filesystem::create_directories(directory);
+
+    FTPSessionPool pool("127.0.0.1", server.Port(), "user", "pass", 2);
+    FTPTransferQueue queue(pool);
+    for (const char *name : {"a.bin", "b.bin", "c.bin"})
+    {
+        queue.AddDownload(name, (directory / name).string());
+    }
+    queue.SetProgressCallback([](const TransferResult &result)
+                              {
+        if (result.job.remotePath == "b.bin")
+        {
+            throw std::runtime_error("display closed");
+        } });
+
+    TransferQueueStats stats = queue.Run();
+    ASSERT_EQ(stats.completed, 2u);
+    ASSERT_EQ(stats.failed, 1u);
+    for (const auto &result : queue.Results())
+    {
+        if (result.job.remotePath == "b.bin")
+        {
+            ASSERT_FALSE(result.success);
+            ASSERT_NE(result.error.find("display closed"), std::string::npos);
+        }
+        else
+        {
+            ASSERT_TRUE(result.success);
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    server.Stop();
+}
@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+#include <ftp_library/Framework.h>
+#include <thread>
+
+//! Test for formatting throughput figures
+TEST(FTPTransferTest, FormatRate)
+{
+    ASSERT_EQ(ftp_library::FTPTransfer::FormatRate(512.0), "512.0 B/s");
+    ASSERT_EQ(ftp_library::FTPTransfer::FormatRate(1536.0), "1.5 KB/s");
+    ASSERT_EQ(ftp_library::FTPTransfer::FormatRate(10.0 * 1024 * 1024), "10.0 MB/s");
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+//! Test for receiving a stream into a file with and without the fast path
+TEST(FTPTransferTest, ReceiveToFile)
+{
+    for (bool zeroCopy : {true, false})
+    {
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+        std::string payload(300000, 'x');
+        for (size_t i = 0; i < payload.size(); ++i)
+        {
+            payload[i] = static_cast<char>('a' + i % 26);
+        }
+
+        std::thread writer([&]()
+                           {
+                               send(fds[1], payload.data(), payload.size(), 0);
+                               close(fds[1]); });
+
+        FILE *file = tmpfile();
+        ASSERT_NE(file, nullptr);
+        auto stats = ftp_library::FTPTransfer::ReceiveToFile(fds[0], file, 4096, zeroCopy);
+        writer.join();
+        close(fds[0]);
+
+        ASSERT_EQ(stats.bytes, payload.size());
+
+        std::string contents(payload.size(), '\0');
+        rewind(file);
+        ASSERT_EQ(fread(&contents[0], 1, contents.size(), file), contents.size());
+        fclose(file);
+        ASSERT_EQ(contents, payload);
+    }
+}
+
+//! Test for sending a file over a socket with and without the fast paths
+TEST(FTPTransferTest, SendFromFile)
+{
+    for (bool zeroCopy : {true, false})
+    {
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+        std::string payload(300000, '\0');
+        for (size_t i = 0; i < payload.size(); ++i)
+        {
+            payload[i] = static_cast<char>(i % 251);
+        }
+
+        FILE *file = tmpfile();
+        ASSERT_NE(file, nullptr);
+        ASSERT_EQ(fwrite(payload.data(), 1, payload.size(), file), payload.size());
+        fflush(file);
+        rewind(file);
+
+        std::string received;
+        std::thread reader([&]()
+                           {
+                               char buffer[4096];
+                               ssize_t n;
+                               while ((n = recv(fds[1], buffer, sizeof(buffer), 0)) > 0)
+                               {
+                                   received.append(buffer, n);
+                               } });
+
+        auto stats = ftp_library::FTPTransfer::SendFromFile(fds[0], file, 4096, zeroCopy);
+        close(fds[0]);
+        reader.join();
+        close(fds[1]);
+        fclose(file);
+
+        ASSERT_EQ(stats.bytes, payload.size());
+        ASSERT_EQ(received, payload);
+    }
+}
+
+//! Test that a peer that went away fails the send instead of killing the process with SIGPIPE
+TEST(FTPTransferTest, SendToClosedPeer)
+{
+    for (bool zeroCopy : {true, false})
+    {
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        close(fds[1]);
+
+        FILE *file = tmpfile();
+        ASSERT_NE(file, nullptr);
+        std::string payload(300000, 'x');
+        ASSERT_EQ(fwrite(payload.data(), 1, payload.size(), file), payload.size());
+        fflush(file);
+        rewind(file);
+
+        ASSERT_THROW(ftp_library::FTPTransfer::SendFromFile(fds[0], file, 4096, zeroCopy),
+                     ftp_library::FTPException);
+        close(fds[0]);
+        fclose(file);
+
+        sigset_t mask;
+        pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+        ASSERT_EQ(sigismember(&mask, SIGPIPE), 0);
+    }
+}
+//! Test for streaming a socket into a sink without a file
+TEST(FTPTransferTest, ReceiveToSink)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    std::string payload(300000, '\0');
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>(i % 253);
+    }
+
+    std::thread writer([&]()
+                       {
+                           send(fds[1], payload.data(), payload.size(), 0);
+                           close(fds[1]); });
+
+    std::string received;
+    size_t chunks = 0;
+    auto stats = ftp_library::FTPTransfer::ReceiveToSink(
+        fds[0],
+        [&](const char *data, size_t size)
+        {
+            ASSERT_LE(size, 4096u);
+            received.append(data, size);
+            ++chunks;
+        },
+        4096);
+    writer.join();
+    close(fds[0]);
+
+    ASSERT_EQ(stats.bytes, payload.size());
+    ASSERT_GE(chunks, payload.size() / 4096);
+    ASSERT_EQ(received, payload);
+}
+
+//! Test for sending what a pull-based source produces
+TEST(FTPTransferTest, SendFromSource)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    std::string payload(300000, '\0');
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>(i % 241);
+    }
+
+    std::string received;
+    std::thread reader([&]()
+                       {
+                           char buffer[4096];
+                           ssize_t n;
+                           while ((n = recv(fds[1], buffer, sizeof(buffer), 0)) > 0)
+                           {
+                               received.append(buffer, n);
+                           } });
+
+    //* Produce odd-sized pieces so the source never fills the buffer exactly
+    size_t offset = 0;
+    auto stats = ftp_library::FTPTransfer::SendFromSource(
+        fds[0],
+        [&](char *buffer, size_t capacity)
+        {
+            size_t count = std::min({capacity, payload.size() - offset, static_cast<size_t>(3001)});
+            memcpy(buffer, payload.data() + offset, count);
+            offset += count;
+            return count;
+        },
+        4096);
+    close(fds[0]);
+    reader.join();
+    close(fds[1]);
+
+    ASSERT_EQ(stats.bytes, payload.size());
+    ASSERT_EQ(received, payload);
+}
+#endif
@@ -9,6 +9,16 @@ TEST(FTPUtilitiesTest, Trim)
     ASSERT_EQ(ftp_library::FTPUtilities::Trim(input), expected);
 }
 
+//! Test for trimming whitespace without copying
+TEST(FTPUtilitiesTest, TrimView)
+{
+    std::string input = "\t Hello, world!\r\n";
+    std::string_view trimmed = ftp_library::FTPUtilities::TrimView(input);
+    ASSERT_EQ(trimmed, "Hello, world!");
+    ASSERT_EQ(trimmed.data(), input.data() + 2);
+    ASSERT_TRUE(ftp_library::FTPUtilities::TrimView("   ").empty());
+}
+
 //! Test for converting a string to lowercase
 TEST(FTPUtilitiesTest, ToLowerCase)
 {
@@ -55,6 +65,18 @@ TEST(FTPUtilitiesTest, ParsePassiveModeResponse)
     }
 }
 
+//! Test for parsing extended passive mode responses
+TEST(FTPUtilitiesTest, ParseExtendedPassiveResponse)
+{
+    ASSERT_EQ(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 Entering Extended Passive Mode (|||6446|)"),
+              6446);
+    ASSERT_EQ(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 EPSV ok (!!!65535!)"), 65535);
+    ASSERT_THROW(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 (|||0|)"), std::invalid_argument);
+    ASSERT_THROW(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 (|||70000|)"), std::invalid_argument);
+    ASSERT_THROW(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 (||6446|)"), std::invalid_argument);
+    ASSERT_THROW(ftp_library::FTPUtilities::ParseExtendedPassiveResponse("229 no port"), std::invalid_argument);
+}
+
 //! Test for splitString function
 TEST(FTPUtilitiesTest, SplitString)
 {
@@ -66,3 +88,19 @@ TEST(FTPUtilitiesTest, SplitString)
     ASSERT_EQ(result[1], "two");
     ASSERT_EQ(result[2], "three");
 }
+
+//! Test for escaping JSON string content
+TEST(FTPUtilitiesTest, EscapeJson)
+{
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapeJson("plain"), "plain");
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapeJson("a\"b\\c"), "a\\\"b\\\\c");
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapeJson("line\nnext\t"), "line\\nnext\\u0009");
+}
+
+//! Test for escaping Prometheus label values, e.g. a path with a tab and a newline
+TEST(FTPUtilitiesTest, EscapePrometheusLabel)
+{
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapePrometheusLabel("/pub/file.bin"), "/pub/file.bin");
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapePrometheusLabel("/a\"b\\c"), "/a\\\"b\\\\c");
+    ASSERT_EQ(ftp_library::FTPUtilities::EscapePrometheusLabel("/in\tbox/line\nnext"), "/in\tbox/line\\nnext");
+}